@@ -14,18 +14,18 @@
 
 namespace pbrlib::backend
 {
-    Canvas::Canvas(vk::Device& device, const pbrlib::Window* ptr_window) :
+    Canvas::Canvas(vk::Device& device, const pbrlib::Window* ptr_window, const pbrlib::settings::Present& settings) :
         _device(device)
     {
         if (!ptr_window) [[unlikely]]
             throw exception::InvalidArgument("[canvas] ptr_window is null");
 
-        _surface.vk_surface.emplace(_device, *ptr_window);
+        _surface.vk_surface.emplace(_device, *ptr_window, settings);
 
-        on([this, ptr_window] ([[maybe_unused]] const events::ResizeWindow& event)
+        on([this, ptr_window, settings] ([[maybe_unused]] const events::ResizeWindow& event)
         {
             vkDeviceWaitIdle(_device.device());
-            _surface.vk_surface.emplace(_device, *ptr_window);
+            _surface.vk_surface.emplace(_device, *ptr_window, settings);
         });
     }
 
@@ -68,11 +68,11 @@ namespace pbrlib::backend
         });
     }
 
-    bool Canvas::nextImage(VkSemaphore wait_semaphore)
+    bool Canvas::nextImage(VkSemaphore wait_semaphore, bool wait_on_host)
     {
         if (_surface.vk_surface) [[likely]]
         {
-            if (const auto next_image = _surface.vk_surface->nextImage(wait_semaphore)) [[likely]]
+            if (const auto next_image = _surface.vk_surface->nextImage(wait_semaphore, wait_on_host)) [[likely]]
             {
                 _surface.index      = next_image->index;
                 _surface.ptr_image  = next_image->ptr_image;
@@ -91,10 +91,16 @@ namespace pbrlib::backend
         if (!nextImage(wait_semaphore)) [[unlikely]]
             return ;
 
-        _surface.ptr_image->changeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
         auto command_buffer = _device.oneTimeSubmitCommandBuffer("present");
 
+        /// Both transitions go to the blit command buffer, the setup commands aren't flushed before presenting.
+        _surface.ptr_image->changeLayout (
+            command_buffer,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_2_NONE,
+            VK_PIPELINE_STAGE_2_BLIT_BIT
+        );
+
         command_buffer.write([this, ptr_result] (VkCommandBuffer command_buffer_handle)
         {
             PBRLIB_PROFILING_VK_ZONE_SCOPED(_device, command_buffer_handle, "present-result-upload");
@@ -135,19 +141,74 @@ namespace pbrlib::backend
             );
         }, "present-result-upload", vk::marker_colors::write_data_in_image);
 
+        _surface.ptr_image->changeLayout (
+            command_buffer,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            VK_PIPELINE_STAGE_2_BLIT_BIT,
+            VK_PIPELINE_STAGE_2_NONE
+        );
+
         _device.submit(command_buffer);
 
-        _surface.ptr_image->changeLayout(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        queuePresent(VK_NULL_HANDLE);
+    }
+
+    std::span<vk::Image> Canvas::storageTargets() noexcept
+    {
+        if (!_surface.vk_surface || !_surface.vk_surface->storageUsage())
+            return { };
+
+        return _surface.vk_surface->_images;
+    }
+
+    std::optional<uint32_t> Canvas::acquire(VkSemaphore available_semaphore)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!nextImage(available_semaphore, false)) [[unlikely]]
+            return std::nullopt;
 
+        return _surface.index;
+    }
+
+    void Canvas::present(uint32_t image_index, VkSemaphore render_finished_semaphore)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        _surface.index = image_index;
+
+        queuePresent(render_finished_semaphore);
+    }
+
+    void Canvas::waitForPresent()
+    {
+        if (_surface.vk_surface) [[likely]]
+            _surface.vk_surface->waitForPresent();
+    }
+
+    void Canvas::queuePresent(VkSemaphore wait_semaphore)
+    {
         VkResult result = VK_SUCCESS;
 
-        const VkPresentInfoKHR present_info
+        const uint64_t present_id = _surface.vk_surface->nextPresentId();
+
+        const VkPresentIdKHR present_id_info
         {
-            .sType          = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
             .swapchainCount = 1,
-            .pSwapchains    = &_surface.vk_surface->_swapchain_handle.handle(),
-            .pImageIndices  = &_surface.index,
-            .pResults       = &result
+            .pPresentIds    = &present_id
+        };
+
+        const VkPresentInfoKHR present_info
+        {
+            .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .pNext              = present_id > 0 ? &present_id_info : nullptr,
+            .waitSemaphoreCount = wait_semaphore != VK_NULL_HANDLE ? 1u : 0u,
+            .pWaitSemaphores    = &wait_semaphore,
+            .swapchainCount     = 1,
+            .pSwapchains        = &_surface.vk_surface->_swapchain_handle.handle(),
+            .pImageIndices      = &_surface.index,
+            .pResults           = &result
         };
 
         const auto present_result = vkQueuePresentKHR(_device.queue().handle, &present_info);
@@ -173,6 +234,6 @@ namespace pbrlib::backend
 
     uint8_t Canvas::framesInFlight() const noexcept
     {
-        return _surface.vk_surface ? vk::Surface::framesInFlight() : 1;
+        return _surface.vk_surface ? _surface.vk_surface->framesInFlight() : 1;
     }
 }
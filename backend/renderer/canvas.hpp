@@ -3,14 +3,11 @@
 #include <backend/renderer/vulkan/image.hpp>
 #include <backend/renderer/vulkan/surface.hpp>
 
+#include <pbrlib/config.hpp>
 #include <pbrlib/event_system.hpp>
 
 #include <optional>
-
-namespace pbrlib
-{
-    struct Config;
-}
+#include <span>
 
 namespace pbrlib::backend
 {
@@ -23,10 +20,12 @@ namespace pbrlib::backend
     class Canvas final :
         public pbrlib::EventSystem
     {
-        [[nodiscard]] bool nextImage(VkSemaphore wait_semaphore);
+        [[nodiscard]] bool nextImage(VkSemaphore wait_semaphore, bool wait_on_host = true);
+
+        void queuePresent(VkSemaphore wait_semaphore);
 
     public:
-        explicit Canvas(vk::Device& device, const pbrlib::Window* ptr_window);
+        explicit Canvas(vk::Device& device, const pbrlib::Window* ptr_window, const pbrlib::settings::Present& settings = { });
         explicit Canvas(vk::Device& device, uint32_t width, uint32_t height);
 
         Canvas(Canvas&& canvas)         = delete;
@@ -37,6 +36,20 @@ namespace pbrlib::backend
 
         void present(const vk::Image* ptr_result, VkSemaphore wait_semaphore);
 
+        /// Swapchain images into which a compute pass can write the result directly.
+        /// Empty without a surface or if the surface format doesn't support storage usage.
+        [[nodiscard]] std::span<vk::Image> storageTargets() noexcept;
+
+        /// Acquires the next swapchain image without waiting on host.
+        /// The image may be used only after available_semaphore is signaled.
+        [[nodiscard]] std::optional<uint32_t> acquire(VkSemaphore available_semaphore);
+
+        /// Presents the acquired image after render_finished_semaphore is signaled.
+        void present(uint32_t image_index, VkSemaphore render_finished_semaphore);
+
+        /// CPU frame pacing, see pbrlib::settings::Present::wait_for_present.
+        void waitForPresent();
+
         [[nodiscard]] Size      size()              const;
         [[nodiscard]] uint8_t   framesInFlight()    const noexcept;
 
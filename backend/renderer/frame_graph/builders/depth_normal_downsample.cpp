@@ -0,0 +1,124 @@
+#include <backend/renderer/frame_graph/builders/depth_normal_downsample.hpp>
+#include <backend/renderer/frame_graph/depth_normal_downsample.hpp>
+
+#include <backend/renderer/vulkan/image.hpp>
+
+#include <pbrlib/exceptions.hpp>
+
+namespace pbrlib::backend::builders
+{
+    DepthNormalDownsample::DepthNormalDownsample(vk::Device& device) noexcept :
+        _device (device)
+    { }
+
+    DepthNormalDownsample& DepthNormalDownsample::uvImage(vk::Image& image) noexcept
+    {
+        _ptr_uv_image = &image;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::normalTangentImage(vk::Image& image) noexcept
+    {
+        _ptr_nor_tan_image = &image;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::materialIndexImage(vk::Image& image) noexcept
+    {
+        _ptr_mat_index_image = &image;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::depthImage(vk::Image& image) noexcept
+    {
+        _ptr_depth_image = &image;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::lowResDepthImage(vk::Image& image) noexcept
+    {
+        _ptr_low_res_depth_image = &image;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::lowResNormalTangentImage(vk::Image& image) noexcept
+    {
+        _ptr_low_res_nor_tan_image = &image;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::resolutionDivisor(uint32_t divisor) noexcept
+    {
+        _resolution_divisor = divisor;
+        return *this;
+    }
+
+    DepthNormalDownsample& DepthNormalDownsample::gbufferDescriptorSet (
+        VkDescriptorSet         set_handle,
+        VkDescriptorSetLayout   set_layout_handle
+    ) noexcept
+    {
+        _gbuffer_set_handle         = set_handle;
+        _gbuffer_set_layout_handle  = set_layout_handle;
+        return *this;
+    }
+
+    void DepthNormalDownsample::validate()
+    {
+        if (!_ptr_uv_image) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] image for uvs didn't set");
+
+        if (!_ptr_nor_tan_image) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] image for normals and tangents didn't set");
+
+        if (!_ptr_mat_index_image) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] image for materials indices didn't set");
+
+        if (!_ptr_depth_image) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] image for depth didn't set");
+
+        if (!_ptr_low_res_depth_image) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] image for low resolution depth didn't set");
+
+        if (!_ptr_low_res_nor_tan_image) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] image for low resolution normals and tangents didn't set");
+
+        if (_resolution_divisor < 2) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] resolution divisor must be greater than one");
+
+        if (_gbuffer_set_handle == VK_NULL_HANDLE || _gbuffer_set_layout_handle == VK_NULL_HANDLE) [[unlikely]]
+            throw exception::InvalidState("[depth-normal-downsample::builder] didn't set gbuffer descriptor set");
+    }
+
+    std::unique_ptr<RenderPass> DepthNormalDownsample::build()
+    {
+        validate();
+
+        std::unique_ptr<RenderPass> ptr_downsample = std::make_unique<backend::DepthNormalDownsample> (
+            _device,
+            *_ptr_uv_image,
+            *_ptr_mat_index_image
+        );
+
+        constexpr auto depth            = AttachmentsTraits<backend::DepthNormalDownsample>::depth;
+        constexpr auto normal_tangent   = AttachmentsTraits<backend::DepthNormalDownsample>::normal_tangent;
+
+        ptr_downsample->resolutionDivisor(_resolution_divisor);
+
+        ptr_downsample->addColorOutput(depth, _ptr_low_res_depth_image);
+        ptr_downsample->addColorOutput(normal_tangent, _ptr_low_res_nor_tan_image);
+
+        ptr_downsample->addImageAccess(_ptr_nor_tan_image, vk::image_access::compute_sampled_read);
+        ptr_downsample->addImageAccess(_ptr_depth_image, vk::image_access::compute_depth_read);
+        ptr_downsample->addImageAccess(_ptr_low_res_depth_image, vk::image_access::compute_storage_write);
+        ptr_downsample->addImageAccess(_ptr_low_res_nor_tan_image, vk::image_access::compute_storage_write);
+
+        ptr_downsample->descriptorSet (
+            InputDescriptorSetTraits<backend::DepthNormalDownsample>::gbuffer,
+            _gbuffer_set_handle,
+            _gbuffer_set_layout_handle
+        );
+
+        return ptr_downsample;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+
+namespace pbrlib::backend
+{
+    class RenderPass;
+}
+
+namespace pbrlib::backend::vk
+{
+    class Device;
+    class Image;
+}
+
+namespace pbrlib::backend::builders
+{
+    class DepthNormalDownsample final
+    {
+        void validate();
+
+    public:
+        explicit DepthNormalDownsample(vk::Device& device) noexcept;
+
+        DepthNormalDownsample& uvImage(vk::Image& image)                    noexcept;
+        DepthNormalDownsample& normalTangentImage(vk::Image& image)         noexcept;
+        DepthNormalDownsample& materialIndexImage(vk::Image& image)         noexcept;
+        DepthNormalDownsample& depthImage(vk::Image& image)                 noexcept;
+        DepthNormalDownsample& lowResDepthImage(vk::Image& image)           noexcept;
+        DepthNormalDownsample& lowResNormalTangentImage(vk::Image& image)   noexcept;
+        DepthNormalDownsample& resolutionDivisor(uint32_t divisor)          noexcept;
+
+        DepthNormalDownsample& gbufferDescriptorSet(VkDescriptorSet set_handle, VkDescriptorSetLayout set_layout_handle) noexcept;
+
+        [[nodiscard]] std::unique_ptr<RenderPass> build();
+
+    private:
+        vk::Device& _device;
+
+        vk::Image* _ptr_uv_image                = nullptr;
+        vk::Image* _ptr_nor_tan_image           = nullptr;
+        vk::Image* _ptr_mat_index_image         = nullptr;
+        vk::Image* _ptr_depth_image             = nullptr;
+        vk::Image* _ptr_low_res_depth_image     = nullptr;
+        vk::Image* _ptr_low_res_nor_tan_image   = nullptr;
+
+        uint32_t _resolution_divisor = 2;
+
+        VkDescriptorSet         _gbuffer_set_handle         = VK_NULL_HANDLE;
+        VkDescriptorSetLayout   _gbuffer_set_layout_handle  = VK_NULL_HANDLE;
+    };
+}
@@ -9,9 +9,9 @@ namespace pbrlib::backend::builders
         _device (device)
     { }
 
-    GBufferGenerator& GBufferGenerator::posUvImage(vk::Image& image) noexcept
+    GBufferGenerator& GBufferGenerator::uvImage(vk::Image& image) noexcept
     {
-        _ptr_pos_uv_image = &image;
+        _ptr_uv_image = &image;
         return *this;
     }
 
@@ -33,10 +33,16 @@ namespace pbrlib::backend::builders
         return *this;
     }
 
+    GBufferGenerator& GBufferGenerator::depthPrePass(bool is_enabled) noexcept
+    {
+        _depth_pre_pass = is_enabled;
+        return *this;
+    }
+
     void GBufferGenerator::validate()
     {
-        if (!_ptr_pos_uv_image) [[unlikely]]
-            throw exception::InvalidState("[gbuffer-generator::builder] image for positions and uvs didn't set");
+        if (!_ptr_uv_image) [[unlikely]]
+            throw exception::InvalidState("[gbuffer-generator::builder] image for uvs didn't set");
 
         if (!_ptr_nor_tan_image) [[unlikely]]
             throw exception::InvalidState("[gbuffer-generator::builder] image for normals and tangents didn't set");
@@ -52,22 +58,21 @@ namespace pbrlib::backend::builders
     {
         validate();
 
-        std::unique_ptr<RenderPass> ptr_gbuffer_generator = std::make_unique<backend::GBufferGenerator>(_device);
+        std::unique_ptr<RenderPass> ptr_gbuffer_generator = std::make_unique<backend::GBufferGenerator>(_device, _depth_pre_pass);
 
-        constexpr auto pos_uv           = AttachmentsTraits<backend::GBufferGenerator>::pos_uv;
+        constexpr auto uv               = AttachmentsTraits<backend::GBufferGenerator>::uv;
         constexpr auto normal_tangent   = AttachmentsTraits<backend::GBufferGenerator>::normal_tangent;
         constexpr auto material_index   = AttachmentsTraits<backend::GBufferGenerator>::material_index;
 
-        ptr_gbuffer_generator->addColorOutput(pos_uv, _ptr_pos_uv_image);
+        ptr_gbuffer_generator->addColorOutput(uv, _ptr_uv_image);
         ptr_gbuffer_generator->addColorOutput(normal_tangent, _ptr_nor_tan_image);
         ptr_gbuffer_generator->addColorOutput(material_index, _ptr_mat_index_image);
         ptr_gbuffer_generator->depthStencil(_ptr_depth_stencil_image);
 
-        ptr_gbuffer_generator->addSyncImage (
-            _ptr_depth_stencil_image,
-            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT , ptr_gbuffer_generator->srcStage()
-        );
+        ptr_gbuffer_generator->addImageAccess(_ptr_uv_image, vk::image_access::color_attachment_write);
+        ptr_gbuffer_generator->addImageAccess(_ptr_nor_tan_image, vk::image_access::color_attachment_write);
+        ptr_gbuffer_generator->addImageAccess(_ptr_mat_index_image, vk::image_access::color_attachment_write);
+        ptr_gbuffer_generator->addImageAccess(_ptr_depth_stencil_image, vk::image_access::depth_attachment_write);
 
         return ptr_gbuffer_generator;
     }
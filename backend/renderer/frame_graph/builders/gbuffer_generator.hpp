@@ -22,19 +22,22 @@ namespace pbrlib::backend::builders
     public:
         explicit GBufferGenerator(vk::Device& device) noexcept;
 
-        GBufferGenerator& posUvImage(vk::Image& image)          noexcept;
+        GBufferGenerator& uvImage(vk::Image& image)             noexcept;
         GBufferGenerator& normalTangentImage(vk::Image& image)  noexcept;
         GBufferGenerator& materialIndexImage(vk::Image& image)  noexcept;
         GBufferGenerator& depthStencilImage(vk::Image& image)   noexcept;
+        GBufferGenerator& depthPrePass(bool is_enabled)         noexcept;
 
         [[nodiscard]] std::unique_ptr<RenderPass> build();
 
     private:
         vk::Device& _device;
 
-        vk::Image* _ptr_pos_uv_image        = nullptr;
+        vk::Image* _ptr_uv_image            = nullptr;
         vk::Image* _ptr_nor_tan_image       = nullptr;
         vk::Image* _ptr_mat_index_image     = nullptr;
         vk::Image* _ptr_depth_stencil_image = nullptr;
+
+        bool _depth_pre_pass = false;
     };
 }
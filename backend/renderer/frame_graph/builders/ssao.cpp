@@ -26,6 +26,9 @@ namespace pbrlib::backend::builders
             .sigma_l        = config.luminance_sigma
         };
 
+        _settings   = config;
+        _skip_blur  = config.temporal_accumulation && config.skip_blur;
+
         return *this;
     }
 
@@ -35,13 +38,21 @@ namespace pbrlib::backend::builders
         return *this;
     }
 
-    SSAO& SSAO::addSync (
-        vk::Image*              ptr_image,
-        VkImageLayout           expected_layout,
-        VkPipelineStageFlags2   src_stage
-    )
+    SSAO& SSAO::blurIntermediateImage(vk::Image& image) noexcept
+    {
+        _ptr_blur_intermediate_image = &image;
+        return *this;
+    }
+
+    SSAO& SSAO::temporalImage(vk::Image& image) noexcept
     {
-        _sync.emplace_back(ptr_image, expected_layout, src_stage);
+        _ptr_temporal_image = &image;
+        return *this;
+    }
+
+    SSAO& SSAO::addInput(vk::Image* ptr_image, const vk::ImageAccess& access)
+    {
+        _inputs.emplace_back(ptr_image, access);
         return *this;
     }
 
@@ -52,16 +63,36 @@ namespace pbrlib::backend::builders
         return *this;
     }
 
+    SSAO& SSAO::resolutionDivisor(uint32_t divisor) noexcept
+    {
+        _resolution_divisor = divisor;
+        return *this;
+    }
+
+    SSAO& SSAO::deferBlur(bool defer) noexcept
+    {
+        _defer_blur = defer;
+        return *this;
+    }
+
     void SSAO::validate()
     {
         if (!_ptr_ssao_image) [[unlikely]]
             throw exception::InvalidState("[ssao::builder] image for ssao didn't set");
 
-        if (!_ptr_blur_image) [[unlikely]]
+        const auto has_blur = !_skip_blur && !_defer_blur;
+
+        if (!_defer_blur && !_ptr_blur_image) [[unlikely]]
             throw exception::InvalidState("[ssao::builder] image for blur didn't set");
 
-        if (_sync.empty()) [[unlikely]]
-            throw exception::InvalidState("[ssao::builder] didn't set gbuffer sync data");
+        if (has_blur && !_ptr_blur_intermediate_image) [[unlikely]]
+            throw exception::InvalidState("[ssao::builder] intermediate image for blur didn't set");
+
+        if (_settings.temporal_accumulation && !_skip_blur && !_ptr_temporal_image) [[unlikely]]
+            throw exception::InvalidState("[ssao::builder] image for temporal accumulation didn't set");
+
+        if (_inputs.empty()) [[unlikely]]
+            throw exception::InvalidState("[ssao::builder] didn't set gbuffer inputs");
 
         if (_gbuffer_set_handle == VK_NULL_HANDLE || _gbuffer_set_layout_handle == VK_NULL_HANDLE) [[unlikely]]
             throw exception::InvalidState("[ssao::builder] didn't set gbuffer descriptor set");
@@ -71,37 +102,62 @@ namespace pbrlib::backend::builders
     {
         validate();
 
-        auto ptr_blur = std::make_unique<BilateralBlur>(_device, *_ptr_blur_image, _blur_settings);
-        ptr_blur->apply(*_ptr_ssao_image);
-
-        std::unique_ptr<RenderPass> ptr_ssao = std::make_unique<backend::SSAO>(_device, ptr_blur.get());
+        auto ptr_compound_render_pass = std::make_unique<CompoundRenderPass>(_device);
 
-        ptr_ssao->addSyncImage (
-            _ptr_ssao_image,
-            VK_IMAGE_LAYOUT_GENERAL,
-            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
-        );
+        std::unique_ptr<BilateralBlur> ptr_blur;
 
-        ptr_ssao->addColorOutput(AttachmentsTraits<backend::SSAO>::ssao, _ptr_ssao_image);
-
-        for (const auto& [ptr_image, expected_layout, src_stage]: _sync)
+        if (!_skip_blur && !_defer_blur)
         {
-            const auto dst_stage = expected_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
-                ?   ptr_ssao->srcStage()
-                :   ptr_ssao->dstStage();
-
-            ptr_ssao->addSyncImage (
-                ptr_image,
-                expected_layout,
-                src_stage, dst_stage
+            ptr_blur = std::make_unique<BilateralBlur> (
+                _device,
+                *_ptr_blur_image,
+                *_ptr_blur_intermediate_image,
+                _blur_settings,
+                _settings.blur_kernel
             );
+            ptr_blur->apply(_settings.temporal_accumulation ? *_ptr_temporal_image : *_ptr_ssao_image);
+            ptr_blur->resolutionDivisor(_resolution_divisor);
         }
 
+        std::unique_ptr<RenderPass> ptr_ssao = std::make_unique<backend::SSAO>(_device, ptr_blur.get(), _settings);
+
+        ptr_ssao->resolutionDivisor(_resolution_divisor);
+        ptr_ssao->addImageAccess(_ptr_ssao_image, vk::image_access::compute_storage_write);
+
+        ptr_ssao->addColorOutput(AttachmentsTraits<backend::SSAO>::ssao, _ptr_ssao_image);
+
+        for (const auto& [ptr_image, access]: _inputs)
+            ptr_ssao->addImageAccess(ptr_image, access);
+
         ptr_ssao->descriptorSet(InputDescriptorSetTraits<backend::SSAO>::gbuffer, _gbuffer_set_handle, _gbuffer_set_layout_handle);
 
-        auto ptr_compound_render_pass = std::make_unique<CompoundRenderPass>(_device);
         ptr_compound_render_pass->add(std::move(ptr_ssao));
-        ptr_compound_render_pass->add(std::move(ptr_blur));
+
+        if (_settings.temporal_accumulation)
+        {
+            /// Without the blur the accumulated occlusion is the result of the pass.
+            auto ptr_temporal = std::make_unique<TemporalAccumulation> (
+                _device,
+                _skip_blur ? *_ptr_blur_image : *_ptr_temporal_image
+            );
+
+            ptr_temporal->apply(*_ptr_ssao_image);
+            ptr_temporal->resolutionDivisor(_resolution_divisor);
+
+            for (const auto& [ptr_image, access]: _inputs)
+                ptr_temporal->addImageAccess(ptr_image, access);
+
+            ptr_temporal->descriptorSet (
+                InputDescriptorSetTraits<TemporalAccumulation>::gbuffer,
+                _gbuffer_set_handle,
+                _gbuffer_set_layout_handle
+            );
+
+            ptr_compound_render_pass->add(std::move(ptr_temporal));
+        }
+
+        if (ptr_blur)
+            ptr_compound_render_pass->add(std::move(ptr_blur));
 
         return ptr_compound_render_pass;
     }
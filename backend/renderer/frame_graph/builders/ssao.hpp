@@ -2,21 +2,19 @@
 
 #include <backend/renderer/frame_graph/compound_render_pass.hpp>
 #include <backend/renderer/frame_graph/filters/bilateral_blur.hpp>
+#include <backend/renderer/frame_graph/filters/temporal_accumulation.hpp>
+#include <backend/renderer/frame_graph/ssao.hpp>
 
-namespace pbrlib::settings
-{
-    struct SSAO;
-}
+#include <pbrlib/config.hpp>
 
 namespace pbrlib::backend::builders
 {
     class SSAO final
     {
-        struct SyncData final
+        struct InputData final
         {
-            vk::Image*              ptr_image       = nullptr;
-            VkImageLayout           expected_layout = VK_IMAGE_LAYOUT_UNDEFINED;
-            VkPipelineStageFlags2   src_stage       = VK_PIPELINE_STAGE_2_NONE;
+            vk::Image*      ptr_image = nullptr;
+            vk::ImageAccess access;
         };
 
         void validate();
@@ -26,16 +24,21 @@ namespace pbrlib::backend::builders
 
         SSAO& ssaoImage(vk::Image& image)                       noexcept;
         SSAO& blurImage(vk::Image& image)                       noexcept;
+        SSAO& blurIntermediateImage(vk::Image& image)           noexcept;
+        SSAO& temporalImage(vk::Image& image)                   noexcept;
         SSAO& settings(const pbrlib::settings::SSAO& config)    noexcept;
 
-        SSAO& addSync (
-            vk::Image*              ptr_image,
-            VkImageLayout           expected_layout,
-            VkPipelineStageFlags2   src_stage
-        );
+        /// Image of the gbuffer which the pass reads and how it's accessed.
+        SSAO& addInput(vk::Image* ptr_image, const vk::ImageAccess& access);
 
         SSAO& gbufferDescriptorSet(VkDescriptorSet set_handle, VkDescriptorSetLayout set_layout_handle) noexcept;
 
+        /// The occlusion and its blur run at the frame size divided by the divisor.
+        SSAO& resolutionDivisor(uint32_t divisor) noexcept;
+
+        /// The blur is done by a later fused pass, the result is the occlusion or its temporal accumulation.
+        SSAO& deferBlur(bool defer) noexcept;
+
         [[nodiscard]] std::unique_ptr<CompoundRenderPass> build();
 
     private:
@@ -44,11 +47,21 @@ namespace pbrlib::backend::builders
         vk::Image* _ptr_ssao_image = nullptr;
         vk::Image* _ptr_blur_image = nullptr;
 
-        std::vector<SyncData> _sync;
+        vk::Image* _ptr_blur_intermediate_image = nullptr;
+        vk::Image* _ptr_temporal_image          = nullptr;
+
+        std::vector<InputData> _inputs;
 
         VkDescriptorSet         _gbuffer_set_handle         = VK_NULL_HANDLE;
         VkDescriptorSetLayout   _gbuffer_set_layout_handle  = VK_NULL_HANDLE;
 
         BilateralBlur::Settings _blur_settings;
+
+        pbrlib::settings::SSAO _settings;
+
+        bool _skip_blur     = false;
+        bool _defer_blur    = false;
+
+        uint32_t _resolution_divisor = 1;
     };
 }
@@ -0,0 +1,87 @@
+#include <backend/renderer/frame_graph/builders/visibility_buffer.hpp>
+#include <backend/renderer/frame_graph/visibility_buffer.hpp>
+#include <backend/renderer/frame_graph/gbuffer_generator.hpp>
+
+#include <pbrlib/exceptions.hpp>
+
+namespace pbrlib::backend::builders
+{
+    VisibilityBuffer::VisibilityBuffer(vk::Device& device) noexcept :
+        _device (device)
+    { }
+
+    VisibilityBuffer& VisibilityBuffer::idsImage(vk::Image& image) noexcept
+    {
+        _ptr_ids_image = &image;
+        return *this;
+    }
+
+    VisibilityBuffer& VisibilityBuffer::uvImage(vk::Image& image) noexcept
+    {
+        _ptr_uv_image = &image;
+        return *this;
+    }
+
+    VisibilityBuffer& VisibilityBuffer::normalTangentImage(vk::Image& image) noexcept
+    {
+        _ptr_nor_tan_image = &image;
+        return *this;
+    }
+
+    VisibilityBuffer& VisibilityBuffer::materialIndexImage(vk::Image& image) noexcept
+    {
+        _ptr_mat_index_image = &image;
+        return *this;
+    }
+
+    VisibilityBuffer& VisibilityBuffer::depthStencilImage(vk::Image& image) noexcept
+    {
+        _ptr_depth_stencil_image = &image;
+        return *this;
+    }
+
+    void VisibilityBuffer::validate()
+    {
+        if (!_ptr_ids_image) [[unlikely]]
+            throw exception::InvalidState("[visibility-buffer::builder] image for ids didn't set");
+
+        if (!_ptr_uv_image) [[unlikely]]
+            throw exception::InvalidState("[visibility-buffer::builder] image for uvs didn't set");
+
+        if (!_ptr_nor_tan_image) [[unlikely]]
+            throw exception::InvalidState("[visibility-buffer::builder] image for normals and tangents didn't set");
+
+        if (!_ptr_mat_index_image) [[unlikely]]
+            throw exception::InvalidState("[visibility-buffer::builder] image for materials indices didn't set");
+
+        if (!_ptr_depth_stencil_image) [[unlikely]]
+            throw exception::InvalidState("[visibility-buffer::builder] image for depth-stencil didn't set");
+    }
+
+    std::unique_ptr<RenderPass> VisibilityBuffer::build()
+    {
+        validate();
+
+        std::unique_ptr<RenderPass> ptr_visibility_buffer = std::make_unique<backend::VisibilityBuffer>(_device);
+
+        constexpr auto ids              = AttachmentsTraits<backend::VisibilityBuffer>::ids;
+        constexpr auto uv               = AttachmentsTraits<backend::GBufferGenerator>::uv;
+        constexpr auto normal_tangent   = AttachmentsTraits<backend::GBufferGenerator>::normal_tangent;
+        constexpr auto material_index   = AttachmentsTraits<backend::GBufferGenerator>::material_index;
+
+        ptr_visibility_buffer->addColorOutput(ids, _ptr_ids_image);
+        ptr_visibility_buffer->addColorOutput(uv, _ptr_uv_image);
+        ptr_visibility_buffer->addColorOutput(normal_tangent, _ptr_nor_tan_image);
+        ptr_visibility_buffer->addColorOutput(material_index, _ptr_mat_index_image);
+        ptr_visibility_buffer->depthStencil(_ptr_depth_stencil_image);
+
+        /// The resolve barrier for the ids is recorded by the pass itself between the raster and the compute parts.
+        ptr_visibility_buffer->addImageAccess(_ptr_ids_image, vk::image_access::color_attachment_write);
+        ptr_visibility_buffer->addImageAccess(_ptr_uv_image, vk::image_access::compute_storage_write);
+        ptr_visibility_buffer->addImageAccess(_ptr_nor_tan_image, vk::image_access::compute_storage_write);
+        ptr_visibility_buffer->addImageAccess(_ptr_mat_index_image, vk::image_access::compute_storage_write);
+        ptr_visibility_buffer->addImageAccess(_ptr_depth_stencil_image, vk::image_access::depth_attachment_write);
+
+        return ptr_visibility_buffer;
+    }
+}
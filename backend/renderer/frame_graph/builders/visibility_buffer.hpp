@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+
+namespace pbrlib::backend
+{
+    class RenderPass;
+}
+
+namespace pbrlib::backend::vk
+{
+    class Device;
+    class Image;
+}
+
+namespace pbrlib::backend::builders
+{
+    class VisibilityBuffer final
+    {
+        void validate();
+
+    public:
+        explicit VisibilityBuffer(vk::Device& device) noexcept;
+
+        VisibilityBuffer& idsImage(vk::Image& image)            noexcept;
+        VisibilityBuffer& uvImage(vk::Image& image)             noexcept;
+        VisibilityBuffer& normalTangentImage(vk::Image& image)  noexcept;
+        VisibilityBuffer& materialIndexImage(vk::Image& image)  noexcept;
+        VisibilityBuffer& depthStencilImage(vk::Image& image)   noexcept;
+
+        [[nodiscard]] std::unique_ptr<RenderPass> build();
+
+    private:
+        vk::Device& _device;
+
+        vk::Image* _ptr_ids_image           = nullptr;
+        vk::Image* _ptr_uv_image            = nullptr;
+        vk::Image* _ptr_nor_tan_image       = nullptr;
+        vk::Image* _ptr_mat_index_image     = nullptr;
+        vk::Image* _ptr_depth_stencil_image = nullptr;
+    };
+}
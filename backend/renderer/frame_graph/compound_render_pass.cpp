@@ -51,20 +51,10 @@ namespace pbrlib::backend
             ptr_subpass->draw(command_buffer);
     }
 
-    VkPipelineStageFlags2 CompoundRenderPass::srcStage() const noexcept
+    void CompoundRenderPass::forEachSubpass(const std::function<void(RenderPass&)>& visitor)
     {
-        if (_subpasses.empty()) [[unlikely]]
-            return VK_PIPELINE_STAGE_2_NONE;
-
-        return _subpasses.front()->srcStage();
-    }
-
-    VkPipelineStageFlags2 CompoundRenderPass::dstStage() const noexcept
-    {
-        if (_subpasses.empty()) [[unlikely]]
-            return VK_PIPELINE_STAGE_2_NONE;
-
-        return _subpasses.back()->dstStage();
+        for (const auto& ptr_subpass: _subpasses)
+            ptr_subpass->forEachSubpass(visitor);
     }
 
     std::pair<VkDescriptorSet, VkDescriptorSetLayout> CompoundRenderPass::resultDescriptorSet() const noexcept
@@ -17,8 +17,7 @@ namespace pbrlib::backend
         void render(vk::CommandBuffer& command_buffer)                              override;
         void draw(vk::CommandBuffer& command_buffer)                                override;
 
-        VkPipelineStageFlags2 srcStage() const noexcept override;
-        VkPipelineStageFlags2 dstStage() const noexcept override;
+        void forEachSubpass(const std::function<void(RenderPass&)>& visitor) override;
 
         std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
 
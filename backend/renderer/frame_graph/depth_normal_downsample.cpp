@@ -0,0 +1,201 @@
+#include <backend/renderer/frame_graph/depth_normal_downsample.hpp>
+#include <backend/renderer/frame_graph/gbuffer_generator.hpp>
+
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/compute_pipeline.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+
+#include <backend/utils/align_size.hpp>
+
+#include <backend/profiling.hpp>
+
+#include <backend/logger/logger.hpp>
+
+#include <backend/events.hpp>
+
+namespace pbrlib::backend
+{
+    DepthNormalDownsample::DepthNormalDownsample (
+        vk::Device&         device,
+        const vk::Image&    uv_image,
+        const vk::Image&    material_index_image
+    ) :
+        RenderPass                  (device),
+        _ptr_uv_image               (&uv_image),
+        _ptr_material_index_image   (&material_index_image)
+    {
+        createResultDescriptorSet();
+
+        _output_descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(device)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        _output_descriptor_set_handle = device.allocateDescriptorSet (
+            _output_descriptor_set_layout_handle,
+            "[depth-normal-downsample] output descriptor set"
+        );
+    }
+
+    bool DepthNormalDownsample::init(const RenderContext& context, uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!RenderPass::init(context, width, height)) [[unlikely]]
+        {
+            log::error("[depth-normal-downsample] failed initialize");
+            return false;
+        }
+
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& event)
+        {
+            createPipeline();
+        });
+
+        _sampler_handle = device().nearestSampler();
+
+        initOutputDescriptorSet();
+        initResultDescriptorSet();
+
+        const auto [_, gbuffer_set_layout] = descriptorSet(InputDescriptorSetTraits<DepthNormalDownsample>::gbuffer);
+
+        _pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .addSetLayout(gbuffer_set_layout)
+            .addSetLayout(_output_descriptor_set_layout_handle)
+            .build();
+
+        return createPipeline();
+    }
+
+    bool DepthNormalDownsample::createPipeline()
+    {
+        constexpr auto downsample_shader = "shaders/depth_normal_downsample.glsl.comp";
+
+        auto new_pipeline = vk::builders::ComputePipeline(device())
+            .shader(downsample_shader)
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .build();
+
+        _pipeline_handle = std::move(new_pipeline);
+
+        return true;
+    }
+
+    void DepthNormalDownsample::render(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[depth-normal-downsample] run-pipeline");
+
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline_handle);
+
+            const std::array sets_descriptors
+            {
+                descriptorSet(InputDescriptorSetTraits<DepthNormalDownsample>::gbuffer).first,
+                _output_descriptor_set_handle.handle()
+            };
+
+            vkCmdBindDescriptorSets (
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _pipeline_layout_handle, 0,
+                static_cast<uint32_t>(sets_descriptors.size()), sets_descriptors.data(),
+                0, nullptr
+            );
+
+            const auto [width, height] = size();
+
+            const auto work_group_size = static_cast<uint32_t>(device().workGroupSize());
+
+            const auto group_count_x = utils::alignSize(width, work_group_size) / work_group_size;
+            const auto group_count_y = utils::alignSize(height, work_group_size) / work_group_size;
+
+            vkCmdDispatch(command_buffer_handle, group_count_x, group_count_y, 1);
+        }, "[depth-normal-downsample] run-pipeline", vk::marker_colors::compute_pipeline);
+    }
+
+    void DepthNormalDownsample::createResultDescriptorSet()
+    {
+        _result_descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(device())
+            .addBinding(GBufferDescriptorSetBindings::eUv, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eNormalTangent, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eMaterialIndices, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eDepthBuffer, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        _result_descriptor_set_handle = device().allocateDescriptorSet (
+            _result_descriptor_set_layout_handle,
+            "[depth-normal-downsample] descritor set with results"
+        );
+    }
+
+    void DepthNormalDownsample::initOutputDescriptorSet()
+    {
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<DepthNormalDownsample>::depth)->view_handle,
+            .set_handle             = _output_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = 0
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<DepthNormalDownsample>::normal_tangent)->view_handle,
+            .set_handle             = _output_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = 1
+        });
+    }
+
+    void DepthNormalDownsample::initResultDescriptorSet()
+    {
+        constexpr auto expected_image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        device().writeDescriptorSet ({
+            .view_handle            = _ptr_uv_image->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eUv
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<DepthNormalDownsample>::normal_tangent)->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eNormalTangent
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = _ptr_material_index_image->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eMaterialIndices
+        });
+
+        /// Unlike the depth buffer, the downsampled depth is a color image.
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<DepthNormalDownsample>::depth)->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eDepthBuffer
+        });
+    }
+
+    std::pair<VkDescriptorSet, VkDescriptorSetLayout> DepthNormalDownsample::resultDescriptorSet() const noexcept
+    {
+        return std::make_pair(_result_descriptor_set_handle.handle(), _result_descriptor_set_layout_handle);
+    }
+
+    std::string_view DepthNormalDownsample::name() const noexcept
+    {
+        return "depth-normal-downsample";
+    }
+}
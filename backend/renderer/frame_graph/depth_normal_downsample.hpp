@@ -0,0 +1,88 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/render_pass.hpp>
+#include <backend/renderer/vulkan/pipeline_layout.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/event_system.hpp>
+
+#include <array>
+
+namespace pbrlib::backend
+{
+    class DepthNormalDownsample;
+
+    template<>
+    struct AttachmentsTraits<DepthNormalDownsample> final
+    {
+        static constexpr auto metadata()
+        {
+            constexpr auto usage_flags =
+                VK_IMAGE_USAGE_SAMPLED_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            |   VK_IMAGE_USAGE_STORAGE_BIT;
+
+            constexpr std::array metadata
+            {
+                AttachmentMetadata(depth, VK_FORMAT_R32_SFLOAT, usage_flags, true),
+                AttachmentMetadata(normal_tangent, VK_FORMAT_R16G16B16A16_UNORM, usage_flags, true)
+            };
+
+            return metadata;
+        };
+
+        constexpr static auto depth          = "low-res-depth";
+        constexpr static auto normal_tangent = "low-res-normal-tangent";
+    };
+
+    template<>
+    struct InputDescriptorSetTraits<DepthNormalDownsample> final
+    {
+        constexpr static uint8_t gbuffer = 0;
+    };
+}
+
+namespace pbrlib::backend
+{
+    /// Keeps the closest surface of every block of pixels. The result descriptor set has the
+    /// layout of the G-buffer set, so passes at a reduced resolution read it unchanged.
+    class DepthNormalDownsample final :
+        public RenderPass,
+        public pbrlib::EventSystem
+    {
+        bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
+
+        bool createPipeline();
+
+        void render(vk::CommandBuffer& command_buffer) override;
+
+        void createResultDescriptorSet();
+
+        void initOutputDescriptorSet();
+        void initResultDescriptorSet();
+
+        std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
+
+        std::string_view name() const noexcept override;
+
+    public:
+        /// Uvs and material indices aren't downsampled, the result set refers to the full resolution images.
+        explicit DepthNormalDownsample(vk::Device& device, const vk::Image& uv_image, const vk::Image& material_index_image);
+
+    private:
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _pipeline_handle;
+
+        VkDescriptorSetLayout           _output_descriptor_set_layout_handle = VK_NULL_HANDLE;
+        vk::DescriptorSetHandle         _output_descriptor_set_handle;
+
+        VkDescriptorSetLayout           _result_descriptor_set_layout_handle = VK_NULL_HANDLE;
+        vk::DescriptorSetHandle         _result_descriptor_set_handle;
+
+        VkSampler _sampler_handle = VK_NULL_HANDLE;
+
+        const vk::Image* _ptr_uv_image              = nullptr;
+        const vk::Image* _ptr_material_index_image  = nullptr;
+    };
+}
@@ -0,0 +1,58 @@
+#include <backend/renderer/frame_graph/dynamic_resolution.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pbrlib::backend
+{
+    DynamicResolution::DynamicResolution(const settings::DynamicResolution& settings, uint32_t latency) noexcept :
+        _frame_time_budget_ms   (std::max(settings.frame_time_budget_ms, 0.1f)),
+        _min_scale              (std::clamp(settings.min_scale, scale_step, 1.0f)),
+        _max_scale              (std::clamp(settings.max_scale, _min_scale, 1.0f)),
+        _scale                  (_max_scale),
+        _latency                (latency)
+    { }
+
+    float DynamicResolution::update(std::span<const PassTiming> timings) noexcept
+    {
+        if (_frames_to_settle > 0)
+        {
+            --_frames_to_settle;
+            return _scale;
+        }
+
+        double frame_time_ms = 0.0;
+
+        for (const auto& timing: timings)
+            frame_time_ms += timing.milliseconds;
+
+        if (frame_time_ms <= 0.0) [[unlikely]]
+            return _scale;
+
+        /// The cost of the passes grows with the pixel count, i.e. with the square of the scale.
+        const auto ratio    = static_cast<float>(_frame_time_budget_ms / frame_time_ms);
+        const auto target   = std::clamp(_scale * std::sqrt(ratio), _min_scale, _max_scale);
+
+        if (std::abs(target - _scale) < scale_step)
+            return _scale;
+
+        /// Half of the difference per change damps the oscillation caused by the latency of the timings.
+        const auto damped   = _scale + (target - _scale) * 0.5f;
+        const auto step     = std::copysign(scale_step, target - _scale);
+
+        auto scale = std::round(damped / scale_step) * scale_step;
+
+        if (scale == _scale)
+            scale += step;
+
+        _scale              = std::clamp(scale, _min_scale, _max_scale);
+        _frames_to_settle   = _latency;
+
+        return _scale;
+    }
+
+    float DynamicResolution::scale() const noexcept
+    {
+        return _scale;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <pbrlib/config.hpp>
+#include <pbrlib/pass_timing.hpp>
+
+#include <span>
+
+#include <cstdint>
+
+namespace pbrlib::backend
+{
+    /// Chooses the render scale of the next frame from the GPU time of a completed one,
+    /// so the frame time stays near the budget.
+    class DynamicResolution final
+    {
+    public:
+        /// The timings arrive latency frames after the frame which they measure.
+        explicit DynamicResolution(const settings::DynamicResolution& settings, uint32_t latency) noexcept;
+
+        /// Returns the scale for the next frame.
+        float update(std::span<const PassTiming> timings) noexcept;
+
+        [[nodiscard]] float scale() const noexcept;
+
+        /// The scale changes in steps of this size, small deviations of the frame time are ignored.
+        static constexpr float scale_step = 1.0f / 32.0f;
+
+    private:
+        float _frame_time_budget_ms;
+
+        float _min_scale;
+        float _max_scale;
+        float _scale;
+
+        uint32_t _latency;
+
+        /// Frames left until the timings reflect the last change of the scale.
+        uint32_t _frames_to_settle = 0;
+    };
+}
@@ -18,10 +18,21 @@
 
 namespace pbrlib::backend
 {
-    BilateralBlur::BilateralBlur(vk::Device& device, vk::Image& dst_image, const Settings& settings):
-        Filter      ("bilateral-blur", device, dst_image),
-        _settings   (settings)
-    { }
+    BilateralBlur::BilateralBlur (
+        vk::Device&             device,
+        vk::Image&              dst_image,
+        vk::Image&              intermediate_image,
+        const Settings&         settings,
+        settings::BlurKernel    kernel
+    ) :
+        Filter                  ("bilateral-blur", device, dst_image),
+        _ptr_intermediate_image (&intermediate_image),
+        _settings               (settings),
+        _kernel                 (kernel)
+    {
+        /// The kernel may change at runtime, so the intermediate image is always declared.
+        addImageAccess(_ptr_intermediate_image, vk::image_access::compute_storage_write);
+    }
 
     void BilateralBlur::checkSettings() noexcept
     {
@@ -56,12 +67,58 @@ namespace pbrlib::backend
             .pushConstant(push_constant_range)
             .build();
 
+        initSeparableDescriptorSets();
+
         return createPipeline();
     }
 
+    void BilateralBlur::initSeparableDescriptorSets()
+    {
+        const auto [_, io_set_layout_handle] = IODescriptorSet();
+
+        _horizontal_set_handle  = device().allocateDescriptorSet(io_set_layout_handle, "[bilateral-blur] horizontal descriptor set");
+        _vertical_set_handle    = device().allocateDescriptorSet(io_set_layout_handle, "[bilateral-blur] vertical descriptor set");
+
+        _sampler_handle = device().nearestSampler();
+
+        device().writeDescriptorSet ({
+            .view_handle            = srcImage().view_handle.handle(),
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _horizontal_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .binding                = 0
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = _ptr_intermediate_image->view_handle.handle(),
+            .set_handle             = _horizontal_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = 1
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = _ptr_intermediate_image->view_handle.handle(),
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _vertical_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .binding                = 0
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = dstImage().view_handle.handle(),
+            .set_handle             = _vertical_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = 1
+        });
+    }
+
     bool BilateralBlur::createPipeline()
     {
-        constexpr auto blur_shader = "shaders/bilateral_blur.glsl.comp";
+        constexpr auto blur_shader              = "shaders/bilateral_blur.glsl.comp";
+        constexpr auto separable_blur_shader    = "shaders/bilateral_blur_separable.glsl.comp";
+
+        constexpr uint32_t horizontal   = 0;
+        constexpr uint32_t vertical     = 1;
 
         auto new_pipeline = vk::builders::ComputePipeline(device())
             .shader(blur_shader)
@@ -73,7 +130,29 @@ namespace pbrlib::backend
             )
             .build();
 
-        _pipeline_handle = std::move(new_pipeline);
+        auto new_horizontal_pipeline = vk::builders::ComputePipeline(device())
+            .shader(separable_blur_shader)
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .specializationInfo
+            (
+                vk::shader::SpecializationInfo(horizontal)
+                    .addEntry(0, 0, sizeof(horizontal))
+            )
+            .build();
+
+        auto new_vertical_pipeline = vk::builders::ComputePipeline(device())
+            .shader(separable_blur_shader)
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .specializationInfo
+            (
+                vk::shader::SpecializationInfo(vertical)
+                    .addEntry(0, 0, sizeof(vertical))
+            )
+            .build();
+
+        _pipeline_handle            = std::move(new_pipeline);
+        _horizontal_pipeline_handle = std::move(new_horizontal_pipeline);
+        _vertical_pipeline_handle   = std::move(new_vertical_pipeline);
 
         return true;
     }
@@ -84,6 +163,12 @@ namespace pbrlib::backend
 
         checkSettings();
 
+        if (_kernel == settings::BlurKernel::eSeparable)
+        {
+            renderSeparable(command_buffer);
+            return ;
+        }
+
         command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
         {
             PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[bilateral-blur] run-pipeline");
@@ -110,14 +195,46 @@ namespace pbrlib::backend
         }, "[bilateral-blur] run-pipeline", vk::marker_colors::bilateral_blur);
     }
 
-    VkPipelineStageFlags2 BilateralBlur::srcStage() const noexcept
+    void BilateralBlur::renderSeparable(vk::CommandBuffer& command_buffer)
     {
-        return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-    }
+        PBRLIB_PROFILING_ZONE_SCOPED;
 
-    VkPipelineStageFlags2 BilateralBlur::dstStage() const noexcept
-    {
-        return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        const auto run_pass = [this] (VkCommandBuffer command_buffer_handle, VkPipeline pipeline_handle, VkDescriptorSet set_handle)
+        {
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_handle);
+
+            vkCmdBindDescriptorSets(
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _pipeline_layout_handle,
+                0, 1, &set_handle,
+                0, nullptr
+            );
+
+            vkCmdPushConstants(
+                command_buffer_handle,
+                _pipeline_layout_handle,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(Settings), &_settings
+            );
+
+            dispatchCompute(command_buffer_handle);
+        };
+
+        command_buffer.write([this, &run_pass] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[bilateral-blur] horizontal-pass");
+            run_pass(command_buffer_handle, _horizontal_pipeline_handle, _horizontal_set_handle);
+        }, "[bilateral-blur] horizontal-pass", vk::marker_colors::bilateral_blur);
+
+        if (const auto barrier = _ptr_intermediate_image->barrier(vk::image_access::compute_sampled_read))
+            vk::pipelineBarrier(command_buffer, std::span(&barrier.value(), 1));
+
+        command_buffer.write([this, &run_pass] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[bilateral-blur] vertical-pass");
+            run_pass(command_buffer_handle, _vertical_pipeline_handle, _vertical_set_handle);
+        }, "[bilateral-blur] vertical-pass", vk::marker_colors::bilateral_blur);
     }
 
     std::pair<VkDescriptorSet, VkDescriptorSetLayout> BilateralBlur::resultDescriptorSet() const noexcept
@@ -134,4 +251,9 @@ namespace pbrlib::backend
     {
         return _settings;
     }
+
+    void BilateralBlur::kernel(settings::BlurKernel kernel) noexcept
+    {
+        _kernel = kernel;
+    }
 }
@@ -3,6 +3,7 @@
 #include <backend/renderer/frame_graph/filters/filter.hpp>
 #include <backend/renderer/vulkan/unique_handler.hpp>
 
+#include <pbrlib/config.hpp>
 #include <pbrlib/event_system.hpp>
 
 namespace pbrlib::backend
@@ -24,10 +25,10 @@ namespace pbrlib::backend
 
         bool createPipeline();
 
-        void render(vk::CommandBuffer& command_buffer) override;
+        void initSeparableDescriptorSets();
 
-        VkPipelineStageFlags2 srcStage() const noexcept override;
-        VkPipelineStageFlags2 dstStage() const noexcept override;
+        void render(vk::CommandBuffer& command_buffer) override;
+        void renderSeparable(vk::CommandBuffer& command_buffer);
 
         [[nodiscard]]
         std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
@@ -42,15 +43,35 @@ namespace pbrlib::backend
             float       sigma_l         = 0.1f;
         };
 
-        explicit BilateralBlur(vk::Device& device, vk::Image& dst_image, const Settings& settings);
+        /// The intermediate image keeps the result of the horizontal pass of the separable kernel.
+        explicit BilateralBlur (
+            vk::Device&             device,
+            vk::Image&              dst_image,
+            vk::Image&              intermediate_image,
+            const Settings&         settings,
+            settings::BlurKernel    kernel = settings::BlurKernel::eExact
+        );
 
         [[nodiscard]] Settings&         settings() noexcept;
         [[nodiscard]] const Settings&   settings() const noexcept;
 
+        void kernel(settings::BlurKernel kernel) noexcept;
+
     private:
-        vk::PipelineLayoutHandle    _pipeline_layout_handle;
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
         vk::PipelineHandle          _pipeline_handle;
 
-        Settings _settings;
+        vk::PipelineHandle _horizontal_pipeline_handle;
+        vk::PipelineHandle _vertical_pipeline_handle;
+
+        vk::DescriptorSetHandle _horizontal_set_handle;
+        vk::DescriptorSetHandle _vertical_set_handle;
+
+        VkSampler _sampler_handle = VK_NULL_HANDLE;
+
+        vk::Image* _ptr_intermediate_image = nullptr;
+
+        Settings                _settings;
+        settings::BlurKernel    _kernel;
     };
 }
@@ -0,0 +1,137 @@
+#include <backend/renderer/frame_graph/filters/blur_fxaa.hpp>
+
+#include <backend/renderer/vulkan/pipeline_layout.hpp>
+#include <backend/renderer/vulkan/compute_pipeline.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+
+#include <backend/shaders/gpu_cpu_constants.h>
+
+#include <backend/events.hpp>
+#include <pbrlib/event_system.hpp>
+
+#include <backend/profiling.hpp>
+
+#include <backend/logger/logger.hpp>
+
+#include <pbrlib/math/lerp.hpp>
+
+#include <algorithm>
+
+namespace pbrlib::backend
+{
+    BlurFXAA::BlurFXAA(vk::Device& device, vk::Image& dst_image, const BilateralBlur::Settings& blur_settings) :
+        Filter ("blur-fxaa", device, dst_image)
+    {
+        _push_constant_block.sample_count   = blur_settings.sample_count;
+        _push_constant_block.sigma_s        = blur_settings.sigma_s;
+        _push_constant_block.sigma_l        = blur_settings.sigma_l;
+    }
+
+    bool BlurFXAA::init(const RenderContext& context, uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!RenderPass::init(context, width, height)) [[unlikely]]
+        {
+            log::error("[blur-fxaa] failed initialize");
+            return false;
+        }
+
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& init)
+        {
+            createPipeline();
+        });
+
+        on([this] (const events::UpdateSSAO& settings)
+        {
+            const auto& config = settings.settings;
+
+            _push_constant_block.sample_count   = config.blur_samples_count;
+            _push_constant_block.sigma_s        = config.spatial_sigma;
+            _push_constant_block.sigma_l        = config.luminance_sigma;
+        });
+
+        /// Same mapping as FXAA.
+        on([this] (const events::UpdateFXAA& settings)
+        {
+            const auto& config = settings.settings;
+
+            const auto span_max     = std::clamp(config.span_max, 0.0f, 1.0f);
+            const auto reduce_min   = std::clamp(config.reduce_min, 0.0f, 1.0f);
+            const auto reduce_mul   = std::clamp(config.reduce_mul, 0.0f, 1.0f);
+
+            _push_constant_block.span_max   = math::lerp(4.0f, 16.0f, span_max);
+            _push_constant_block.reduce_min = math::lerp(1.0f / 256.0f, 1.0f / 64.0f, reduce_min);
+            _push_constant_block.reduce_mul = math::lerp(1.0f / 16.0f, 1.0f / 4.0f, reduce_mul);
+        });
+
+        const auto [_, io_set_layout_handle] = IODescriptorSet();
+
+        constexpr VkPushConstantRange push_constant_range =
+        {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset     = 0,
+            .size       = sizeof(PushConstantBlock)
+        };
+
+        _pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .addSetLayout(io_set_layout_handle)
+            .pushConstant(push_constant_range)
+            .build();
+
+        return createPipeline();
+    }
+
+    bool BlurFXAA::createPipeline()
+    {
+        auto new_pipeline = vk::builders::ComputePipeline(device())
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .shader("shaders/blur_fxaa.glsl.comp")
+            .build();
+
+        _pipeline_handle = std::move(new_pipeline);
+
+        return true;
+    }
+
+    void BlurFXAA::render(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        /// The halo of the tile holds at most half of the device work group.
+        _push_constant_block.sample_count = std::clamp(_push_constant_block.sample_count, 2u, 8u);
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[blur-fxaa] run-pipeline");
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline_handle);
+
+            const auto [io_set_handle, _] = IODescriptorSet();
+            vkCmdBindDescriptorSets(
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _pipeline_layout_handle,
+                0, 1, &io_set_handle,
+                0, nullptr
+            );
+
+            vkCmdPushConstants(
+                command_buffer_handle,
+                _pipeline_layout_handle,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, static_cast<uint32_t>(sizeof(PushConstantBlock)), &_push_constant_block
+            );
+
+            dispatchCompute(command_buffer_handle, PBRLIB_FUSED_TILE_SIZE);
+        }, "[blur-fxaa] run-pipeline", vk::marker_colors::fxaa);
+    }
+
+    std::pair<VkDescriptorSet, VkDescriptorSetLayout> BlurFXAA::resultDescriptorSet() const noexcept
+    {
+        return std::make_pair(VK_NULL_HANDLE, VK_NULL_HANDLE);
+    }
+}
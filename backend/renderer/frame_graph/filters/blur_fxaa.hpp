@@ -0,0 +1,45 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/filters/bilateral_blur.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/event_system.hpp>
+
+namespace pbrlib::backend
+{
+    /// Bilateral blur of the occlusion followed by FXAA in one dispatch. The blurred tile
+    /// with its halo stays in shared memory, so the blurred image is never written.
+    /// Writes the same image as FXAA.
+    class BlurFXAA final :
+        public Filter,
+        public pbrlib::EventSystem
+    {
+        struct PushConstantBlock final
+        {
+            uint32_t    sample_count    = 8;
+            float       sigma_s         = 2.0f;
+            float       sigma_l         = 0.1f;
+
+            float span_max      = 8.0;
+            float reduce_min    = 1.0 / 128.0;
+            float reduce_mul    = 1.0 / 8.0;
+        };
+
+        bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
+
+        void render(vk::CommandBuffer& command_buffer) override;
+
+        std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
+
+        bool createPipeline();
+
+    public:
+        explicit BlurFXAA(vk::Device& device, vk::Image& dst_image, const BilateralBlur::Settings& blur_settings);
+
+    private:
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _pipeline_handle;
+
+        PushConstantBlock _push_constant_block;
+    };
+}
@@ -4,30 +4,34 @@
 #include <backend/renderer/vulkan/image.hpp>
 #include <backend/renderer/vulkan/check.hpp>
 
+#include <backend/utils/align_size.hpp>
+
 #include <pbrlib/exceptions.hpp>
 
+#include <algorithm>
+
 namespace pbrlib::backend
 {
     Filter::Filter(std::string_view name, vk::Device& device, vk::Image& dst_image) noexcept :
-        RenderPass      (device),
-        _name           (name),
-        _ptr_dst_image  (&dst_image)
+        RenderPass  (device),
+        _name       (name)
     {
         _io_descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(device)
             .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .build();
 
-        _io_descriptor_set_handle = device.allocateDescriptorSet (
-            _io_descriptor_set_layout_handle,
-            std::format("[{}] input descriptor set", _name)
-        );
+        addDstImage(dst_image);
+    }
 
-        device.writeDescriptorSet ({
-            .view_handle            = _ptr_dst_image->view_handle.handle(),
-            .set_handle             = _io_descriptor_set_handle,
-            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
-            .binding                = 1
+    void Filter::writeSrcImage(VkDescriptorSet set_handle)
+    {
+        device().writeDescriptorSet ({
+            .view_handle            = srcImage().view_handle.handle(),
+            .sampler_handle         = _input_image_sampler_handle,
+            .set_handle             = set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .binding                = 0
         });
     }
 
@@ -35,29 +39,41 @@ namespace pbrlib::backend
     {
         _ptr_src_image = &image;
 
-        constexpr auto dst_stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        addImageAccess(_ptr_src_image, vk::image_access::compute_sampled_read);
+        addImageAccess(_destinations.front().ptr_image, vk::image_access::compute_storage_write);
 
-        addSyncImage (
-            _ptr_src_image,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, dst_stage
-        );
+        _input_image_sampler_handle = device().linearSampler();
 
-        addSyncImage (
-            _ptr_dst_image,
-            VK_IMAGE_LAYOUT_GENERAL,
-            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, dst_stage
-        );
+        for (const auto& destination: _destinations)
+            writeSrcImage(destination.io_descriptor_set_handle);
+    }
+
+    size_t Filter::addDstImage(vk::Image& image)
+    {
+        auto& destination = _destinations.emplace_back();
 
-        _input_image_sampler_handle = device().createLinearSampler();
+        destination.ptr_image                   = &image;
+        destination.io_descriptor_set_handle    = device().allocateDescriptorSet (
+            _io_descriptor_set_layout_handle,
+            std::format("[{}] input descriptor set {}", _name, _destinations.size() - 1)
+        );
 
         device().writeDescriptorSet ({
-            .view_handle            = srcImage().view_handle.handle(),
-            .sampler_handle         = _input_image_sampler_handle,
-            .set_handle             = _io_descriptor_set_handle,
-            .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            .binding                = 0
+            .view_handle            = image.view_handle.handle(),
+            .set_handle             = destination.io_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = 1
         });
+
+        if (_ptr_src_image)
+            writeSrcImage(destination.io_descriptor_set_handle);
+
+        return _destinations.size() - 1;
+    }
+
+    void Filter::selectDstImage(size_t index) noexcept
+    {
+        _dst_index = std::min(index, _destinations.size() - 1);
     }
 
     vk::Image& Filter::srcImage()
@@ -70,20 +86,34 @@ namespace pbrlib::backend
 
     vk::Image& Filter::dstImage() noexcept
     {
-        return *_ptr_dst_image;
+        return *_destinations[_dst_index].ptr_image;
     }
 
     std::pair<VkDescriptorSet, VkDescriptorSetLayout> Filter::IODescriptorSet() noexcept
     {
-        return std::make_pair(_io_descriptor_set_handle.handle(), _io_descriptor_set_layout_handle.handle());
+        return std::make_pair(
+            _destinations[_dst_index].io_descriptor_set_handle.handle(),
+            _io_descriptor_set_layout_handle
+        );
+    }
+
+    std::string_view Filter::name() const noexcept
+    {
+        return _name;
     }
 
     void Filter::dispatchCompute(VkCommandBuffer command_buffer_handle)
     {
-        const auto [width, height] = size();
+        dispatchCompute(command_buffer_handle, static_cast<uint32_t>(device().workGroupSize()));
+    }
+
+    void Filter::dispatchCompute(VkCommandBuffer command_buffer_handle, uint32_t tile_size)
+    {
+        const auto [width, height] = renderSize();
 
-        const auto group_count_x = width / device().workGroupSize();
-        const auto group_count_y = height / device().workGroupSize();
+        /// Passes below the frame resolution may have a size which isn't a multiple of the work group.
+        const auto group_count_x = utils::alignSize(width, tile_size) / tile_size;
+        const auto group_count_y = utils::alignSize(height, tile_size) / tile_size;
 
         vkCmdDispatch(command_buffer_handle, group_count_x, group_count_y, 1);
     }
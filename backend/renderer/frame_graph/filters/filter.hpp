@@ -5,6 +5,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace pbrlib::backend::vk
 {
@@ -16,28 +17,49 @@ namespace pbrlib::backend
     class Filter :
         public RenderPass
     {
+        struct Destination final
+        {
+            vk::Image*              ptr_image = nullptr;
+            vk::DescriptorSetHandle io_descriptor_set_handle;
+        };
+
+        void writeSrcImage(VkDescriptorSet set_handle);
+
     public:
         explicit Filter(std::string_view name, vk::Device& device, vk::Image& dst_image) noexcept;
 
         void apply(vk::Image& image);
 
+        /// Another image into which the filter may write instead of the destination, e.g. a swapchain image.
+        /// Accesses to it aren't tracked by the pass. Returns the index for selectDstImage().
+        size_t addDstImage(vk::Image& image);
+
+        /// 0 is the destination of the constructor.
+        void selectDstImage(size_t index) noexcept;
+
         [[nodiscard]] vk::Image& srcImage();
         [[nodiscard]] vk::Image& dstImage() noexcept;
 
         [[nodiscard]] std::pair<VkDescriptorSet, VkDescriptorSetLayout> IODescriptorSet() noexcept;
 
+        [[nodiscard]] std::string_view name() const noexcept override;
+
     protected:
         void dispatchCompute(VkCommandBuffer command_buffer_handle);
 
+        /// For shaders whose work group covers a tile of another size than the device work group.
+        void dispatchCompute(VkCommandBuffer command_buffer_handle, uint32_t tile_size);
+
     private:
         std::string _name;
 
-        vk::Image* _ptr_dst_image = nullptr;
         vk::Image* _ptr_src_image = nullptr;
 
-        vk::DescriptorSetLayoutHandle   _io_descriptor_set_layout_handle;
-        vk::DescriptorSetHandle         _io_descriptor_set_handle;
+        VkDescriptorSetLayout _io_descriptor_set_layout_handle = VK_NULL_HANDLE;
+
+        std::vector<Destination>    _destinations;
+        size_t                      _dst_index = 0;
 
-        vk::SamplerHandle _input_image_sampler_handle;
+        VkSampler _input_image_sampler_handle = VK_NULL_HANDLE;
     };
 }
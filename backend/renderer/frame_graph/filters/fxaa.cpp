@@ -109,16 +109,6 @@ namespace pbrlib::backend
         }, "[fxaa] run-pipeline", vk::marker_colors::fxaa);
     }
 
-    VkPipelineStageFlags2 FXAA::srcStage() const noexcept
-    {
-        return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-    }
-
-    VkPipelineStageFlags2 FXAA::dstStage() const noexcept
-    {
-        return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-    }
-
     std::pair<VkDescriptorSet, VkDescriptorSetLayout> FXAA::resultDescriptorSet() const noexcept
     {
         return std::make_pair(VK_NULL_HANDLE, VK_NULL_HANDLE);
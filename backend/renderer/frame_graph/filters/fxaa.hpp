@@ -52,9 +52,6 @@ namespace pbrlib::backend
 
         void render(vk::CommandBuffer& command_buffer) override;
 
-        VkPipelineStageFlags2 srcStage() const noexcept override;
-        VkPipelineStageFlags2 dstStage() const noexcept override;
-
         std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
 
         bool createPipeline();
@@ -63,7 +60,7 @@ namespace pbrlib::backend
         explicit FXAA(vk::Device& device, vk::Image& dst_image);
 
     private:
-        vk::PipelineLayoutHandle    _pipeline_layout_handle;
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
         vk::PipelineHandle          _pipeline_handle;
 
         Settings _settings;
@@ -0,0 +1,115 @@
+#include <backend/renderer/frame_graph/filters/joint_bilateral_upsample.hpp>
+
+#include <backend/renderer/vulkan/pipeline_layout.hpp>
+#include <backend/renderer/vulkan/compute_pipeline.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+
+#include <backend/events.hpp>
+#include <pbrlib/event_system.hpp>
+
+#include <backend/profiling.hpp>
+
+#include <backend/logger/logger.hpp>
+
+#include <pbrlib/math/matrix4x4.hpp>
+
+namespace pbrlib::backend
+{
+    JointBilateralUpsample::JointBilateralUpsample(vk::Device& device, vk::Image& dst_image) :
+        Filter ("joint-bilateral-upsample", device, dst_image)
+    { }
+
+    bool JointBilateralUpsample::init(const RenderContext& context, uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!RenderPass::init(context, width, height)) [[unlikely]]
+        {
+            log::error("[joint-bilateral-upsample] failed initialize");
+            return false;
+        }
+
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& init)
+        {
+            createPipeline();
+        });
+
+        using InputSets = InputDescriptorSetTraits<JointBilateralUpsample>;
+
+        const auto io_set_layout_handle         = IODescriptorSet().second;
+        const auto gbuffer_set_layout           = descriptorSet(InputSets::gbuffer).second;
+        const auto low_res_gbuffer_set_layout   = descriptorSet(InputSets::low_res_gbuffer).second;
+
+        constexpr VkPushConstantRange push_constant_range =
+        {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset     = 0,
+            .size       = sizeof(pbrlib::math::mat4)
+        };
+
+        _pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .addSetLayout(io_set_layout_handle)
+            .addSetLayout(gbuffer_set_layout)
+            .addSetLayout(low_res_gbuffer_set_layout)
+            .pushConstant(push_constant_range)
+            .build();
+
+        return createPipeline();
+    }
+
+    bool JointBilateralUpsample::createPipeline()
+    {
+        auto new_pipeline = vk::builders::ComputePipeline(device())
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .shader("shaders/joint_bilateral_upsample.glsl.comp")
+            .build();
+
+        _pipeline_handle = std::move(new_pipeline);
+
+        return true;
+    }
+
+    void JointBilateralUpsample::render(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[joint-bilateral-upsample] run-pipeline");
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline_handle);
+
+            const std::array sets_descriptors
+            {
+                IODescriptorSet().first,
+                descriptorSet(InputDescriptorSetTraits<JointBilateralUpsample>::gbuffer).first,
+                descriptorSet(InputDescriptorSetTraits<JointBilateralUpsample>::low_res_gbuffer).first
+            };
+
+            vkCmdBindDescriptorSets(
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _pipeline_layout_handle,
+                0, static_cast<uint32_t>(sets_descriptors.size()), sets_descriptors.data(),
+                0, nullptr
+            );
+
+            vkCmdPushConstants(
+                command_buffer_handle,
+                _pipeline_layout_handle,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, static_cast<uint32_t>(sizeof(pbrlib::math::mat4)), &context().projection
+            );
+
+            dispatchCompute(command_buffer_handle);
+        }, "[joint-bilateral-upsample] run-pipeline", vk::marker_colors::bilateral_blur);
+    }
+
+    std::pair<VkDescriptorSet, VkDescriptorSetLayout> JointBilateralUpsample::resultDescriptorSet() const noexcept
+    {
+        return std::make_pair(VK_NULL_HANDLE, VK_NULL_HANDLE);
+    }
+}
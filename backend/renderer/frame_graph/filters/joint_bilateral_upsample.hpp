@@ -0,0 +1,69 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/filters/filter.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/event_system.hpp>
+
+#include <array>
+
+namespace pbrlib::backend
+{
+    class JointBilateralUpsample;
+
+    template<>
+    struct AttachmentsTraits<JointBilateralUpsample> final
+    {
+        static constexpr auto metadata()
+        {
+            constexpr auto usage_flags =
+                VK_IMAGE_USAGE_SAMPLED_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            |   VK_IMAGE_USAGE_STORAGE_BIT;
+
+            constexpr std::array metadata
+            {
+                AttachmentMetadata(source, VK_FORMAT_R16_SFLOAT, usage_flags, true)
+            };
+
+            return metadata;
+        };
+
+        /// Low resolution image which is upsampled.
+        constexpr static auto source = "ssao-low-res-blur";
+    };
+
+    template<>
+    struct InputDescriptorSetTraits<JointBilateralUpsample> final
+    {
+        constexpr static uint8_t gbuffer            = 1;
+        constexpr static uint8_t low_res_gbuffer    = 2;
+    };
+}
+
+namespace pbrlib::backend
+{
+    /// Brings a low resolution image to the size of the destination. Each of the four
+    /// nearest low resolution texels is weighted by how close its depth and normal are
+    /// to the full resolution pixel, so the edges of the G-buffer are kept.
+    class JointBilateralUpsample final :
+        public Filter,
+        public pbrlib::EventSystem
+    {
+        bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
+
+        void render(vk::CommandBuffer& command_buffer) override;
+
+        std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
+
+        bool createPipeline();
+
+    public:
+        explicit JointBilateralUpsample(vk::Device& device, vk::Image& dst_image);
+
+    private:
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _pipeline_handle;
+    };
+}
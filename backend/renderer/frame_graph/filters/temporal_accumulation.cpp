@@ -0,0 +1,191 @@
+#include <backend/renderer/frame_graph/filters/temporal_accumulation.hpp>
+
+#include <backend/renderer/vulkan/pipeline_layout.hpp>
+#include <backend/renderer/vulkan/compute_pipeline.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+
+#include <backend/events.hpp>
+#include <pbrlib/event_system.hpp>
+
+#include <backend/profiling.hpp>
+
+#include <backend/logger/logger.hpp>
+
+#include <format>
+#include <vector>
+
+namespace pbrlib::backend
+{
+    TemporalAccumulation::TemporalAccumulation(vk::Device& device, vk::Image& dst_image) :
+        Filter ("temporal-accumulation", device, dst_image)
+    {
+        _history_set_layout_handle = vk::builders::DescriptorSetLayout(device)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        for (size_t i = 0; i < _history_set_handles.size(); ++i)
+        {
+            _history_set_handles[i] = device.allocateDescriptorSet (
+                _history_set_layout_handle,
+                std::format("[temporal-accumulation] history descriptor set {}", i)
+            );
+        }
+
+        _sampler_handle = device.nearestSampler();
+    }
+
+    bool TemporalAccumulation::init(const RenderContext& context, uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!RenderPass::init(context, width, height)) [[unlikely]]
+        {
+            log::error("[temporal-accumulation] failed initialize");
+            return false;
+        }
+
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& init)
+        {
+            createPipeline();
+        });
+
+        createHistory();
+
+        const auto io_set_layout_handle = IODescriptorSet().second;
+        const auto gbuffer_set_layout   = descriptorSet(InputDescriptorSetTraits<TemporalAccumulation>::gbuffer).second;
+
+        constexpr VkPushConstantRange push_constant_range =
+        {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset     = 0,
+            .size       = sizeof(PushConstantBlock)
+        };
+
+        _pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .addSetLayout(io_set_layout_handle)
+            .addSetLayout(gbuffer_set_layout)
+            .addSetLayout(_history_set_layout_handle)
+            .pushConstant(push_constant_range)
+            .build();
+
+        return createPipeline();
+    }
+
+    bool TemporalAccumulation::createPipeline()
+    {
+        auto new_pipeline = vk::builders::ComputePipeline(device())
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .shader("shaders/ssao/temporal_accumulation.glsl.comp")
+            .build();
+
+        _pipeline_handle = std::move(new_pipeline);
+
+        return true;
+    }
+
+    void TemporalAccumulation::createHistory()
+    {
+        const auto [width, height] = size();
+
+        for (size_t i = 0; i < _history_images.size(); ++i)
+        {
+            _history_images[i] = vk::builders::Image(device())
+                .addQueueFamilyIndex(device().queue().family_index)
+                .name(std::format("[temporal-accumulation] history {}", i))
+                .size(width, height)
+                .format(VK_FORMAT_R16G16B16A16_SFLOAT)
+                .usage(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT)
+                .build();
+        }
+
+        /// Set i reads the history i and writes the other one.
+        for (size_t i = 0; i < _history_set_handles.size(); ++i)
+        {
+            device().writeDescriptorSet ({
+                .view_handle            = _history_images[i]->view_handle,
+                .sampler_handle         = _sampler_handle,
+                .set_handle             = _history_set_handles[i],
+                .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .binding                = 0
+            });
+
+            device().writeDescriptorSet ({
+                .view_handle            = _history_images[1 - i]->view_handle,
+                .set_handle             = _history_set_handles[i],
+                .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+                .binding                = 1
+            });
+        }
+
+        /// The content of the new images is undefined.
+        _prev_view_projection = math::mat4(0.0f);
+    }
+
+    void TemporalAccumulation::render(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto read_index   = _frame_index % 2;
+        const auto write_index  = 1 - read_index;
+
+        std::vector<VkImageMemoryBarrier2> barriers;
+
+        if (const auto barrier = _history_images[read_index]->barrier(vk::image_access::compute_sampled_read))
+            barriers.push_back(barrier.value());
+
+        if (const auto barrier = _history_images[write_index]->barrier(vk::image_access::compute_storage_write))
+            barriers.push_back(barrier.value());
+
+        vk::pipelineBarrier(command_buffer, barriers);
+
+        const auto view_projection = context().projection * context().view;
+
+        const PushConstantBlock push_constant_block
+        {
+            .inv_view_projection    = math::inverse(view_projection),
+            .prev_view_projection   = _prev_view_projection
+        };
+
+        command_buffer.write([this, read_index, &push_constant_block] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[temporal-accumulation] run-pipeline");
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline_handle);
+
+            const std::array sets_descriptors
+            {
+                IODescriptorSet().first,
+                descriptorSet(InputDescriptorSetTraits<TemporalAccumulation>::gbuffer).first,
+                _history_set_handles[read_index].handle()
+            };
+
+            vkCmdBindDescriptorSets(
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _pipeline_layout_handle,
+                0, static_cast<uint32_t>(sets_descriptors.size()), sets_descriptors.data(),
+                0, nullptr
+            );
+
+            vkCmdPushConstants(
+                command_buffer_handle,
+                _pipeline_layout_handle,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, static_cast<uint32_t>(sizeof(PushConstantBlock)), &push_constant_block
+            );
+
+            dispatchCompute(command_buffer_handle);
+        }, "[temporal-accumulation] run-pipeline", vk::marker_colors::compute_pipeline);
+
+        _prev_view_projection = view_projection;
+        ++_frame_index;
+    }
+
+    std::pair<VkDescriptorSet, VkDescriptorSetLayout> TemporalAccumulation::resultDescriptorSet() const noexcept
+    {
+        return std::make_pair(VK_NULL_HANDLE, VK_NULL_HANDLE);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/filters/filter.hpp>
+#include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/math/matrix4x4.hpp>
+#include <pbrlib/event_system.hpp>
+
+#include <array>
+#include <optional>
+
+namespace pbrlib::backend
+{
+    class TemporalAccumulation;
+
+    template<>
+    struct AttachmentsTraits<TemporalAccumulation> final
+    {
+        static constexpr auto metadata()
+        {
+            constexpr auto usage_flags =
+                VK_IMAGE_USAGE_SAMPLED_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            |   VK_IMAGE_USAGE_STORAGE_BIT;
+
+            constexpr std::array metadata
+            {
+                AttachmentMetadata(result, VK_FORMAT_R16_SFLOAT, usage_flags, true)
+            };
+
+            return metadata;
+        };
+
+        constexpr static auto result = "ssao-temporal";
+    };
+
+    template<>
+    struct InputDescriptorSetTraits<TemporalAccumulation> final
+    {
+        constexpr static uint8_t gbuffer = 1;
+    };
+}
+
+namespace pbrlib::backend
+{
+    /// Blends the occlusion with the history of the previous frames. The history is reprojected
+    /// with the previous view-projection and rejected where depth or normal don't match.
+    class TemporalAccumulation final :
+        public Filter,
+        public pbrlib::EventSystem
+    {
+        struct PushConstantBlock final
+        {
+            math::mat4 inv_view_projection;
+            math::mat4 prev_view_projection;
+        };
+
+        bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
+
+        bool createPipeline();
+
+        void createHistory();
+
+        void render(vk::CommandBuffer& command_buffer) override;
+
+        std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
+
+    public:
+        explicit TemporalAccumulation(vk::Device& device, vk::Image& dst_image);
+
+    private:
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _pipeline_handle;
+
+        /// Occlusion, depth and normal of the last frames. One image is read while the other is written.
+        std::array<std::optional<vk::Image>, 2> _history_images;
+
+        VkDescriptorSetLayout                   _history_set_layout_handle = VK_NULL_HANDLE;
+        std::array<vk::DescriptorSetHandle, 2>  _history_set_handles;
+
+        VkSampler _sampler_handle = VK_NULL_HANDLE;
+
+        /// Zero until the first frame is accumulated, the shader rejects the whole history then.
+        math::mat4 _prev_view_projection = math::mat4(0.0f);
+
+        uint32_t _frame_index = 0;
+    };
+}
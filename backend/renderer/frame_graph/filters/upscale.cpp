@@ -0,0 +1,121 @@
+#include <backend/renderer/frame_graph/filters/upscale.hpp>
+
+#include <backend/renderer/vulkan/pipeline_layout.hpp>
+#include <backend/renderer/vulkan/compute_pipeline.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
+
+#include <backend/events.hpp>
+#include <pbrlib/event_system.hpp>
+
+#include <backend/profiling.hpp>
+
+#include <backend/logger/logger.hpp>
+
+#include <algorithm>
+
+namespace pbrlib::backend
+{
+    Upscale::Upscale(vk::Device& device, vk::Image& dst_image, float sharpness) :
+        Filter      ("upscale", device, dst_image),
+        _sharpness  (std::clamp(sharpness, 0.0f, 1.0f))
+    { }
+
+    bool Upscale::init(const RenderContext& context, uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!RenderPass::init(context, width, height)) [[unlikely]]
+        {
+            log::error("[upscale] failed initialize");
+            return false;
+        }
+
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& init)
+        {
+            createPipeline();
+        });
+
+        const auto [_, io_set_layout_handle] = IODescriptorSet();
+
+        constexpr VkPushConstantRange push_constant_range =
+        {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset     = 0,
+            .size       = sizeof(PushConstantBlock)
+        };
+
+        _pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .addSetLayout(io_set_layout_handle)
+            .pushConstant(push_constant_range)
+            .build();
+
+        return createPipeline();
+    }
+
+    bool Upscale::createPipeline()
+    {
+        auto new_pipeline = vk::builders::ComputePipeline(device())
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .shader("shaders/upscale.glsl.comp")
+            .build();
+
+        _pipeline_handle = std::move(new_pipeline);
+
+        return true;
+    }
+
+    void Upscale::render(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[upscale] run-pipeline");
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline_handle);
+
+            const auto [io_set_handle, _] = IODescriptorSet();
+            vkCmdBindDescriptorSets(
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _pipeline_layout_handle,
+                0, 1, &io_set_handle,
+                0, nullptr
+            );
+
+            /// The rectangle which the previous passes have written.
+            const auto [render_width, render_height]    = RenderPass::renderSize();
+            const auto [width, height]                  = size();
+
+            const PushConstantBlock push_constant_block
+            {
+                .render_width   = static_cast<float>(render_width),
+                .render_height  = static_cast<float>(render_height),
+                .scale_x        = static_cast<float>(render_width) / static_cast<float>(width),
+                .scale_y        = static_cast<float>(render_height) / static_cast<float>(height),
+                .sharpness      = _sharpness
+            };
+
+            vkCmdPushConstants(
+                command_buffer_handle,
+                _pipeline_layout_handle,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, static_cast<uint32_t>(sizeof(PushConstantBlock)), &push_constant_block
+            );
+
+            dispatchCompute(command_buffer_handle);
+        }, "[upscale] run-pipeline", vk::marker_colors::upscale);
+    }
+
+    std::pair<VkDescriptorSet, VkDescriptorSetLayout> Upscale::resultDescriptorSet() const noexcept
+    {
+        return std::make_pair(VK_NULL_HANDLE, VK_NULL_HANDLE);
+    }
+
+    std::pair<uint32_t, uint32_t> Upscale::renderSize() const noexcept
+    {
+        return size();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/filters/filter.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/event_system.hpp>
+
+#include <array>
+
+namespace pbrlib::backend
+{
+    class Upscale;
+
+    template<>
+    struct AttachmentsTraits<Upscale> final
+    {
+        static constexpr auto metadata()
+        {
+            constexpr auto usage_flags =
+                VK_IMAGE_USAGE_SAMPLED_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            |   VK_IMAGE_USAGE_STORAGE_BIT;
+
+            constexpr std::array metadata
+            {
+                AttachmentMetadata(result, VK_FORMAT_R16G16B16A16_SFLOAT, usage_flags),
+            };
+
+            return metadata;
+        };
+
+        constexpr static auto result = "upscale";
+    };
+}
+
+namespace pbrlib::backend
+{
+    /// Stretches the rendered rectangle of the source over the whole destination
+    /// with a bilinear filter followed by sharpening.
+    class Upscale final :
+        public Filter,
+        public pbrlib::EventSystem
+    {
+        struct PushConstantBlock final
+        {
+            float render_width  = 0.0f;
+            float render_height = 0.0f;
+
+            /// Ratio of the rendered rectangle to the destination.
+            float scale_x = 1.0f;
+            float scale_y = 1.0f;
+
+            float sharpness = 0.0f;
+        };
+
+        bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
+
+        void render(vk::CommandBuffer& command_buffer) override;
+
+        std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
+
+        /// The destination is always written entirely.
+        std::pair<uint32_t, uint32_t> renderSize() const noexcept override;
+
+        bool createPipeline();
+
+    public:
+        explicit Upscale(vk::Device& device, vk::Image& dst_image, float sharpness);
+
+    private:
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _pipeline_handle;
+
+        float _sharpness;
+    };
+}
@@ -8,13 +8,21 @@
 #include <backend/renderer/vulkan/sync.hpp>
 
 #include <backend/renderer/frame_graph/compound_render_pass.hpp>
+#include <backend/renderer/frame_graph/depth_normal_downsample.hpp>
 #include <backend/renderer/frame_graph/gbuffer_generator.hpp>
 #include <backend/renderer/frame_graph/ssao.hpp>
+#include <backend/renderer/frame_graph/visibility_buffer.hpp>
 
+#include <backend/renderer/frame_graph/builders/depth_normal_downsample.hpp>
 #include <backend/renderer/frame_graph/builders/ssao.hpp>
 #include <backend/renderer/frame_graph/builders/gbuffer_generator.hpp>
+#include <backend/renderer/frame_graph/builders/visibility_buffer.hpp>
 
+#include <backend/renderer/frame_graph/filters/blur_fxaa.hpp>
 #include <backend/renderer/frame_graph/filters/fxaa.hpp>
+#include <backend/renderer/frame_graph/filters/joint_bilateral_upsample.hpp>
+#include <backend/renderer/frame_graph/filters/temporal_accumulation.hpp>
+#include <backend/renderer/frame_graph/filters/upscale.hpp>
 
 #include <backend/logger/logger.hpp>
 
@@ -30,6 +38,8 @@
 #include <backend/utils/align_size.hpp>
 #include <backend/shaders/gpu_cpu_constants.h>
 
+#include <algorithm>
+
 namespace pbrlib::backend
 {
     FrameGraph::FrameGraph (
@@ -39,13 +49,16 @@ namespace pbrlib::backend
         MaterialManager&        material_manager,
         MeshManager&            mesh_manager
     ) :
-        _device (device),
-        _canvas (canvas),
-        _config (config)
+        _device             (device),
+        _canvas             (canvas),
+        _config             (config),
+        _render_target_pool (device)
     {
         _render_context.ptr_material_manager    = &material_manager;
         _render_context.ptr_mesh_manager        = &mesh_manager;
 
+        validateDynamicResolution();
+
         const auto [width, height] = _canvas.size();
         build(width, height);
 
@@ -53,12 +66,7 @@ namespace pbrlib::backend
 
         on([this] (const events::ResizeWindow& event)
         {
-            vkDeviceWaitIdle(_device.device());
-
-            _render_passes_images.clear();
-            _ptr_render_pass.reset();
-
-            build(event.width, event.height);
+            rebuild(event.width, event.height);
         });
     }
 }
@@ -75,43 +83,102 @@ namespace pbrlib::backend
             return ;
         }
 
+        _canvas.waitForPresent();
+
+        releaseRetiredBuilds();
+
         updatePerFrameData(camera, items);
 
+        /// The semaphores and the query pool of the frame may be reused only after its previous submit has completed.
+        _device.wait(_in_flight_values[_render_context.flight_frame_index]);
+
         if (_pre_render_callback)
             _pre_render_callback();
 
+        const auto present_image_index = acquirePresentImage();
+
         auto command_buffer = _device.oneTimeSubmitCommandBuffer("command-buffer-for-draw");
 
+        if (_gpu_profiler)
+            _gpu_profiler->beginFrame(command_buffer, _render_context.flight_frame_index);
+
         clearImages(command_buffer);
 
+        if (present_image_index)
+        {
+            auto& swapchain_image = _ptr_present_filter->dstImage();
+
+            /// Execution dependency on the semaphore wait of the submit.
+            swapchain_image.discard(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+            if (const auto barrier = swapchain_image.barrier(vk::image_access::compute_storage_write))
+                vk::pipelineBarrier(command_buffer, std::span(&barrier.value(), 1));
+        }
+
         _ptr_render_pass->draw(command_buffer);
-        flush(command_buffer);
+        flush(command_buffer, present_image_index);
     }
 
-    void FrameGraph::flush(vk::CommandBuffer& command_buffer)
+    std::optional<uint32_t> FrameGraph::acquirePresentImage()
     {
+        if (!_ptr_present_filter)
+            return std::nullopt;
+
         const auto frame_index = _render_context.flight_frame_index;
 
-        const auto fence_handle = _in_flight_fences[frame_index].handle();
+        const auto image_index = _canvas.acquire(_image_available_semaphores[frame_index].handle());
 
-        vk::sync(_device.device(), fence_handle);
+        _ptr_present_filter->selectDstImage(image_index ? *image_index + 1 : 0);
 
-        _device.submit(
-            command_buffer,
-            VK_NULL_HANDLE,
-            VK_NULL_HANDLE,
-            fence_handle
-        );
+        return image_index;
+    }
+
+    void FrameGraph::flush(vk::CommandBuffer& command_buffer, std::optional<uint32_t> present_image_index)
+    {
+        const auto frame_index = _render_context.flight_frame_index;
+
+        if (_gpu_profiler)
+            _gpu_profiler->collect(frame_index);
+
+        if (present_image_index)
+        {
+            const auto available_semaphore  = _image_available_semaphores[frame_index].handle();
+            const auto finished_semaphore   = _render_finished_semaphores[frame_index].handle();
+
+            if (const auto barrier = _ptr_present_filter->dstImage().barrier(vk::image_access::present))
+                vk::pipelineBarrier(command_buffer, std::span(&barrier.value(), 1));
+
+            _in_flight_values[frame_index] = _device.submit(command_buffer, available_semaphore, finished_semaphore);
+            _device.retire(std::move(command_buffer), _in_flight_values[frame_index]);
+
+            if (_post_render_callback)
+                _post_render_callback();
+
+            if (_present_to_display_callback)
+                _present_to_display_callback();
+
+            _canvas.present(*present_image_index, finished_semaphore);
+
+            return ;
+        }
+
+        auto ptr_result = &_render_passes_images.at(resultAttachment(_config));
+
+        if (const auto barrier = ptr_result->barrier(vk::image_access::transfer_read))
+            vk::pipelineBarrier(command_buffer, std::span(&barrier.value(), 1));
+
+        _in_flight_values[frame_index] = _device.submit(command_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+        _device.retire(std::move(command_buffer), _in_flight_values[frame_index]);
 
         if (_post_render_callback)
             _post_render_callback();
 
-        auto ptr_result = &_render_passes_images.at(AttachmentsTraits<FXAA>::result);
-
         if (_present_to_display_callback)
             _present_to_display_callback();
 
-        ptr_result->changeLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        /// The swapchain went out of date, the frame is dropped.
+        if (_ptr_present_filter)
+            return ;
 
         const auto available_semaphore = _image_available_semaphores[frame_index].handle();
         _canvas.present(ptr_result, available_semaphore);
@@ -122,46 +189,186 @@ namespace pbrlib::backend
 {
     std::unique_ptr<RenderPass> FrameGraph::buildGBufferGeneratorSubpass()
     {
-        auto ptr_pos_uv_image           = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::pos_uv);
+        auto ptr_uv_image               = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::uv);
         auto ptr_nor_tan_image          = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::normal_tangent);
         auto ptr_mat_index_image        = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::material_index);
         auto ptr_depth_stencil_image    = &_depth_buffer.value();
 
+        if (_config.geometry_pass == settings::GeometryPass::eVisibilityBuffer)
+        {
+            return builders::VisibilityBuffer(_device)
+                .idsImage(_render_passes_images.at(AttachmentsTraits<VisibilityBuffer>::ids))
+                .uvImage(*ptr_uv_image)
+                .normalTangentImage(*ptr_nor_tan_image)
+                .materialIndexImage(*ptr_mat_index_image)
+                .depthStencilImage(*ptr_depth_stencil_image)
+                .build();
+        }
+
         return builders::GBufferGenerator(_device)
-            .posUvImage(*ptr_pos_uv_image)
+            .uvImage(*ptr_uv_image)
             .normalTangentImage(*ptr_nor_tan_image)
             .materialIndexImage(*ptr_mat_index_image)
             .depthStencilImage(*ptr_depth_stencil_image)
+            .depthPrePass(_config.depth_pre_pass)
             .build();
     }
 
-    std::unique_ptr<RenderPass> FrameGraph::buildSSAOSubpass (
-        vk::Image*              ptr_pos_uv,
-        vk::Image*              ptr_normal_tangent,
-        vk::Image*              ptr_depth_buffer,
-        const RenderPass*       ptr_gbuffer
+    RenderTargetDescription depthBufferDescription(uint32_t width, uint32_t height) noexcept
+    {
+        return RenderTargetDescription
+        {
+            .format = VK_FORMAT_D32_SFLOAT,
+            .width  = width,
+            .height = height,
+            .usage  = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+        };
+    }
+
+    uint32_t ssaoResolutionDivisor(settings::SSAOResolution resolution) noexcept
+    {
+        switch (resolution)
+        {
+            case settings::SSAOResolution::eHalf:       return 2;
+            case settings::SSAOResolution::eQuarter:    return 4;
+            default:                                    return 1;
+        }
+    }
+
+    /// The fused kernel reads the occlusion of the full resolution and replaces the blur and FXAA.
+    bool fusePostProcessing(const pbrlib::Config& config) noexcept
+    {
+        const auto skip_blur = config.ssao.temporal_accumulation && config.ssao.skip_blur;
+
+        return config.fuse_post_processing
+            && config.aa == settings::AA::eFXAA
+            && ssaoResolutionDivisor(config.ssao.resolution) == 1
+            && !skip_blur;
+    }
+
+    /// The image which is copied to the swapchain.
+    std::string_view resultAttachment(const pbrlib::Config& config) noexcept
+    {
+        if (config.dynamic_resolution.enabled)
+            return AttachmentsTraits<Upscale>::result;
+
+        return AttachmentsTraits<FXAA>::result;
+    }
+
+    /// The last image written at the render scale.
+    std::string_view upscaleSource(const pbrlib::Config& config) noexcept
+    {
+        if (config.aa == settings::AA::eFXAA)
+            return AttachmentsTraits<FXAA>::result;
+
+        return AttachmentsTraits<SSAO>::blur;
+    }
+
+    std::unique_ptr<RenderPass> FrameGraph::buildDepthNormalDownsampleSubpass (
+        const RenderPass*   ptr_gbuffer,
+        uint32_t            resolution_divisor
     )
     {
-        const auto src_stage = ptr_gbuffer->dstStage();
+        const auto [gbuffer_set_handle, gbuffer_set_layout_handle] = ptr_gbuffer->resultDescriptorSet();
+
+        return builders::DepthNormalDownsample(_device)
+            .uvImage(_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::uv))
+            .normalTangentImage(_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::normal_tangent))
+            .materialIndexImage(_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::material_index))
+            .depthImage(_depth_buffer.value())
+            .lowResDepthImage(_render_passes_images.at(AttachmentsTraits<DepthNormalDownsample>::depth))
+            .lowResNormalTangentImage(_render_passes_images.at(AttachmentsTraits<DepthNormalDownsample>::normal_tangent))
+            .resolutionDivisor(resolution_divisor)
+            .gbufferDescriptorSet(gbuffer_set_handle, gbuffer_set_layout_handle)
+            .build();
+    }
 
+    std::unique_ptr<RenderPass> FrameGraph::buildSSAOSubpass(const RenderPass* ptr_gbuffer, uint32_t resolution_divisor)
+    {
         const auto [gbuffer_set_handle, gbuffer_set_layout_handle] = ptr_gbuffer->resultDescriptorSet();
 
-        return builders::SSAO(_device)
+        auto ptr_uv             = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::uv);
+        auto ptr_material_index = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::material_index);
+
+        builders::SSAO ssao_builder (_device);
+
+        ssao_builder
             .ssaoImage(_render_passes_images.at(AttachmentsTraits<SSAO>::ssao))
-            .blurImage(_render_passes_images.at(AttachmentsTraits<SSAO>::blur))
+            .blurIntermediateImage(_render_passes_images.at(AttachmentsTraits<SSAO>::blur_intermediate))
             .settings(_config.ssao)
-            .addSync(ptr_pos_uv, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, src_stage)
-            .addSync(ptr_normal_tangent, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, src_stage)
-            .addSync(ptr_depth_buffer, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, src_stage)
-            .gbufferDescriptorSet(gbuffer_set_handle, gbuffer_set_layout_handle)
+            .resolutionDivisor(resolution_divisor)
+            .addInput(ptr_uv, vk::image_access::compute_sampled_read)
+            .addInput(ptr_material_index, vk::image_access::compute_sampled_read)
+            .gbufferDescriptorSet(gbuffer_set_handle, gbuffer_set_layout_handle);
+
+        if (_config.ssao.temporal_accumulation)
+            ssao_builder.temporalImage(_render_passes_images.at(AttachmentsTraits<TemporalAccumulation>::result));
+
+        if (resolution_divisor == 1)
+        {
+            return ssao_builder
+                .blurImage(_render_passes_images.at(AttachmentsTraits<SSAO>::blur))
+                .deferBlur(fusePostProcessing(_config))
+                .addInput(&_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::normal_tangent), vk::image_access::compute_sampled_read)
+                .addInput(&_depth_buffer.value(), vk::image_access::compute_depth_read)
+                .build();
+        }
+
+        /// The downsampled depth is a color image written by a compute pass.
+        return ssao_builder
+            .blurImage(_render_passes_images.at(AttachmentsTraits<JointBilateralUpsample>::source))
+            .addInput(&_render_passes_images.at(AttachmentsTraits<DepthNormalDownsample>::normal_tangent), vk::image_access::compute_sampled_read)
+            .addInput(&_render_passes_images.at(AttachmentsTraits<DepthNormalDownsample>::depth), vk::image_access::compute_sampled_read)
             .build();
     }
 
-    void FrameGraph::setupAA(CompoundRenderPass& compound_render_pass, vk::Image& image, settings::AA aa)
+    std::unique_ptr<RenderPass> FrameGraph::buildSSAOUpsampleSubpass (
+        const RenderPass* ptr_gbuffer,
+        const RenderPass* ptr_low_res_gbuffer
+    )
     {
-        if (aa == settings::AA::eNone)
-            return ;
+        using InputSets = InputDescriptorSetTraits<JointBilateralUpsample>;
+
+        const auto [gbuffer_set_handle, gbuffer_set_layout_handle]                   = ptr_gbuffer->resultDescriptorSet();
+        const auto [low_res_gbuffer_set_handle, low_res_gbuffer_set_layout_handle]   = ptr_low_res_gbuffer->resultDescriptorSet();
+
+        auto ptr_upsample = std::make_unique<JointBilateralUpsample>(_device, _render_passes_images.at(AttachmentsTraits<SSAO>::blur));
+        ptr_upsample->apply(_render_passes_images.at(AttachmentsTraits<JointBilateralUpsample>::source));
 
+        ptr_upsample->addImageAccess(&_render_passes_images.at(AttachmentsTraits<DepthNormalDownsample>::depth), vk::image_access::compute_sampled_read);
+        ptr_upsample->addImageAccess(&_render_passes_images.at(AttachmentsTraits<DepthNormalDownsample>::normal_tangent), vk::image_access::compute_sampled_read);
+        ptr_upsample->addImageAccess(&_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::normal_tangent), vk::image_access::compute_sampled_read);
+        ptr_upsample->addImageAccess(&_depth_buffer.value(), vk::image_access::compute_depth_read);
+
+        ptr_upsample->descriptorSet(InputSets::gbuffer, gbuffer_set_handle, gbuffer_set_layout_handle);
+        ptr_upsample->descriptorSet(InputSets::low_res_gbuffer, low_res_gbuffer_set_handle, low_res_gbuffer_set_layout_handle);
+
+        return ptr_upsample;
+    }
+
+    std::unique_ptr<Filter> FrameGraph::buildBlurFXAASubpass()
+    {
+        const auto& ssao = _config.ssao;
+
+        const BilateralBlur::Settings blur_settings
+        {
+            .sample_count   = ssao.blur_samples_count,
+            .sigma_s        = ssao.spatial_sigma,
+            .sigma_l        = ssao.luminance_sigma
+        };
+
+        auto ptr_blur_fxaa = std::make_unique<BlurFXAA>(_device, _render_passes_images.at(AttachmentsTraits<FXAA>::result), blur_settings);
+
+        ptr_blur_fxaa->apply(ssao.temporal_accumulation ?
+            _render_passes_images.at(AttachmentsTraits<TemporalAccumulation>::result) :
+            _render_passes_images.at(AttachmentsTraits<SSAO>::ssao)
+        );
+
+        return ptr_blur_fxaa;
+    }
+
+    Filter* FrameGraph::setupAA(CompoundRenderPass& compound_render_pass, vk::Image& image, settings::AA aa)
+    {
         if (aa == settings::AA::eFXAA)
         {
             auto& result = _render_passes_images.at(AttachmentsTraits<FXAA>::result);
@@ -169,8 +376,70 @@ namespace pbrlib::backend
             auto ptr_fxaa = std::make_unique<FXAA>(_device, result);
             ptr_fxaa->apply(image);
 
+            auto ptr_final_filter = ptr_fxaa.get();
             compound_render_pass.add(std::move(ptr_fxaa));
+
+            return ptr_final_filter;
         }
+
+        return nullptr;
+    }
+
+    Filter* FrameGraph::setupUpscale(CompoundRenderPass& compound_render_pass)
+    {
+        const auto sharpness = _config.dynamic_resolution.sharpness;
+
+        auto ptr_upscale = std::make_unique<Upscale>(_device, _render_passes_images.at(AttachmentsTraits<Upscale>::result), sharpness);
+        ptr_upscale->apply(_render_passes_images.find(upscaleSource(_config))->second);
+
+        auto ptr_final_filter = ptr_upscale.get();
+        compound_render_pass.add(std::move(ptr_upscale));
+
+        return ptr_final_filter;
+    }
+
+    void FrameGraph::validateDynamicResolution()
+    {
+        auto& dynamic_resolution = _config.dynamic_resolution;
+
+        if (!dynamic_resolution.enabled)
+            return ;
+
+        /// The passes which derive positions from the pixel of a full size image would need the scale too.
+        const auto supported =
+            _config.gpu_timings
+        &&  _config.geometry_pass == settings::GeometryPass::eGBuffer
+        &&  ssaoResolutionDivisor(_config.ssao.resolution) == 1
+        &&  !_config.ssao.temporal_accumulation;
+
+        if (!supported) [[unlikely]]
+        {
+            log::warning (
+                "[frame-graph] dynamic resolution requires the GPU timings, the G-buffer geometry pass, "
+                "the occlusion at the full resolution and no temporal accumulation, it's disabled"
+            );
+
+            dynamic_resolution.enabled = false;
+            return ;
+        }
+
+        _dynamic_resolution.emplace(dynamic_resolution, _canvas.framesInFlight());
+    }
+
+    void FrameGraph::setupDirectPresent(Filter* ptr_final_filter)
+    {
+        _ptr_present_filter = nullptr;
+
+        const auto swapchain_images = _canvas.storageTargets();
+
+        if (!_config.zero_copy_present || !ptr_final_filter || swapchain_images.empty())
+            return ;
+
+        /// Index 0 stays the result image, swapchain image i is selected with i + 1.
+        for (auto& image: swapchain_images)
+            ptr_final_filter->addDstImage(image);
+
+        _ptr_present_filter = ptr_final_filter;
     }
 
     void FrameGraph::build(uint32_t width, uint32_t height)
@@ -188,84 +457,333 @@ namespace pbrlib::backend
 
         auto ptr_gbuffer_generator = buildGBufferGeneratorSubpass();
 
-        auto ptr_pos_uv         = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::pos_uv);
-        auto ptr_normal_tangent = &_render_passes_images.at(AttachmentsTraits<GBufferGenerator>::normal_tangent);
+        Filter* ptr_final_filter = nullptr;
 
-        auto ptr_ssao = buildSSAOSubpass (
-            ptr_pos_uv,
-            ptr_normal_tangent,
-            &_depth_buffer.value(),
-            ptr_gbuffer_generator.get()
-        );
+        const auto ssao_resolution_divisor = ssaoResolutionDivisor(_config.ssao.resolution);
+
+        if (ssao_resolution_divisor == 1)
+        {
+            auto ptr_ssao = buildSSAOSubpass(ptr_gbuffer_generator.get(), ssao_resolution_divisor);
 
-        ptr_render_pass->add(std::move(ptr_gbuffer_generator));
-        ptr_render_pass->add(std::move(ptr_ssao));
+            ptr_render_pass->add(std::move(ptr_gbuffer_generator));
+            ptr_render_pass->add(std::move(ptr_ssao));
 
-        setupAA(*ptr_render_pass, _render_passes_images.at(AttachmentsTraits<SSAO>::blur), _config.aa);
+            if (fusePostProcessing(_config))
+            {
+                auto ptr_blur_fxaa = buildBlurFXAASubpass();
+                ptr_final_filter = ptr_blur_fxaa.get();
+
+                ptr_render_pass->add(std::move(ptr_blur_fxaa));
+            }
+        }
+        else
+        {
+            auto ptr_downsample = buildDepthNormalDownsampleSubpass(ptr_gbuffer_generator.get(), ssao_resolution_divisor);
+            auto ptr_ssao       = buildSSAOSubpass(ptr_downsample.get(), ssao_resolution_divisor);
+            auto ptr_upsample   = buildSSAOUpsampleSubpass(ptr_gbuffer_generator.get(), ptr_downsample.get());
+
+            ptr_render_pass->add(std::move(ptr_gbuffer_generator));
+            ptr_render_pass->add(std::move(ptr_downsample));
+            ptr_render_pass->add(std::move(ptr_ssao));
+            ptr_render_pass->add(std::move(ptr_upsample));
+        }
+
+        if (!fusePostProcessing(_config))
+            ptr_final_filter = setupAA(*ptr_render_pass, _render_passes_images.at(AttachmentsTraits<SSAO>::blur), _config.aa);
+
+        if (_config.dynamic_resolution.enabled)
+            ptr_final_filter = setupUpscale(*ptr_render_pass);
+
+        setupDirectPresent(ptr_final_filter);
 
         _ptr_render_pass = std::move(ptr_render_pass);
 
+        discardAliasedImages();
+
         if (!_ptr_render_pass->init(_render_context, width, height)) [[unlikely]]
             throw exception::InitializeError("[frame-graph] failed initialize render passes");
     }
 
+    void FrameGraph::rebuild(uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto release_value = std::ranges::max(_in_flight_values);
+
+        _transient_images->release(_render_passes_images, release_value);
+
+        const auto depth_description = depthBufferDescription(_depth_buffer->width, _depth_buffer->height);
+
+        _render_target_pool.release(depth_description, std::move(_depth_buffer.value()), release_value);
+        _depth_buffer.reset();
+
+        _retired_builds.push_back (
+            RetiredBuild
+            {
+                .release_value          = release_value,
+                .ptr_render_pass        = std::move(_ptr_render_pass),
+                .ptr_transient_images   = std::move(_transient_images),
+                .images                 = std::move(_render_passes_images)
+            }
+        );
+
+        _render_passes_images.clear();
+        _ptr_present_filter = nullptr;
+
+        build(width, height);
+
+        _render_target_pool.trim();
+    }
+
+    void FrameGraph::releaseRetiredBuilds()
+    {
+        const auto completed_value = _device.completedValue();
+
+        while (!_retired_builds.empty() && _retired_builds.front().release_value <= completed_value)
+            _retired_builds.pop_front();
+    }
+
     template<HasAttachments T>
-    void createRenderPassImages(vk::Device& device, auto& images, uint32_t width, uint32_t height)
+    void addRenderPassImages(TransientImages& transient_images, uint32_t resolution_divisor = 1)
     {
-        for (const auto [name, format, usage]: AttachmentsTraits<T>::metadata())
-        {
-            images.emplace(
-                name,
-                vk::builders::Image(device)
-                    .size(width, height)
-                    .format(format)
-                    .usage(usage)
-                    .addQueueFamilyIndex(device.queue().family_index)
-                    .name(name)
-                    .build()
-            );
-        }
+        for (const auto [name, format, usage, is_scaled]: AttachmentsTraits<T>::metadata())
+            transient_images.addImage(name, format, usage, is_scaled ? resolution_divisor : 1);
     }
 
     void FrameGraph::createResources(uint32_t width, uint32_t height)
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
-        _depth_buffer = vk::builders::Image(_device)
-            .size(width, height)
-            .format(VK_FORMAT_D32_SFLOAT)
-            .usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
-            .addQueueFamilyIndex(_device.queue().family_index)
-            .name("depth-buffer")
-            .build();
+        _depth_buffer = _render_target_pool.acquire(depthBufferDescription(width, height), "depth-buffer");
+
+        _transient_images = std::make_unique<TransientImages>(_device);
+
+        _transient_images
+            ->aliasing(_config.alias_transient_images)
+            .pool(&_render_target_pool);
+
+        addRenderPassImages<GBufferGenerator>(*_transient_images);
+
+        if (_config.geometry_pass == settings::GeometryPass::eVisibilityBuffer)
+            addRenderPassImages<VisibilityBuffer>(*_transient_images);
+
+        const auto ssao_resolution_divisor = ssaoResolutionDivisor(_config.ssao.resolution);
+
+        addRenderPassImages<SSAO>(*_transient_images, ssao_resolution_divisor);
+
+        if (_config.ssao.temporal_accumulation)
+            addRenderPassImages<TemporalAccumulation>(*_transient_images, ssao_resolution_divisor);
+
+        if (ssao_resolution_divisor > 1)
+        {
+            addRenderPassImages<DepthNormalDownsample>(*_transient_images, ssao_resolution_divisor);
+            addRenderPassImages<JointBilateralUpsample>(*_transient_images, ssao_resolution_divisor);
+        }
+
+        addRenderPassImages<FXAA>(*_transient_images);
+
+        if (_config.dynamic_resolution.enabled)
+            addRenderPassImages<Upscale>(*_transient_images);
+
+        declarePasses();
+
+        _transient_images->build(width, height, _render_passes_images);
+    }
+
+    void FrameGraph::declarePasses()
+    {
+        using GBufferAttachments    = AttachmentsTraits<GBufferGenerator>;
+        using SSAOAttachments       = AttachmentsTraits<SSAO>;
+        using FXAAAttachments       = AttachmentsTraits<FXAA>;
+
+        /// Must match the order of the subpasses created in build().
+        if (_config.geometry_pass == settings::GeometryPass::eVisibilityBuffer)
+        {
+            /// The ids are rasterized and resolved into the G-buffer in the same pass.
+            _transient_images->addPass ({
+                .writes =
+                {
+                    AttachmentsTraits<VisibilityBuffer>::ids,
+                    GBufferAttachments::uv,
+                    GBufferAttachments::normal_tangent,
+                    GBufferAttachments::material_index
+                },
+                .stage  = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+        }
+        else
+        {
+            _transient_images->addPass ({
+                .writes = {GBufferAttachments::uv, GBufferAttachments::normal_tangent, GBufferAttachments::material_index},
+                .stage  = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+            });
+        }
+
+        if (ssaoResolutionDivisor(_config.ssao.resolution) == 1)
+        {
+            const std::vector<std::string_view> ssao_reads
+            {
+                GBufferAttachments::uv,
+                GBufferAttachments::normal_tangent,
+                GBufferAttachments::material_index
+            };
+
+            _transient_images->addPass ({
+                .reads  = ssao_reads,
+                .writes = {SSAOAttachments::ssao},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+
+            declareSSAOFilterPasses(ssao_reads, SSAOAttachments::blur);
+        }
+        else
+        {
+            using DownsampleAttachments = AttachmentsTraits<DepthNormalDownsample>;
+            using UpsampleAttachments   = AttachmentsTraits<JointBilateralUpsample>;
+
+            _transient_images->addPass ({
+                .reads  = {GBufferAttachments::normal_tangent},
+                .writes = {DownsampleAttachments::depth, DownsampleAttachments::normal_tangent},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+
+            const std::vector<std::string_view> ssao_reads
+            {
+                GBufferAttachments::uv,
+                GBufferAttachments::material_index,
+                DownsampleAttachments::depth,
+                DownsampleAttachments::normal_tangent
+            };
+
+            _transient_images->addPass ({
+                .reads  = ssao_reads,
+                .writes = {SSAOAttachments::ssao},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+
+            declareSSAOFilterPasses(ssao_reads, UpsampleAttachments::source);
+
+            _transient_images->addPass ({
+                .reads  =
+                {
+                    UpsampleAttachments::source,
+                    DownsampleAttachments::depth,
+                    DownsampleAttachments::normal_tangent,
+                    GBufferAttachments::normal_tangent
+                },
+                .writes = {SSAOAttachments::blur},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+        }
+
+        if (_config.aa == settings::AA::eFXAA && !fusePostProcessing(_config))
+        {
+            _transient_images->addPass ({
+                .reads  = {SSAOAttachments::blur},
+                .writes = {FXAAAttachments::result},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+        }
+
+        if (_config.dynamic_resolution.enabled)
+        {
+            _transient_images->addPass ({
+                .reads  = {upscaleSource(_config)},
+                .writes = {AttachmentsTraits<Upscale>::result},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+        }
+
+        /// The result is copied to the swapchain after the frame.
+        _transient_images->addPass ({
+            .reads  = {resultAttachment(_config)},
+            .stage  = VK_PIPELINE_STAGE_2_TRANSFER_BIT
+        });
+    }
 
-        createRenderPassImages<GBufferGenerator>(_device, _render_passes_images, width, height);
-        createRenderPassImages<SSAO>(_device, _render_passes_images, width, height);
-        createRenderPassImages<FXAA>(_device, _render_passes_images, width, height);
+    void FrameGraph::declareSSAOFilterPasses(const std::vector<std::string_view>& ssao_reads, std::string_view target)
+    {
+        using SSAOAttachments = AttachmentsTraits<SSAO>;
+
+        std::string_view blur_source = SSAOAttachments::ssao;
+
+        /// The temporal accumulation reads the same G-buffer as the occlusion.
+        if (_config.ssao.temporal_accumulation)
+        {
+            const auto skip_blur = _config.ssao.skip_blur;
+
+            auto reads = ssao_reads;
+            reads.push_back(SSAOAttachments::ssao);
+
+            _transient_images->addPass ({
+                .reads  = std::move(reads),
+                .writes = {skip_blur ? target : std::string_view(AttachmentsTraits<TemporalAccumulation>::result)},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+
+            if (skip_blur)
+                return ;
+
+            blur_source = AttachmentsTraits<TemporalAccumulation>::result;
+        }
+
+        if (fusePostProcessing(_config))
+        {
+            _transient_images->addPass ({
+                .reads  = {blur_source},
+                .writes = {AttachmentsTraits<FXAA>::result},
+                .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+            });
+
+            return ;
+        }
+
+        _transient_images->addPass ({
+            .reads  = {blur_source},
+            .writes = {SSAOAttachments::blur_intermediate, target},
+            .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+        });
+    }
+
+    void FrameGraph::discardAliasedImages()
+    {
+        std::vector<RenderPass*> passes;
+        _ptr_render_pass->forEachSubpass([&passes] (RenderPass& pass)
+        {
+            passes.push_back(&pass);
+        });
+
+        for (const auto& [name, pass_index, src_stage]: _transient_images->discards())
+        {
+            if (pass_index >= passes.size()) [[unlikely]]
+                throw exception::InvalidState(std::format("[frame-graph] image '{}' is discarded in unknown pass {}", name, pass_index));
+
+            auto& image = _render_passes_images.find(name)->second;
+            passes[pass_index]->discardImage(&image, src_stage);
+        }
     }
 
     void FrameGraph::initFrameSync()
     {
         _image_available_semaphores.reserve(_canvas.framesInFlight());
         _render_finished_semaphores.reserve(_canvas.framesInFlight());
-        _in_flight_fences.reserve(_canvas.framesInFlight());
+        _in_flight_values.assign(_canvas.framesInFlight(), 0);
 
         constexpr VkSemaphoreCreateInfo semaphore_create_info
         {
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
         };
 
-        constexpr VkFenceCreateInfo fence_create_info
-        {
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-            .flags = VK_FENCE_CREATE_SIGNALED_BIT
-        };
-
         for ([[maybe_unused]] const auto frame_index: std::views::iota(0u, _canvas.framesInFlight()))
         {
             _image_available_semaphores.emplace_back(vk::create(_device.device(), semaphore_create_info));
             _render_finished_semaphores.emplace_back(vk::create(_device.device(), semaphore_create_info));
-            _in_flight_fences.emplace_back(vk::create(_device.device(), fence_create_info));
+        }
+
+        if (_config.gpu_timings)
+        {
+            _gpu_profiler.emplace(_device, _canvas.framesInFlight());
+            _render_context.ptr_gpu_profiler = &_gpu_profiler.value();
         }
     }
 }
@@ -280,6 +798,10 @@ namespace pbrlib::backend
         _render_context.projection  = camera.projection();
         _render_context.view        = camera.view();
 
+        /// The timings of the last collected frame decide the scale of this one.
+        if (_dynamic_resolution)
+            _render_context.render_scale = _dynamic_resolution->update(gpuTimings());
+
         _render_context.flight_frame_index = (++_render_context.flight_frame_index) % _canvas.framesInFlight();
     }
 }
@@ -288,10 +810,28 @@ namespace pbrlib::backend
 {
     void FrameGraph::clearImages(vk::CommandBuffer& command_buffer)
     {
-        for (auto& [_, image]: _render_passes_images)
-            image.changeLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        /// The G-buffer is cleared by the load op of its render pass and the compute passes
+        /// overwrite their whole outputs, only images which nothing writes before reading are cleared.
+        std::vector<vk::Image*>             cleared_images;
+        std::vector<VkImageMemoryBarrier2>  barriers;
 
-        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        for (auto& [name, image]: _render_passes_images)
+        {
+            if (!_transient_images->needsClear(name))
+                continue;
+
+            cleared_images.push_back(&image);
+
+            if (const auto barrier = image.barrier(vk::image_access::transfer_write))
+                barriers.push_back(*barrier);
+        }
+
+        if (cleared_images.empty())
+            return ;
+
+        vk::pipelineBarrier(command_buffer, barriers);
+
+        command_buffer.write([cleared_images = std::move(cleared_images)] (VkCommandBuffer command_buffer_handle)
         {
             constexpr VkClearColorValue clear_color = {0.0, 0.0, 0.0, 0.0};
 
@@ -302,11 +842,11 @@ namespace pbrlib::backend
                 .layerCount = 1
             };
 
-            for (auto& [_, image]: _render_passes_images)
+            for (const auto ptr_image: cleared_images)
             {
                 vkCmdClearColorImage(
                     command_buffer_handle,
-                    image.handle.handle(), image.layout,
+                    ptr_image->handle.handle(), ptr_image->layout,
                     &clear_color,
                     1, &range
                 );
@@ -331,4 +871,17 @@ namespace pbrlib::backend
     {
         _present_to_display_callback = callback;
     }
+
+    std::span<const PassTiming> FrameGraph::gpuTimings() const noexcept
+    {
+        if (_gpu_profiler)
+            return _gpu_profiler->timings();
+
+        return { };
+    }
+
+    float FrameGraph::renderScale() const noexcept
+    {
+        return _render_context.render_scale;
+    }
 }
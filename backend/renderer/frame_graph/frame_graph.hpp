@@ -1,7 +1,10 @@
 #pragma once
 
 #include <backend/renderer/frame_graph/render_pass.hpp>
+#include <backend/renderer/frame_graph/dynamic_resolution.hpp>
+#include <backend/renderer/frame_graph/transient_images.hpp>
 #include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/gpu_profiler.hpp>
 
 #include <pbrlib/config.hpp>
 #include <pbrlib/camera.hpp>
@@ -9,8 +12,11 @@
 
 #include <string>
 #include <memory>
+#include <deque>
 #include <map>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 namespace pbrlib::testing
 {
@@ -23,6 +29,7 @@ namespace pbrlib::backend
     class MaterialManager;
     class MeshManager;
     class CompoundRenderPass;
+    class Filter;
 }
 
 namespace pbrlib::backend
@@ -38,27 +45,48 @@ namespace pbrlib::backend
             std::less<void>
         >;
 
+        /// Resources of a previous build which the frames in flight may still use.
+        struct RetiredBuild final
+        {
+            uint64_t                            release_value = 0;
+            std::unique_ptr<RenderPass>         ptr_render_pass;
+            std::unique_ptr<TransientImages>    ptr_transient_images;
+            RenderPassesImages                  images;
+        };
+
         void createResources(uint32_t width, uint32_t height);
+        void declarePasses();
+        void declareSSAOFilterPasses(const std::vector<std::string_view>& ssao_reads, std::string_view target);
+        void discardAliasedImages();
         void initFrameSync();
 
         void build(uint32_t width, uint32_t height);
 
+        /// Builds the frame graph again without waiting for the device. Dedicated images go back
+        /// to the pool, the passes and the shared memory are kept until the GPU completes the last frame.
+        void rebuild(uint32_t width, uint32_t height);
+        void releaseRetiredBuilds();
+
         std::unique_ptr<RenderPass> buildGBufferGeneratorSubpass();
 
-        std::unique_ptr<RenderPass> buildSSAOSubpass (
-            vk::Image*              ptr_pos_uv,
-            vk::Image*              ptr_normal_tangent,
-            vk::Image*              ptr_depth_buffer,
-            const RenderPass*       ptr_gbuffer
-        );
+        std::unique_ptr<RenderPass> buildDepthNormalDownsampleSubpass(const RenderPass* ptr_gbuffer, uint32_t resolution_divisor);
+        std::unique_ptr<RenderPass> buildSSAOSubpass(const RenderPass* ptr_gbuffer, uint32_t resolution_divisor);
+        std::unique_ptr<RenderPass> buildSSAOUpsampleSubpass(const RenderPass* ptr_gbuffer, const RenderPass* ptr_low_res_gbuffer);
+        std::unique_ptr<Filter> buildBlurFXAASubpass();
+
+        void validateDynamicResolution();
 
-        void setupAA(CompoundRenderPass& compound_render_pass, vk::Image& image, settings::AA aa);
+        Filter* setupAA(CompoundRenderPass& compound_render_pass, vk::Image& image, settings::AA aa);
+        Filter* setupUpscale(CompoundRenderPass& compound_render_pass);
+        void    setupDirectPresent(Filter* ptr_final_filter);
 
         void updatePerFrameData(const Camera& camera, std::span<const SceneItem*> items);
 
         void clearImages(vk::CommandBuffer& command_buffer);
 
-        void flush(vk::CommandBuffer& command_buffer);
+        [[nodiscard]] std::optional<uint32_t> acquirePresentImage();
+
+        void flush(vk::CommandBuffer& command_buffer, std::optional<uint32_t> present_image_index);
 
     public:
         explicit FrameGraph (
@@ -81,20 +109,43 @@ namespace pbrlib::backend
         void postRenderCallback(const std::function<void()>& callback);
         void presentToDisplayCallback(const std::function<void()>& callback);
 
+        /// Timings of the passes of a frame completed frames in flight ago, empty if they aren't measured.
+        [[nodiscard]] std::span<const PassTiming> gpuTimings() const noexcept;
+
+        /// Fraction of the frame size which the scene is rendered at, 1 without the dynamic resolution.
+        [[nodiscard]] float renderScale() const noexcept;
+
     private:
         vk::Device& _device;
         Canvas&     _canvas;
 
         pbrlib::Config _config;
 
+        RenderTargetPool _render_target_pool;
+
         std::unique_ptr<RenderPass> _ptr_render_pass;
 
+        /// Must be destroyed after the images that alias its memory.
+        std::unique_ptr<TransientImages> _transient_images;
+
         RenderPassesImages          _render_passes_images;
         std::optional<vk::Image>    _depth_buffer;
 
+        /// The last pass which writes into the swapchain image, null if the result is copied.
+        Filter* _ptr_present_filter = nullptr;
+
         std::vector<vk::SemaphoreHandle>    _image_available_semaphores;
         std::vector<vk::SemaphoreHandle>    _render_finished_semaphores;
-        std::vector<vk::FenceHandle>        _in_flight_fences;
+
+        /// Timeline values of the last submit of each frame in flight.
+        std::vector<uint64_t> _in_flight_values;
+
+        std::deque<RetiredBuild> _retired_builds;
+
+        std::optional<vk::GPUProfiler> _gpu_profiler;
+
+        /// Empty if the scene is rendered at the frame size.
+        std::optional<DynamicResolution> _dynamic_resolution;
 
         RenderContext _render_context;
 
@@ -1,10 +1,9 @@
 #include <backend/renderer/frame_graph/gbuffer_generator.hpp>
-#include <backend/renderer/vulkan/render_pass.hpp>
 #include <backend/renderer/vulkan/shader_compiler.hpp>
 #include <backend/renderer/vulkan/device.hpp>
 #include <backend/renderer/vulkan/gpu_marker_colors.hpp>
 #include <backend/renderer/vulkan/buffer.hpp>
-#include <backend/renderer/vulkan/framebuffer.hpp>
+#include <backend/renderer/vulkan/image.hpp>
 #include <backend/renderer/vulkan/graphics_pipeline.hpp>
 #include <backend/renderer/vulkan/check.hpp>
 #include <backend/scene/mesh_manager.hpp>
@@ -20,43 +19,29 @@
 
 namespace pbrlib::backend
 {
-    struct GBufferDescriptorSetBindings final
-    {
-        enum :
-            uint8_t
-        {
-            ePosUv,
-            eNormalTangent,
-            eMaterialIndices,
-            eDepthBuffer
-        };
-    };
-}
-
-namespace pbrlib::backend
-{
-    GBufferGenerator::GBufferGenerator(vk::Device& device) :
-        RenderPass(device)
+    GBufferGenerator::GBufferGenerator(vk::Device& device, bool depth_pre_pass) :
+        RenderPass      (device),
+        _depth_pre_pass (depth_pre_pass)
     {
         createResultDescriptorSet();
     }
 
     void GBufferGenerator::initResultDescriptorSet()
     {
-        _sampler_handle = device().createNearestSampler();
+        _sampler_handle = device().nearestSampler();
 
-        const auto ptr_pos_uv_image         = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::pos_uv);
+        const auto ptr_uv_image             = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::uv);
         const auto ptr_normal_tangent_image = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent);
         const auto ptr_material_index_image = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index);
 
         constexpr auto expected_image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         device().writeDescriptorSet ({
-            .view_handle            = ptr_pos_uv_image->view_handle,
+            .view_handle            = ptr_uv_image->view_handle,
             .sampler_handle         = _sampler_handle,
             .set_handle             = _result_descriptor_set_handle,
             .expected_image_layout  = expected_image_layout,
-            .binding                = GBufferDescriptorSetBindings::ePosUv
+            .binding                = GBufferDescriptorSetBindings::eUv
         });
 
         device().writeDescriptorSet ({
@@ -99,8 +84,6 @@ namespace pbrlib::backend
             createPipeline();
         });
 
-        createRenderPass();
-
         constexpr VkPushConstantRange push_constant_range =
         {
             .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
@@ -115,7 +98,6 @@ namespace pbrlib::backend
             .addSetLayout(mesh_manager_set_layout)
             .build();
 
-        createFramebuffer();
         initResultDescriptorSet();
 
         return createPipeline();
@@ -125,8 +107,18 @@ namespace pbrlib::backend
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
-        constexpr auto vert_shader = "shaders/gbuffer_generator/gbuffer_generator.glsl.vert";
-        constexpr auto frag_shader = "shaders/gbuffer_generator/gbuffer_generator.glsl.frag";
+        constexpr auto vert_shader          = "shaders/gbuffer_generator/gbuffer_generator.glsl.vert";
+        constexpr auto frag_shader          = "shaders/gbuffer_generator/gbuffer_generator.glsl.frag";
+        constexpr auto depth_vert_shader    = "shaders/gbuffer_generator/depth_pre_pass.glsl.vert";
+
+        /// After the pre-pass the depth buffer already holds the closest surfaces,
+        /// so only fragments with exactly the same depth reach the G-buffer.
+        const auto depth_compare_op = _depth_pre_pass ? vk::CompareOp::eEqual : vk::CompareOp::eLess;
+
+        const auto uv_format        = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::uv)->format;
+        const auto nor_tan_format   = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent)->format;
+        const auto mat_idx_format   = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index)->format;
+        const auto depth_format     = depthStencil()->format;
 
         auto new_pipeline = vk::builders::GraphicsPipeline(device())
             .addStage(vert_shader, VK_SHADER_STAGE_VERTEX_BIT)
@@ -135,11 +127,25 @@ namespace pbrlib::backend
             .addAttachmentsState(false)
             .addAttachmentsState(false)
             .depthStencilTest(true)
+            .depthWrite(!_depth_pre_pass)
+            .depthCompareOp(depth_compare_op)
             .pipelineLayoutHandle(_pipeline_layout_handle)
-            .renderPassHandle(_render_pass_handle)
-            .subpass(0)
+            .addColorAttachmentFormat(uv_format)
+            .addColorAttachmentFormat(nor_tan_format)
+            .addColorAttachmentFormat(mat_idx_format)
+            .depthAttachmentFormat(depth_format)
             .build();
 
+        if (_depth_pre_pass)
+        {
+            _depth_pipeline_handle = vk::builders::GraphicsPipeline(device())
+                .addStage(depth_vert_shader, VK_SHADER_STAGE_VERTEX_BIT)
+                .depthStencilTest(true)
+                .pipelineLayoutHandle(_pipeline_layout_handle)
+                .depthAttachmentFormat(depth_format)
+                .build();
+        }
+
         _pipeline_handle = std::move(new_pipeline);
 
         return true;
@@ -148,103 +154,121 @@ namespace pbrlib::backend
 
 namespace pbrlib::backend
 {
-    void GBufferGenerator::createRenderPass()
+    void GBufferGenerator::beginDepthPass(vk::CommandBuffer& command_buffer)
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
-        const auto* ptr_pos_uv_attach   = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::pos_uv);
-        const auto* ptr_nor_tan_attach  = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent);
-        const auto* ptr_mat_idx_attach  = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index);
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[gbuffer-generator] depth-pre-pass");
 
-        _render_pass_handle = vk::builders::RenderPass(device())
-            .addColorAttachment(ptr_pos_uv_attach, _final_attachments_layout)
-            .addColorAttachment(ptr_nor_tan_attach, _final_attachments_layout)
-            .addColorAttachment(ptr_mat_idx_attach, _final_attachments_layout)
-            .depthAttachment(depthStencil(), VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
-            .build();
-    }
+            const auto [width, height] = renderSize();
 
-    void GBufferGenerator::createFramebuffer()
-    {
-        PBRLIB_PROFILING_ZONE_SCOPED;
+            const VkRect2D area
+            {
+                0,
+                0,
+                width,
+                height
+            };
 
-        const auto ptr_pos_uv_attach    = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::pos_uv);
-        const auto ptr_nor_tan_attach   = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent);
-        const auto ptr_mat_idx_attach   = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index);
+            const VkRenderingAttachmentInfo depth_attachment
+            {
+                .sType          = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                .imageView      = depthStencil()->view_handle,
+                .imageLayout    = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+                .clearValue     = {.depthStencil = {1.0f, 0}}
+            };
 
-        const auto [width, height] = size();
+            const VkRenderingInfo rendering_info
+            {
+                .sType              = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                .renderArea         = area,
+                .layerCount         = 1,
+                .pDepthAttachment   = &depth_attachment
+            };
 
-        _framebuffer_handle = vk::builders::Framebuffer(device())
-            .size(width, height)
-            .layers(1)
-            .renderPass(_render_pass_handle)
-            .addAttachment(*ptr_pos_uv_attach)
-            .addAttachment(*ptr_nor_tan_attach)
-            .addAttachment(*ptr_mat_idx_attach)
-            .addAttachment(*depthStencil())
-            .build();
-    }
-}
+            const VkViewport viewport
+            {
+                .width      = static_cast<float>(width),
+                .height     = static_cast<float>(height),
+                .minDepth   = 0.0f,
+                .maxDepth   = 1.0
+            };
 
-namespace pbrlib::backend
-{
-    void GBufferGenerator::setupColorAttachmentsLayout(vk::CommandBuffer& command_buffer)
-    {
-        colorOutputAttach(AttachmentsTraits<GBufferGenerator>::pos_uv)->changeLayout(command_buffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-        colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent)->changeLayout(command_buffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-        colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index)->changeLayout(command_buffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            const auto [descriptor_set, _] = context().ptr_mesh_manager->descriptorSet();
+
+            vkCmdBeginRendering(command_buffer_handle, &rendering_info);
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _depth_pipeline_handle);
+            vkCmdBindDescriptorSets(command_buffer_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline_layout_handle, 0, 1, &descriptor_set, 0, nullptr);
+            vkCmdSetViewport(command_buffer_handle, 0, 1, &viewport);
+            vkCmdSetScissor(command_buffer_handle, 0, 1, &area);
+        }, "[gbuffer-generator] begin-depth-pass", vk::marker_colors::graphics_pipeline);
     }
 
     void GBufferGenerator::beginPass(vk::CommandBuffer& command_buffer)
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
-        setupColorAttachmentsLayout(command_buffer);
-
-        _push_constant_block.projection_view = context().projection * context().view;
-
         command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
         {
             PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[gbuffer-generator] pre-pass");
 
-            constexpr VkClearValue pos_clear_value
+            if (_depth_pre_pass)
             {
-                .color
+                /// The G-buffer pass tests against the depth written by the pre-pass.
+                constexpr VkMemoryBarrier2 depth_barrier
                 {
-                    .float32 = {0.0f, 0.0f, 0.0f, 1.0f}
-                }
-            };
-
-            constexpr VkClearValue nor_tan_clear_value
-            {
-                .color
+                    .sType          = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                    .srcStageMask   = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    .srcAccessMask  = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    .dstStageMask   = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    .dstAccessMask  = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                };
+
+                const VkDependencyInfo dependency_info
                 {
-                    .float32 = {0.0f, 0.0f, 0.0f, 1.0f}
-                }
-            };
+                    .sType              = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .memoryBarrierCount = 1,
+                    .pMemoryBarriers    = &depth_barrier
+                };
 
-            constexpr VkClearValue material_index_clear_value
+                vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+            }
+
+            const auto color_attachment = [] (const vk::Image* ptr_image, const VkClearColorValue& clear_value)
             {
-                .color
+                return VkRenderingAttachmentInfo
                 {
-                    .float32 = {0.0f, 0.0f, 0.0f, 0.0f}
-                }
+                    .sType          = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                    .imageView      = ptr_image->view_handle,
+                    .imageLayout    = _attachments_layout,
+                    .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                    .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+                    .clearValue     = {.color = clear_value}
+                };
             };
 
-            constexpr VkClearValue depth_clear_value
+            const std::array color_attachments
             {
-                .depthStencil = {1.0f, 0}
+                color_attachment(colorOutputAttach(AttachmentsTraits<GBufferGenerator>::uv), {.float32 = {0.0f, 0.0f, 0.0f, 0.0f}}),
+                color_attachment(colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent), {.float32 = {0.0f, 0.0f, 0.0f, 1.0f}}),
+                color_attachment(colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index), {.float32 = {0.0f, 0.0f, 0.0f, 0.0f}})
             };
 
-            constexpr std::array clear_values
+            const VkRenderingAttachmentInfo depth_attachment
             {
-                pos_clear_value,
-                nor_tan_clear_value,
-                material_index_clear_value,
-                depth_clear_value
+                .sType          = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                .imageView      = depthStencil()->view_handle,
+                .imageLayout    = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                .loadOp         = _depth_pre_pass ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+                .clearValue     = {.depthStencil = {1.0f, 0}}
             };
 
-            const auto [width, height] = size();
+            const auto [width, height] = renderSize();
 
             const VkRect2D area
             {
@@ -254,20 +278,14 @@ namespace pbrlib::backend
                 height
             };
 
-            const VkRenderPassBeginInfo render_pass_begin_info
-            {
-                .sType              = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                .renderPass         = _render_pass_handle,
-                .framebuffer        = _framebuffer_handle,
-                .renderArea         = area,
-                .clearValueCount    = static_cast<uint32_t>(clear_values.size()),
-                .pClearValues       = clear_values.data()
-            };
-
-            constexpr VkSubpassBeginInfo subpass_begin_info
+            const VkRenderingInfo rendering_info
             {
-                .sType      = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO,
-                .contents   = VK_SUBPASS_CONTENTS_INLINE
+                .sType                  = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                .renderArea             = area,
+                .layerCount             = 1,
+                .colorAttachmentCount   = static_cast<uint32_t>(color_attachments.size()),
+                .pColorAttachments      = color_attachments.data(),
+                .pDepthAttachment       = &depth_attachment
             };
 
             const VkViewport viewport
@@ -280,7 +298,7 @@ namespace pbrlib::backend
 
             const auto [descriptor_set, _] = context().ptr_mesh_manager->descriptorSet();
 
-            vkCmdBeginRenderPass2(command_buffer_handle, &render_pass_begin_info, &subpass_begin_info);
+            vkCmdBeginRendering(command_buffer_handle, &rendering_info);
             vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline_handle);
             vkCmdBindDescriptorSets(command_buffer_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline_layout_handle, 0, 1, &descriptor_set, 0, nullptr);
             vkCmdSetViewport(command_buffer_handle, 0, 1, &viewport);
@@ -292,7 +310,23 @@ namespace pbrlib::backend
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
+        _push_constant_block.projection_view = context().projection * context().view;
+
+        if (_depth_pre_pass)
+        {
+            beginDepthPass(command_buffer);
+            drawItems(command_buffer);
+            endPass(command_buffer);
+        }
+
         beginPass(command_buffer);
+        drawItems(command_buffer);
+        endPass(command_buffer);
+    }
+
+    void GBufferGenerator::drawItems(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
 
         for (const auto ptr_item: context().items)
         {
@@ -320,8 +354,6 @@ namespace pbrlib::backend
                 vkCmdDrawIndexed(command_buffer_handle, static_cast<uint32_t>(renderable.index_count), 1, 0, 0, 0);
             }, std::format("[gbuffer-pass] run-pipeline: {}", tag.name), vk::marker_colors::graphics_pipeline);
         }
-
-        endPass(command_buffer);
     }
 
     void GBufferGenerator::endPass(vk::CommandBuffer& command_buffer)
@@ -332,28 +364,14 @@ namespace pbrlib::backend
         {
             PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[gbuffer-generator] post-pass");
 
-            vkCmdEndRenderPass(command_buffer_handle);
+            vkCmdEndRendering(command_buffer_handle);
         }, "[gbuffer-generator] end-pass", vk::marker_colors::graphics_pipeline);
-
-        colorOutputAttach(AttachmentsTraits<GBufferGenerator>::pos_uv)->layout          = _final_attachments_layout;
-        colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent)->layout  = _final_attachments_layout;
-        colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index)->layout  = _final_attachments_layout;
-    }
-
-    VkPipelineStageFlags2 GBufferGenerator::srcStage() const noexcept
-    {
-        return VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
-    }
-
-    VkPipelineStageFlags2 GBufferGenerator::dstStage() const noexcept
-    {
-        return VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
     }
 
     void GBufferGenerator::createResultDescriptorSet()
     {
         _result_descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(device())
-            .addBinding(GBufferDescriptorSetBindings::ePosUv, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eUv, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .addBinding(GBufferDescriptorSetBindings::eNormalTangent, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .addBinding(GBufferDescriptorSetBindings::eMaterialIndices, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .addBinding(GBufferDescriptorSetBindings::eDepthBuffer, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
@@ -370,7 +388,12 @@ namespace pbrlib::backend
     {
         return std::make_pair (
             _result_descriptor_set_handle.handle(),
-            _result_descriptor_set_layout_handle.handle()
+            _result_descriptor_set_layout_handle
         );
     }
+
+    std::string_view GBufferGenerator::name() const noexcept
+    {
+        return "gbuffer-generator";
+    }
 }
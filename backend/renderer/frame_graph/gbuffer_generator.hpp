@@ -25,17 +25,19 @@ namespace pbrlib::backend
             |   VK_IMAGE_USAGE_TRANSFER_DST_BIT
             |   VK_IMAGE_USAGE_STORAGE_BIT;
 
+            /// Position isn't stored, readers reconstruct it from the depth buffer.
+            /// Normal and tangent are octahedral-encoded, 14 bytes per pixel in total.
             constexpr std::array metadata
             {
-                AttachmentMetadata(pos_uv, VK_FORMAT_R32G32B32A32_SFLOAT, usage_flags),
-                AttachmentMetadata(normal_tangent, VK_FORMAT_R32G32B32A32_SFLOAT, usage_flags),
+                AttachmentMetadata(uv, VK_FORMAT_R16G16_UNORM, usage_flags),
+                AttachmentMetadata(normal_tangent, VK_FORMAT_R16G16B16A16_UNORM, usage_flags),
                 AttachmentMetadata(material_index, VK_FORMAT_R16_UINT, usage_flags)
             };
 
             return metadata;
         }
 
-        constexpr static auto pos_uv            = "gbuffer-pos-uv";
+        constexpr static auto uv                = "gbuffer-uv";
         constexpr static auto normal_tangent    = "gbuffer-normal-tangent";
         constexpr static auto material_index    = "gbuffer-material-index";
     };
@@ -43,6 +45,19 @@ namespace pbrlib::backend
 
 namespace pbrlib::backend
 {
+    /// Bindings of the descriptor set with the G-buffer which its readers get.
+    struct GBufferDescriptorSetBindings final
+    {
+        enum :
+            uint8_t
+        {
+            eUv,
+            eNormalTangent,
+            eMaterialIndices,
+            eDepthBuffer
+        };
+    };
+
     struct GBufferPushConstantBlock final
     {
         math::mat4  projection_view;
@@ -60,39 +75,37 @@ namespace pbrlib::backend
 
         bool createPipeline();
 
+        void beginDepthPass(vk::CommandBuffer& command_buffer);
         void beginPass(vk::CommandBuffer& command_buffer);
         void render(vk::CommandBuffer& command_buffer) override;
+        void drawItems(vk::CommandBuffer& command_buffer);
         void endPass(vk::CommandBuffer& command_buffer);
 
-        void createRenderPass();
-        void createFramebuffer();
-
         void initResultDescriptorSet();
 
-        void setupColorAttachmentsLayout(vk::CommandBuffer& command_buffer);
-
-        VkPipelineStageFlags2 srcStage() const noexcept override;
-        VkPipelineStageFlags2 dstStage() const noexcept override;
-
         std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
 
+        std::string_view name() const noexcept override;
+
     public:
-        explicit GBufferGenerator(vk::Device& device);
+        /// With the depth pre-pass only the closest surface of every pixel is shaded.
+        explicit GBufferGenerator(vk::Device& device, bool depth_pre_pass);
 
     private:
-        vk::FramebufferHandle _framebuffer_handle;
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _pipeline_handle;
+        vk::PipelineHandle          _depth_pipeline_handle;
 
-        vk::PipelineLayoutHandle            _pipeline_layout_handle;
-        vk::RenderPassHandle                _render_pass_handle;
-        vk::PipelineHandle                  _pipeline_handle;
+        bool _depth_pre_pass = false;
 
         GBufferPushConstantBlock _push_constant_block;
 
-        vk::DescriptorSetLayoutHandle   _result_descriptor_set_layout_handle;
+        VkDescriptorSetLayout           _result_descriptor_set_layout_handle = VK_NULL_HANDLE;
         vk::DescriptorSetHandle         _result_descriptor_set_handle;
 
-        vk::SamplerHandle _sampler_handle;
+        VkSampler _sampler_handle = VK_NULL_HANDLE;
 
-        static constexpr auto _final_attachments_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        /// Attachments stay in the layout of the rendering, readers declare their own layout.
+        static constexpr auto _attachments_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     };
 }
@@ -1,8 +1,12 @@
 #include <backend/renderer/frame_graph/render_pass.hpp>
 #include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/gpu_profiler.hpp>
 
 #include <backend/logger/logger.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace pbrlib::backend
 {
     RenderPass::RenderPass(vk::Device& device) noexcept :
@@ -15,20 +19,25 @@ namespace pbrlib::backend
 
         _ptr_context = &context;
 
-        _width  = width;
-        _height = height;
+        _width  = (width + _resolution_divisor - 1) / _resolution_divisor;
+        _height = (height + _resolution_divisor - 1) / _resolution_divisor;
 
         return true;
     }
 
-    void RenderPass::addSyncImage (
-        vk::Image*              ptr_image,
-        VkImageLayout           new_layout,
-        VkPipelineStageFlags2   src_stage,
-        VkPipelineStageFlags2   dst_stage
-    )
+    void RenderPass::addImageAccess(vk::Image* ptr_image, const vk::ImageAccess& access)
+    {
+        _image_accesses.emplace_back(ptr_image, access);
+    }
+
+    void RenderPass::discardImage(vk::Image* ptr_image, VkPipelineStageFlags2 src_stage)
+    {
+        _discarded_images[ptr_image] |= src_stage;
+    }
+
+    void RenderPass::forEachSubpass(const std::function<void(RenderPass&)>& visitor)
     {
-        _sync_images.emplace_back(ptr_image, new_layout, src_stage, dst_stage);
+        visitor(*this);
     }
 
     void RenderPass::addColorOutput(std::string_view name, vk::Image* ptr_image)
@@ -50,6 +59,11 @@ namespace pbrlib::backend
         _ptr_depth_stencil_image = ptr_image;
     }
 
+    void RenderPass::resolutionDivisor(uint32_t divisor) noexcept
+    {
+        _resolution_divisor = std::max(divisor, 1u);
+    }
+
     const vk::Image* RenderPass::depthStencil() const noexcept
     {
         return _ptr_depth_stencil_image;
@@ -59,14 +73,39 @@ namespace pbrlib::backend
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
+        auto ptr_gpu_profiler = _ptr_context ? _ptr_context->ptr_gpu_profiler : nullptr;
+
+        if (ptr_gpu_profiler)
+            ptr_gpu_profiler->beginPass(command_buffer, name());
+
         sync(command_buffer);
         render(command_buffer);
+
+        if (ptr_gpu_profiler)
+            ptr_gpu_profiler->endPass(command_buffer);
+    }
+
+    std::string_view RenderPass::name() const noexcept
+    {
+        return "render-pass";
     }
 
     void RenderPass::sync(vk::CommandBuffer& command_buffer)
     {
-        for (auto [ptr_image, new_layout, src_stage, dst_stage]: _sync_images)
-            ptr_image->changeLayout(command_buffer, new_layout, src_stage, dst_stage);
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        for (const auto [ptr_image, src_stage]: _discarded_images)
+            ptr_image->discard(src_stage);
+
+        _barriers.clear();
+
+        for (const auto& [ptr_image, access]: _image_accesses)
+        {
+            if (auto barrier = ptr_image->barrier(access))
+                _barriers.push_back(*barrier);
+        }
+
+        vk::pipelineBarrier(command_buffer, _barriers);
     }
 
     vk::Device& RenderPass::device() noexcept
@@ -84,6 +123,21 @@ namespace pbrlib::backend
         return std::make_pair(_width, _height);
     }
 
+    std::pair<uint32_t, uint32_t> RenderPass::renderSize() const noexcept
+    {
+        const auto scale = _ptr_context ? std::clamp(_ptr_context->render_scale, 0.0f, 1.0f) : 1.0f;
+
+        if (scale == 1.0f) [[likely]]
+            return size();
+
+        const auto scaled = [scale] (uint32_t size)
+        {
+            return std::max(static_cast<uint32_t>(std::ceil(static_cast<float>(size) * scale)), 1u);
+        };
+
+        return std::make_pair(scaled(_width), scaled(_height));
+    }
+
     void RenderPass::descriptorSet(uint32_t set_id, VkDescriptorSet set_handle, VkDescriptorSetLayout set_layout)
     {
         _input_descriptor_sets.emplace(set_id, std::make_pair(set_handle, set_layout));
@@ -2,12 +2,12 @@
 
 #include <pbrlib/math/matrix4x4.hpp>
 
-#include <vulkan/vulkan.h>
+#include <backend/renderer/vulkan/image_access.hpp>
 
 #include <map>
 #include <span>
 #include <vector>
-#include <tuple>
+#include <unordered_map>
 
 #include <string>
 #include <string_view>
@@ -30,6 +30,7 @@ namespace pbrlib::backend::vk
     class Device;
     class Image;
     class CommandBuffer;
+    class GPUProfiler;
 }
 
 namespace pbrlib::backend
@@ -43,6 +44,9 @@ namespace pbrlib::backend
         std::string_view    name;
         VkFormat            format  = VK_FORMAT_UNDEFINED;
         VkImageUsageFlags   usage   = VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM;
+
+        /// The attachment follows the resolution divisor of its pass instead of the frame size.
+        bool is_scaled = false;
     };
 
     template <typename RenderPass>
@@ -68,16 +72,20 @@ namespace pbrlib::backend
         const MaterialManager*  ptr_material_manager    = nullptr;
         const MeshManager*      ptr_mesh_manager        = nullptr;
 
+        /// Null if the passes aren't measured.
+        vk::GPUProfiler* ptr_gpu_profiler = nullptr;
+
+        /// Fraction of the frame size which is rendered this frame. The images keep the full size,
+        /// the passes only write their top-left rectangle.
+        float render_scale = 1.0f;
+
         uint8_t flight_frame_index = std::numeric_limits<uint8_t>::max() - 1;
     };
 
     class RenderPass
     {
-        using SyncData = std::tuple <
-            vk::Image*,
-            VkImageLayout,
-            VkPipelineStageFlags2,
-            VkPipelineStageFlags2
+        using ImageAccesses = std::vector <
+            std::pair<vk::Image*, vk::ImageAccess>
         >;
 
         using ColorOutputImages = std::map <
@@ -108,20 +116,27 @@ namespace pbrlib::backend
 
         virtual void draw(vk::CommandBuffer& command_buffer);
 
-        [[nodiscard]] virtual VkPipelineStageFlags2 srcStage() const noexcept = 0;
-        [[nodiscard]] virtual VkPipelineStageFlags2 dstStage() const noexcept = 0;
+        /// Identifies the pass in the GPU timings.
+        [[nodiscard]] virtual std::string_view name() const noexcept;
 
         void addColorOutput(std::string_view name, vk::Image* ptr_image);
 
-        void addSyncImage (
-            vk::Image*              ptr_image,
-            VkImageLayout           new_layout,
-            VkPipelineStageFlags2   src_stage,
-            VkPipelineStageFlags2   dst_stage
-        );
+        /// Declares how the pass uses the image. Barriers are derived from the accesses
+        /// and recorded in one batch before the pass.
+        void addImageAccess(vk::Image* ptr_image, const vk::ImageAccess& access);
+
+        /// The memory of the image is shared with other transient images. Before the pass
+        /// its content is discarded and the barrier of the image also waits for src_stage.
+        void discardImage(vk::Image* ptr_image, VkPipelineStageFlags2 src_stage);
+
+        /// Calls the visitor for every pass which records commands, in the order of execution.
+        virtual void forEachSubpass(const std::function<void(RenderPass&)>& visitor);
 
         void depthStencil(const vk::Image* ptr_image);
 
+        /// The pass runs at the frame size divided by the divisor, rounded up.
+        void resolutionDivisor(uint32_t divisor) noexcept;
+
         [[nodiscard]] vk::Image*        colorOutputAttach(std::string_view name);
         [[nodiscard]] const vk::Image*  depthStencil() const noexcept;
 
@@ -130,6 +145,9 @@ namespace pbrlib::backend
 
         [[nodiscard]] std::pair<uint32_t, uint32_t> size() const noexcept;
 
+        /// The size scaled by the render scale of the frame, rounded up.
+        [[nodiscard]] virtual std::pair<uint32_t, uint32_t> renderSize() const noexcept;
+
         void descriptorSet(uint32_t set_id, VkDescriptorSet set_handle, VkDescriptorSetLayout set_layout);
 
         [[nodiscard]]
@@ -144,7 +162,11 @@ namespace pbrlib::backend
     private:
         ColorOutputImages _color_output_images;
 
-        std::vector<SyncData> _sync_images;
+        ImageAccesses _image_accesses;
+
+        std::vector<VkImageMemoryBarrier2> _barriers;
+
+        std::unordered_map<vk::Image*, VkPipelineStageFlags2> _discarded_images;
 
         const vk::Image* _ptr_depth_stencil_image = nullptr;
 
@@ -154,6 +176,8 @@ namespace pbrlib::backend
         uint32_t _width     = 0;
         uint32_t _height    = 0;
 
+        uint32_t _resolution_divisor = 1;
+
         InputDescriptorSets _input_descriptor_sets;
     };
 }
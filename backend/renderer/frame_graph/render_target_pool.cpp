@@ -0,0 +1,63 @@
+#include <backend/renderer/frame_graph/render_target_pool.hpp>
+
+#include <backend/renderer/vulkan/device.hpp>
+
+#include <backend/profiling.hpp>
+
+#include <algorithm>
+
+namespace pbrlib::backend
+{
+    RenderTargetPool::RenderTargetPool(vk::Device& device) noexcept :
+        _device (device)
+    { }
+
+    vk::Image RenderTargetPool::acquire(const RenderTargetDescription& description, std::string_view name)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto completed_value = _device.completedValue();
+
+        const auto it = std::ranges::find_if(_entries, [&description, completed_value] (const Entry& entry)
+        {
+            return entry.description == description && entry.release_value <= completed_value;
+        });
+
+        if (it != std::end(_entries))
+        {
+            auto image = std::move(it->image);
+            _entries.erase(it);
+
+            return image;
+        }
+
+        return vk::builders::Image(_device)
+            .size(description.width, description.height)
+            .format(description.format)
+            .usage(description.usage)
+            .sampleCount(description.samples)
+            .addQueueFamilyIndex(_device.queue().family_index)
+            .name(name)
+            .build();
+    }
+
+    void RenderTargetPool::release(const RenderTargetDescription& description, vk::Image&& image, uint64_t release_value)
+    {
+        _entries.emplace_back(description, std::move(image), release_value);
+    }
+
+    void RenderTargetPool::trim(uint32_t max_idle_builds)
+    {
+        const auto completed_value = _device.completedValue();
+
+        std::erase_if(_entries, [max_idle_builds, completed_value] (Entry& entry)
+        {
+            return ++entry.idle_builds > max_idle_builds && entry.release_value <= completed_value;
+        });
+    }
+
+    size_t RenderTargetPool::size() const noexcept
+    {
+        return _entries.size();
+    }
+}
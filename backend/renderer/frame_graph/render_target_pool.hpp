@@ -0,0 +1,67 @@
+#pragma once
+
+#include <backend/renderer/vulkan/image.hpp>
+
+#include <vector>
+
+#include <string_view>
+
+namespace pbrlib::backend::vk
+{
+    class Device;
+}
+
+namespace pbrlib::backend
+{
+    struct RenderTargetDescription final
+    {
+        VkFormat                format  = VK_FORMAT_UNDEFINED;
+        uint32_t                width   = 0;
+        uint32_t                height  = 0;
+        VkImageUsageFlags       usage   = 0;
+        VkSampleCountFlagBits   samples = VK_SAMPLE_COUNT_1_BIT;
+
+        [[nodiscard]] bool operator == (const RenderTargetDescription& description) const noexcept = default;
+    };
+
+    /// Dedicated render targets which outlive a build of the frame graph. A released image is
+    /// handed out again to a compatible request once the GPU has completed the frames which used it.
+    class RenderTargetPool final
+    {
+        struct Entry final
+        {
+            RenderTargetDescription description;
+            vk::Image               image;
+
+            /// Timeline value of the general queue after which the image is free.
+            uint64_t release_value = 0;
+
+            /// Builds of the frame graph since the image was released.
+            uint32_t idle_builds = 0;
+        };
+
+    public:
+        explicit RenderTargetPool(vk::Device& device) noexcept;
+
+        RenderTargetPool(RenderTargetPool&& pool)        = delete;
+        RenderTargetPool(const RenderTargetPool& pool)   = delete;
+
+        RenderTargetPool& operator = (RenderTargetPool&& pool)       = delete;
+        RenderTargetPool& operator = (const RenderTargetPool& pool)  = delete;
+
+        /// Reuses a free image with the same description, otherwise creates a new one.
+        [[nodiscard]] vk::Image acquire(const RenderTargetDescription& description, std::string_view name);
+
+        void release(const RenderTargetDescription& description, vk::Image&& image, uint64_t release_value);
+
+        /// Called after a build, frees the free images which no build has reused for max_idle_builds builds.
+        void trim(uint32_t max_idle_builds = 2);
+
+        [[nodiscard]] size_t size() const noexcept;
+
+    private:
+        vk::Device& _device;
+
+        std::vector<Entry> _entries;
+    };
+}
@@ -14,24 +14,49 @@
 
 #include <backend/renderer/vulkan/check.hpp>
 
+#include <backend/utils/align_size.hpp>
+#include <backend/utils/blue_noise.hpp>
+
 #include <pbrlib/math/vec3.hpp>
 #include <pbrlib/math/vec4.hpp>
 #include <pbrlib/math/lerp.hpp>
 
 #include <pbrlib/config.hpp>
+#include <pbrlib/transforms.hpp>
 
 #include <pbrlib/event_system.hpp>
 #include <backend/events.hpp>
 
+#include <algorithm>
+#include <random>
+
 namespace pbrlib::backend
 {
-    SSAO::SSAO(vk::Device& device, BilateralBlur* ptr_blur) :
-        RenderPass  (device),
-        _ptr_blur   (ptr_blur)
+    /// The shaders derive uv from the full image size, while only the top-left rectangle
+    /// of the G-buffer is rendered. Remaps ndc so that uv of the projection lands in that rectangle.
+    math::mat4 scaledProjection(const math::mat4& projection, float render_scale) noexcept
     {
-        if (!ptr_blur) [[unlikely]]
-            throw exception::InvalidArgument("[ssao] pointer to blur is null");
+        if (render_scale == 1.0f) [[likely]]
+            return projection;
+
+        const auto offset = render_scale - 1.0f;
+
+        return
+            pbrlib::transforms::translate(math::vec3(offset, offset, 0.0f))
+        *   pbrlib::transforms::scale(math::vec3(render_scale, render_scale, 1.0f))
+        *   projection;
+    }
+}
 
+namespace pbrlib::backend
+{
+    SSAO::SSAO(vk::Device& device, BilateralBlur* ptr_blur, const pbrlib::settings::SSAO& settings) :
+        RenderPass      (device),
+        _sample_count   (settings.sample_count),
+        _ptr_blur       (ptr_blur),
+        _temporal       (settings.temporal_accumulation),
+        _algorithm      (settings.algorithm)
+    {
         _result_image_desc_set_layout = vk::builders::DescriptorSetLayout(device)
             .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .build();
@@ -56,27 +81,50 @@ namespace pbrlib::backend
         {
             PBRLIB_PROFILING_ZONE_SCOPED;
 
-            auto& blur_settings = _ptr_blur->settings();
-            auto& ssao_settings = settings.settings;
+            const auto& ssao_settings = settings.settings;
+
+            if (_ptr_blur)
+            {
+                auto& blur_settings = _ptr_blur->settings();
+
+                blur_settings.sample_count  = ssao_settings.blur_samples_count;
+                blur_settings.sigma_s       = ssao_settings.spatial_sigma;
+                blur_settings.sigma_l       = ssao_settings.luminance_sigma;
 
-            blur_settings.sample_count  = ssao_settings.blur_samples_count;
-            blur_settings.sigma_s       = ssao_settings.spatial_sigma;
-            blur_settings.sigma_l       = ssao_settings.luminance_sigma;
+                _ptr_blur->kernel(ssao_settings.blur_kernel);
+            }
+
+            const auto sample_count = _params.sample_count;
 
-            if (_params.radius != ssao_settings.radius)
+            writeKernel(ssao_settings.sample_count);
+
+            if (_params.radius != ssao_settings.radius || _params.sample_count != sample_count)
             {
                 _params.radius = ssao_settings.radius;
                 _params_buffer->write(_params, 0);
             }
+
+            if (_algorithm != ssao_settings.algorithm)
+            {
+                _algorithm = ssao_settings.algorithm;
+                createPipeline();
+            }
         });
 
-        on([this] (const events::RecompilePipeline& event)
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& event)
         {
-            createPipeline(event.width, event.height);
+            createPipeline();
         });
 
+        if (device().limits().maxPushConstantsSize < sizeof(PushConstantBlock)) [[unlikely]]
+        {
+            log::error("[ssao] push constants size {} exceeds the limit", sizeof(PushConstantBlock));
+            return false;
+        }
+
         createSamplesBuffer();
         createParamsBuffer();
+        createBlueNoiseImage();
 
         bindResultDescriptorSet();
         createSSAODescriptorSet();
@@ -88,7 +136,7 @@ namespace pbrlib::backend
         {
             .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
             .offset     = 0,
-            .size       = 2 * sizeof(pbrlib::math::mat4)
+            .size       = sizeof(PushConstantBlock)
         };
 
         _pipeline_layout_handle = vk::builders::PipelineLayout(device())
@@ -98,17 +146,11 @@ namespace pbrlib::backend
             .pushConstant(push_constant_range)
             .build();
 
-        return createPipeline(width, height);
+        return createPipeline();
     }
 
-    bool SSAO::createPipeline(uint32_t width, uint32_t height)
+    bool SSAO::createPipeline()
     {
-        constexpr auto noise_width  = 4.0f;
-        constexpr auto noise_height = 4.0f;
-
-        _params.noise_scale.x = static_cast<float>(width) / noise_width;
-        _params.noise_scale.y = static_cast<float>(height) / noise_height;
-
         device().writeDescriptorSet ({
             .buffer     = _params_buffer.value(),
             .set_handle = _ssao_desc_set,
@@ -116,10 +158,13 @@ namespace pbrlib::backend
             .binding    = 1
         });
 
-        constexpr auto ssao_shader = "shaders/ssao/ssao.glsl.comp";
+        /// Both algorithms share the descriptor sets and the push constants.
+        const auto shader = _algorithm == settings::AOAlgorithm::eGTAO ?
+            "shaders/ssao/gtao.glsl.comp" :
+            "shaders/ssao/ssao.glsl.comp";
 
         auto new_pipeline = vk::builders::ComputePipeline(device())
-            .shader(ssao_shader)
+            .shader(shader)
             .pipelineLayoutHandle(_pipeline_layout_handle)
             .build();
 
@@ -153,46 +198,44 @@ namespace pbrlib::backend
                 0, nullptr
             );
 
-            const std::array matrices
+            const PushConstantBlock push_constant_block
             {
-                context().projection,
-                context().view
+                .projection     = scaledProjection(context().projection, context().render_scale),
+                .view           = context().view,
+                .frame_index    = _temporal ? _frame_index++ : 0
             };
 
             vkCmdPushConstants (
                 command_buffer_handle,
                 _pipeline_layout_handle,
                 VK_SHADER_STAGE_COMPUTE_BIT,
-                0, static_cast<uint32_t>(sizeof(pbrlib::math::mat4) * matrices.size()), matrices.data()
+                0, static_cast<uint32_t>(sizeof(PushConstantBlock)), &push_constant_block
             );
 
-            const auto [width, height] = size();
+            const auto [width, height] = renderSize();
 
-            const auto local_size_x = width / device().workGroupSize();
-            const auto local_size_y = height / device().workGroupSize();
+            const auto work_group_size = static_cast<uint32_t>(device().workGroupSize());
+
+            const auto local_size_x = utils::alignSize(width, work_group_size) / work_group_size;
+            const auto local_size_y = utils::alignSize(height, work_group_size) / work_group_size;
 
             vkCmdDispatch(command_buffer_handle, local_size_x, local_size_y, 1);
         }, "[ssao] run-pipeline", vk::marker_colors::compute_pipeline);
     }
 
-    VkPipelineStageFlags2 SSAO::srcStage() const noexcept
-    {
-        return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-    }
-
-    VkPipelineStageFlags2 SSAO::dstStage() const noexcept
+    std::pair<VkDescriptorSet, VkDescriptorSetLayout> SSAO::resultDescriptorSet() const noexcept
     {
-        return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        return std::make_pair(_result_image_desc_set.handle(), _result_image_desc_set_layout);
     }
 
-    std::pair<VkDescriptorSet, VkDescriptorSetLayout> SSAO::resultDescriptorSet() const noexcept
+    std::string_view SSAO::name() const noexcept
     {
-        return std::make_pair(_result_image_desc_set.handle(), _result_image_desc_set_layout.handle());
+        return "ssao";
     }
 
     void SSAO::bindResultDescriptorSet()
     {
-        _result_image_sampler = device().createNearestSampler();
+        _result_image_sampler = device().nearestSampler();
 
         const auto ptr_result_image = colorOutputAttach(AttachmentsTraits<SSAO>::ssao);
 
@@ -211,6 +254,7 @@ namespace pbrlib::backend
             .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .addBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .addBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
             .build();
 
         _ssao_desc_set = device().allocateDescriptorSet(_ssao_desc_set_layout, "[ssao] descritor-set-with-data-for-compute");
@@ -230,6 +274,14 @@ namespace pbrlib::backend
             .size       = static_cast<uint32_t>(_samples_buffer->size),
             .binding    = 2
         });
+
+        device().writeDescriptorSet ({
+            .view_handle            = _blue_noise_image->view_handle,
+            .sampler_handle         = _result_image_sampler,
+            .set_handle             = _ssao_desc_set,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .binding                = 3
+        });
     }
 
     void SSAO::createParamsBuffer()
@@ -245,86 +297,81 @@ namespace pbrlib::backend
         _params_buffer->write(_params, 0);
     }
 
-    void SSAO::createSamplesBuffer()
+    const std::vector<pbrlib::math::vec4>& SSAO::kernel(uint32_t sample_count)
     {
-        constexpr std::array samples
+        if (const auto it = _kernels.find(sample_count); it != std::end(_kernels))
+            return it->second;
+
+        /// Fixed seed, the kernel for a count must be the same between runs.
+        std::mt19937                            generator (sample_count);
+        std::uniform_real_distribution<float>   distribution (0.0f, 1.0f);
+
+        std::vector<pbrlib::math::vec4> samples (sample_count);
+
+        for (uint32_t i = 0; i < sample_count; ++i)
         {
-            pbrlib::math::vec4(0.62944734f, -0.7290461f, 0.9057919f, 0.0f),
-            pbrlib::math::vec4(0.6700171f, -0.7460264f, 0.9688677f, 0.0f),
-            pbrlib::math::vec4(0.8267517f, -0.557932f, 0.6323592f, 0.0f),
-            pbrlib::math::vec4(-0.38366592f, -0.80491924f, 0.5472206f, 0.0f),
-            pbrlib::math::vec4(-0.44300365f, -0.62323606f, 0.5468815f, 0.0f),
-            pbrlib::math::vec4(0.9857626f, 0.91501355f, 0.9964613f, 0.0f),
-            pbrlib::math::vec4(0.929777f, 0.93538976f, 0.15761304f, 0.0f),
-            pbrlib::math::vec4(0.45167792f, 0.9411855f, 0.9811097f, 0.0f),
-            pbrlib::math::vec4(0.9143338f, -0.78027654f, 0.48537564f, 0.0f),
-            pbrlib::math::vec4(0.5962117f, 0.6005609f, 0.29702944f, 0.0f),
-            pbrlib::math::vec4(-0.7162274f, -0.9904331f, 0.42176127f, 0.0f),
-            pbrlib::math::vec4(-0.775071f, 0.83147097f, 0.63976336f, 0.0f),
-            pbrlib::math::vec4(0.5844146f, 0.7568612f, 0.9594924f, 0.0f),
-            pbrlib::math::vec4(0.0073252916f, 0.31148136f, 0.7979286f, 0.0f),
-            pbrlib::math::vec4(-0.9285767f, -0.27741206f, 0.84912926f, 0.0f),
-            pbrlib::math::vec4(-0.5761514f, 0.86798644f, 0.6813595f, 0.0f),
-            pbrlib::math::vec4(0.35747027f, -0.202523f, 0.7577401f, 0.0f),
-            pbrlib::math::vec4(0.4812944f, 0.48626482f, 0.47475863f, 0.0f),
-            pbrlib::math::vec4(-0.21554601f, -0.15582466f, 0.6554779f, 0.0f),
-            pbrlib::math::vec4(-0.6522697f, -0.6576266f, 0.30191308f, 0.0f),
-            pbrlib::math::vec4(0.4120921f, 0.5945598f, 0.031832814f, 0.0f),
-            pbrlib::math::vec4(-0.36689913f, -0.44615412f, 0.8724288f, 0.0f),
-            pbrlib::math::vec4(-0.90765727f, -0.7017721f, 0.09713173f, 0.0f),
-            pbrlib::math::vec4(0.9881369f, 0.64691556f, 0.8219032f, 0.0f),
-            pbrlib::math::vec4(0.38965714f, -0.7496345f, 0.31709945f, 0.0f),
-            pbrlib::math::vec4(0.5274999f, 0.90044403f, 0.49058902f, 0.0f),
-            pbrlib::math::vec4(-0.9311079f, 0.32721102f, 0.4387443f, 0.0f),
-            pbrlib::math::vec4(-0.74820673f, -0.23688316f, 0.21020907f, 0.0f),
-            pbrlib::math::vec4(0.5310335f, -0.89756715f, 0.7951999f, 0.0f),
-            pbrlib::math::vec4(-0.9271176f, -0.6262548f, 0.4087311f, 0.0f),
-            pbrlib::math::vec4(-0.020471215f, -0.08402181f, 0.44558614f, 0.0f),
-            pbrlib::math::vec4(-0.02486217f, 0.2926259f, 0.79397494f, 0.0f),
-            pbrlib::math::vec4(0.41872954f, 0.84174955f, 0.75468665f, 0.0f),
-            pbrlib::math::vec4(0.615062f, -0.4479499f, 0.70577425f, 0.0f),
-            pbrlib::math::vec4(0.35940528f, -0.9943632f, 0.65509796f, 0.0f),
-            pbrlib::math::vec4(0.4214077f, -0.67477655f, 0.64396095f, 0.0f),
-            pbrlib::math::vec4(-0.76200473f, -0.087934375f, 0.49836403f, 0.0f),
-            pbrlib::math::vec4(0.54783416f, 0.91948783f, 0.5737546f, 0.0f),
-            pbrlib::math::vec4(-0.31922865f, 0.75351477f, 0.5852677f, 0.0f),
-            pbrlib::math::vec4(0.6163509f, -0.55237615f, 0.017773867f, 0.0f),
-            pbrlib::math::vec4(0.50253403f, 0.64249194f, 0.25509506f, 0.0f),
-            pbrlib::math::vec4(0.64168155f, 0.011914015f, 0.940074f, 0.0f),
-            pbrlib::math::vec4(0.39815342f, -0.174667f, 0.89090323f, 0.0f),
-            pbrlib::math::vec4(-0.15366983f, 0.9185828f, 0.58095664f, 0.0f),
-            pbrlib::math::vec4(0.09443104f, -0.68388486f, 0.13862443f, 0.0f),
-            pbrlib::math::vec4(0.5234624f, -0.7014121f, 0.23015606f, 0.0f),
-            pbrlib::math::vec4(-0.48498356f, 0.61946905f, 0.8407172f, 0.0f),
-            pbrlib::math::vec4(0.97704315f, -0.49143565f, 0.33244824f, 0.0f),
-            pbrlib::math::vec4(0.6285696f, -0.40033662f, 0.24352497f, 0.0f),
-            pbrlib::math::vec4(-0.97292185f, 0.8585272f, 0.21723783f, 0.0f),
-            pbrlib::math::vec4(-0.3000325f, 0.81472933f, 0.19659519f, 0.0f),
-            pbrlib::math::vec4(0.69693553f, -0.4978323f, 0.95501757f, 0.0f),
-            pbrlib::math::vec4(0.23208928f, 0.5577954f, 0.47328883f, 0.0f),
-            pbrlib::math::vec4(0.9749192f, -0.29668105f, 0.06759536f, 0.0f),
-            pbrlib::math::vec4(0.6616572f, 0.58719516f, 0.5852641f, 0.0f),
-            pbrlib::math::vec4(0.18900704f, 0.09944713f, 0.7327987f, 0.0f),
-            pbrlib::math::vec4(0.8343873f, 0.39046574f, 0.28583896f, 0.0f),
-            pbrlib::math::vec4(0.35963953f, 0.51440036f, 0.39232045f, 0.0f),
-            pbrlib::math::vec4(0.5074581f, 0.123114824f, 0.38044584f, 0.0f),
-            pbrlib::math::vec4(-0.583864f, 0.13564324f, 0.5273714f, 0.0f),
-            pbrlib::math::vec4(-0.8482915f, -0.19158304f, 0.05395007f, 0.0f),
-            pbrlib::math::vec4(-0.2944752f, 0.061595082f, 0.59282386f, 0.0f),
-            pbrlib::math::vec4(0.55833435f, -0.28730977f, 0.9340106f, 0.0f),
-            pbrlib::math::vec4(0.9299327f, -0.74018764f, 0.15443838f, 0.0f)
-        };
+            auto sample = pbrlib::math::normalize(pbrlib::math::vec3 (
+                distribution(generator) * 2.0f - 1.0f,
+                distribution(generator) * 2.0f - 1.0f,
+                distribution(generator)
+            ));
+
+            /// More samples close to the origin of the hemisphere.
+            const auto t        = static_cast<float>(i) / static_cast<float>(sample_count);
+            const auto scale    = pbrlib::math::lerp(0.1f, 1.0f, t * t);
+
+            sample *= distribution(generator) * scale;
+
+            samples[i] = pbrlib::math::vec4(sample.x, sample.y, sample.z, 0.0f);
+        }
+
+        return _kernels.emplace(sample_count, std::move(samples)).first->second;
+    }
 
+    void SSAO::writeKernel(uint32_t sample_count)
+    {
+        sample_count = std::clamp(sample_count, min_sample_count, max_sample_count);
+
+        if (_params.sample_count == sample_count)
+            return ;
+
+        _samples_buffer->write(std::span<const pbrlib::math::vec4>(kernel(sample_count)), 0);
+
+        _params.sample_count = sample_count;
+    }
+
+    void SSAO::createSamplesBuffer()
+    {
         _samples_buffer = vk::builders::Buffer(device())
             .addQueueFamilyIndex(device().queue().family_index)
             .name("[ssao] samples")
-            .size(samples.size() * sizeof(pbrlib::math::vec4))
+            .size(max_sample_count * sizeof(pbrlib::math::vec4))
             .type(vk::BufferType::eDeviceOnly)
             .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
             .build();
 
-        _samples_buffer->write(std::span<const pbrlib::math::vec4>(samples), 0);
+        writeKernel(_sample_count);
+    }
+
+    void SSAO::createBlueNoiseImage()
+    {
+        auto noise = utils::generateBlueNoise(blue_noise_size);
+
+        _blue_noise_image = vk::builders::Image(device())
+            .addQueueFamilyIndex(device().queue().family_index)
+            .name("[ssao] blue noise")
+            .size(blue_noise_size, blue_noise_size)
+            .format(VK_FORMAT_R8_UNORM)
+            .usage(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+            .build();
+
+        _blue_noise_image->write ({
+            .ptr_data   = noise.data(),
+            .width      = static_cast<int>(blue_noise_size),
+            .height     = static_cast<int>(blue_noise_size),
+            .format     = VK_FORMAT_R8_UNORM
+        });
 
-        _params.sample_count = static_cast<uint32_t>(samples.size());
+        _blue_noise_image->changeLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
 }
@@ -2,15 +2,19 @@
 
 #include <backend/renderer/vulkan/pipeline_layout.hpp>
 #include <backend/renderer/vulkan/buffer.hpp>
+#include <backend/renderer/vulkan/image.hpp>
 #include <backend/renderer/vulkan/unique_handler.hpp>
 #include <backend/renderer/frame_graph/render_pass.hpp>
 
-#include <pbrlib/math/vec2.hpp>
+#include <pbrlib/math/vec4.hpp>
 #include <pbrlib/math/matrix4x4.hpp>
 #include <pbrlib/event_system.hpp>
+#include <pbrlib/config.hpp>
 
 #include <optional>
 #include <array>
+#include <vector>
+#include <map>
 
 namespace pbrlib::backend
 {
@@ -35,8 +39,9 @@ namespace pbrlib::backend
 
             constexpr std::array metadata
             {
-                AttachmentMetadata(ssao, VK_FORMAT_R16_SFLOAT, usage_flags),
-                AttachmentMetadata(blur, VK_FORMAT_R16_SFLOAT, usage_flags)
+                AttachmentMetadata(ssao, VK_FORMAT_R16_SFLOAT, usage_flags, true),
+                AttachmentMetadata(blur, VK_FORMAT_R16_SFLOAT, usage_flags),
+                AttachmentMetadata(blur_intermediate, VK_FORMAT_R16_SFLOAT, usage_flags, true)
             };
 
             return metadata;
@@ -44,6 +49,9 @@ namespace pbrlib::backend
 
         constexpr static auto ssao = "ssao-result";
         constexpr static auto blur = "ssao-blur";
+
+        /// Result of the horizontal pass of the separable blur.
+        constexpr static auto blur_intermediate = "ssao-blur-intermediate";
     };
 
     template<>
@@ -63,40 +71,56 @@ namespace pbrlib::backend
         {
             float               radius          = 0.05f;
             uint32_t            sample_count    = 0;
-            pbrlib::math::vec2  noise_scale;
+        };
+
+        struct PushConstantBlock final
+        {
+            pbrlib::math::mat4  projection;
+            pbrlib::math::mat4  view;
+            uint32_t            frame_index = 0;
         };
 
         bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
 
-        bool createPipeline(uint32_t width, uint32_t height);
+        bool createPipeline();
 
         void render(vk::CommandBuffer& command_buffer) override;
 
-        VkPipelineStageFlags2 srcStage() const noexcept override;
-        VkPipelineStageFlags2 dstStage() const noexcept override;
-
         std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
 
+        std::string_view name() const noexcept override;
+
         void bindResultDescriptorSet();
 
         void createSSAODescriptorSet();
 
         void createParamsBuffer();
         void createSamplesBuffer();
+        void createBlueNoiseImage();
+
+        /// Hemisphere kernel, generated once for every sample count.
+        [[nodiscard]] const std::vector<pbrlib::math::vec4>& kernel(uint32_t sample_count);
+
+        void writeKernel(uint32_t sample_count);
 
     public:
-        explicit SSAO(vk::Device& device, BilateralBlur* ptr_blur);
+        static constexpr uint32_t min_sample_count = 4;
+        static constexpr uint32_t max_sample_count = 64;
+
+        /// The blur may be null when it's skipped. With the temporal accumulation the kernel
+        /// is rotated every frame, so that the history gathers different samples.
+        explicit SSAO(vk::Device& device, BilateralBlur* ptr_blur, const pbrlib::settings::SSAO& settings);
 
     private:
-        vk::PipelineLayoutHandle    _pipeline_layout_handle;
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
         vk::PipelineHandle          _pipeline_handle;
 
-        vk::DescriptorSetLayoutHandle   _result_image_desc_set_layout;
+        VkDescriptorSetLayout           _result_image_desc_set_layout = VK_NULL_HANDLE;
         vk::DescriptorSetHandle         _result_image_desc_set;
 
-        vk::SamplerHandle _result_image_sampler;
+        VkSampler _result_image_sampler = VK_NULL_HANDLE;
 
-        vk::DescriptorSetLayoutHandle   _ssao_desc_set_layout;
+        VkDescriptorSetLayout           _ssao_desc_set_layout = VK_NULL_HANDLE;
         vk::DescriptorSetHandle         _ssao_desc_set;
 
         Params                      _params;
@@ -104,8 +128,21 @@ namespace pbrlib::backend
 
         std::optional<vk::Buffer> _samples_buffer;
 
+        uint32_t                                            _sample_count;
+        std::map<uint32_t, std::vector<pbrlib::math::vec4>> _kernels;
+
+        /// Rotates the kernel around the normal, tiled over the screen.
+        std::optional<vk::Image> _blue_noise_image;
+
         BilateralBlur* _ptr_blur = nullptr;
 
+        bool        _temporal       = false;
+        uint32_t    _frame_index    = 0;
+
+        settings::AOAlgorithm _algorithm = settings::AOAlgorithm::eSSAO;
+
         static constexpr auto final_attachments_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        static constexpr uint32_t blue_noise_size = 32;
     };
 }
@@ -0,0 +1,378 @@
+#include <backend/renderer/frame_graph/transient_images.hpp>
+
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+
+#include <backend/utils/align_size.hpp>
+
+#include <backend/logger/logger.hpp>
+#include <backend/profiling.hpp>
+
+#include <pbrlib/exceptions.hpp>
+
+#include <algorithm>
+#include <ranges>
+
+namespace pbrlib::backend
+{
+    bool ImageLifetime::overlaps(const ImageLifetime& lifetime) const noexcept
+    {
+        return first_pass <= lifetime.last_pass && lifetime.first_pass <= last_pass;
+    }
+}
+
+namespace pbrlib::backend
+{
+    TransientImages::TransientImages(vk::Device& device) noexcept :
+        _device (device)
+    { }
+
+    TransientImages& TransientImages::addImage(std::string_view name, VkFormat format, VkImageUsageFlags usage, uint32_t divisor)
+    {
+        _descriptions.emplace_back(std::string(name), format, usage, std::max(divisor, 1u));
+        return *this;
+    }
+
+    TransientImages& TransientImages::addPass(const PassAttachments& pass)
+    {
+        _passes.push_back(pass);
+        return *this;
+    }
+
+    TransientImages& TransientImages::aliasing(bool is_enabled) noexcept
+    {
+        _aliasing = is_enabled;
+        return *this;
+    }
+
+    TransientImages& TransientImages::pool(RenderTargetPool* ptr_pool) noexcept
+    {
+        _ptr_pool = ptr_pool;
+        return *this;
+    }
+
+    void TransientImages::build(uint32_t width, uint32_t height, Images& images)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        _width  = width;
+        _height = height;
+
+        _slots.clear();
+        _discards.clear();
+
+        computeLifetimes();
+        placeImages(width, height);
+        collectDiscards();
+
+        for (const auto& slot: _slots)
+        {
+            for (const auto image_index: slot.images)
+            {
+                const auto& description = _descriptions[image_index];
+
+                vk::builders::Image builder (_device);
+
+                images.emplace (
+                    description.name,
+                    setup(builder, description, width, height)
+                        .aliasMemory(_allocation_handle.handle(), slot.offset)
+                        .build()
+                );
+            }
+        }
+
+        for (const auto image_index: std::views::iota(0u, _descriptions.size()))
+        {
+            if (_lifetimes[image_index].is_transient)
+                continue;
+
+            const auto& description = _descriptions[image_index];
+
+            if (_ptr_pool)
+            {
+                images.emplace(description.name, _ptr_pool->acquire(targetDescription(description, width, height), description.name));
+                continue;
+            }
+
+            vk::builders::Image builder (_device);
+            images.emplace(description.name, setup(builder, description, width, height).build());
+        }
+
+        log::info (
+            "[transient-images] {} images in {} slots, shared allocation size: {} MB",
+            _descriptions.size(),
+            _slots.size(),
+            size() / (1024 * 1024)
+        );
+    }
+
+    void TransientImages::release(Images& images, uint64_t release_value)
+    {
+        if (!_ptr_pool) [[unlikely]]
+            return ;
+
+        for (const auto image_index: std::views::iota(0u, _descriptions.size()))
+        {
+            if (_lifetimes[image_index].is_transient)
+                continue;
+
+            const auto& description = _descriptions[image_index];
+
+            if (auto node = images.extract(description.name))
+                _ptr_pool->release(targetDescription(description, _width, _height), std::move(node.mapped()), release_value);
+        }
+    }
+
+    void TransientImages::computeLifetimes()
+    {
+        _lifetimes.assign(_descriptions.size(), ImageLifetime());
+
+        std::vector<bool> is_written (_descriptions.size(), false);
+
+        const auto image_index = [this] (std::string_view name)
+        {
+            const auto it = std::ranges::find(_descriptions, name, &Description::name);
+
+            if (it == std::end(_descriptions)) [[unlikely]]
+                throw exception::InvalidArgument(std::format("[transient-images] pass uses unknown image '{}'", name));
+
+            return static_cast<size_t>(std::distance(std::begin(_descriptions), it));
+        };
+
+        for (const auto pass_index: std::views::iota(0u, static_cast<uint32_t>(_passes.size())))
+        {
+            const auto& pass = _passes[pass_index];
+
+            for (const auto name: pass.reads)
+            {
+                const auto index = image_index(name);
+
+                auto& lifetime = _lifetimes[index];
+                lifetime.first_pass = std::min(lifetime.first_pass, pass_index);
+                lifetime.last_pass  = std::max(lifetime.last_pass, pass_index);
+
+                if (!is_written[index])
+                    lifetime.is_transient = false;
+            }
+
+            for (const auto name: pass.writes)
+            {
+                const auto index = image_index(name);
+
+                auto& lifetime = _lifetimes[index];
+                lifetime.first_pass = std::min(lifetime.first_pass, pass_index);
+                lifetime.last_pass  = std::max(lifetime.last_pass, pass_index);
+
+                if (!is_written[index] && lifetime.is_transient)
+                    lifetime.is_overwritten = true;
+
+                is_written[index] = true;
+            }
+        }
+
+        for (auto& lifetime: _lifetimes)
+        {
+            if (!_aliasing || lifetime.first_pass == std::numeric_limits<uint32_t>::max())
+                lifetime.is_transient = false;
+        }
+    }
+
+    void TransientImages::placeImages(uint32_t width, uint32_t height)
+    {
+        _requirements.clear();
+        _requirements.reserve(_descriptions.size());
+
+        for (const auto& description: _descriptions)
+        {
+            vk::builders::Image builder (_device);
+            _requirements.push_back(setup(builder, description, width, height).memoryRequirements());
+        }
+
+        std::vector<size_t> order;
+        for (const auto image_index: std::views::iota(0u, _descriptions.size()))
+        {
+            if (_lifetimes[image_index].is_transient)
+                order.push_back(image_index);
+        }
+
+        /// The biggest images open the slots, so the smaller ones fit in them later.
+        std::ranges::stable_sort(order, std::ranges::greater(), [this] (size_t image_index)
+        {
+            return _requirements[image_index].size;
+        });
+
+        uint32_t memory_type_bits = std::numeric_limits<uint32_t>::max();
+
+        for (const auto image_index: order)
+        {
+            const auto& requirements = _requirements[image_index];
+
+            if (!(memory_type_bits & requirements.memoryTypeBits)) [[unlikely]]
+            {
+                log::warning("[transient-images] '{}' can't share memory with other images", _descriptions[image_index].name);
+                _lifetimes[image_index].is_transient = false;
+                continue;
+            }
+
+            memory_type_bits &= requirements.memoryTypeBits;
+
+            const auto& lifetime = _lifetimes[image_index];
+
+            auto it = std::ranges::find_if(_slots, [this, &lifetime] (const Slot& slot)
+            {
+                return std::ranges::none_of(slot.images, [this, &lifetime] (size_t other_index)
+                {
+                    return lifetime.overlaps(_lifetimes[other_index]);
+                });
+            });
+
+            if (it == std::end(_slots))
+                it = _slots.emplace(std::end(_slots));
+
+            it->images.push_back(image_index);
+            it->size        = std::max(it->size, requirements.size);
+            it->alignment   = std::max(it->alignment, requirements.alignment);
+        }
+
+        if (_slots.empty()) [[unlikely]]
+        {
+            _allocation_handle = vk::AllocationHandle();
+            return ;
+        }
+
+        VkDeviceSize offset     = 0;
+        VkDeviceSize alignment  = 1;
+
+        for (auto& slot: _slots)
+        {
+            std::ranges::sort(slot.images, std::ranges::less(), [this] (size_t image_index)
+            {
+                return _lifetimes[image_index].first_pass;
+            });
+
+            slot.offset = utils::alignSize(offset, slot.alignment);
+            offset      = slot.offset + slot.size;
+            alignment   = std::max(alignment, slot.alignment);
+        }
+
+        const VkMemoryRequirements requirements
+        {
+            .size           = offset,
+            .alignment      = alignment,
+            .memoryTypeBits = memory_type_bits
+        };
+
+        constexpr VmaAllocationCreateInfo alloc_info
+        {
+            .flags          = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+            .requiredFlags  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .priority       = 1.0f
+        };
+
+        VmaAllocation allocation_handle = VK_NULL_HANDLE;
+
+        VK_CHECK(vmaAllocateMemory(
+            _device.vmaAllocator(),
+            &requirements,
+            &alloc_info,
+            &allocation_handle,
+            nullptr
+        ));
+
+        _allocation_handle = vk::AllocationHandle(allocation_handle);
+    }
+
+    void TransientImages::collectDiscards()
+    {
+        for (const auto& slot: _slots)
+        {
+            if (slot.images.size() < 2)
+                continue;
+
+            for (const auto i: std::views::iota(0u, slot.images.size()))
+            {
+                const auto image_index = slot.images[i];
+
+                /// The first image of the slot follows the last one of the previous frame,
+                /// which may still be in flight. The discard adds the MEMORY_WRITE source access.
+                const auto previous_image_index = i > 0 ? slot.images[i - 1] : slot.images.back();
+                const auto src_stage            = _passes[_lifetimes[previous_image_index].last_pass].stage;
+
+                _discards.push_back (
+                    ImageDiscard
+                    {
+                        .name       = _descriptions[image_index].name,
+                        .pass       = _lifetimes[image_index].first_pass,
+                        .src_stage  = src_stage
+                    }
+                );
+            }
+        }
+    }
+
+    vk::builders::Image& TransientImages::setup (
+        vk::builders::Image&    builder,
+        const Description&      description,
+        uint32_t                width,
+        uint32_t                height
+    ) const
+    {
+        const auto divisor = description.divisor;
+
+        return builder
+            .size((width + divisor - 1) / divisor, (height + divisor - 1) / divisor)
+            .format(description.format)
+            .usage(description.usage)
+            .addQueueFamilyIndex(_device.queue().family_index)
+            .name(description.name);
+    }
+
+    RenderTargetDescription TransientImages::targetDescription (
+        const Description&  description,
+        uint32_t            width,
+        uint32_t            height
+    ) const noexcept
+    {
+        const auto divisor = description.divisor;
+
+        return RenderTargetDescription
+        {
+            .format = description.format,
+            .width  = (width + divisor - 1) / divisor,
+            .height = (height + divisor - 1) / divisor,
+            .usage  = description.usage
+        };
+    }
+
+    bool TransientImages::isAliased(std::string_view name) const noexcept
+    {
+        return std::ranges::any_of(_discards, [name] (const ImageDiscard& discard)
+        {
+            return discard.name == name;
+        });
+    }
+
+    bool TransientImages::needsClear(std::string_view name) const noexcept
+    {
+        const auto it = std::ranges::find(_descriptions, name, &Description::name);
+
+        if (it == std::end(_descriptions)) [[unlikely]]
+            return false;
+
+        return !_lifetimes[std::distance(std::begin(_descriptions), it)].is_overwritten;
+    }
+
+    std::span<const ImageDiscard> TransientImages::discards() const noexcept
+    {
+        return _discards;
+    }
+
+    VkDeviceSize TransientImages::size() const noexcept
+    {
+        if (_slots.empty())
+            return 0;
+
+        return _slots.back().offset + _slots.back().size;
+    }
+}
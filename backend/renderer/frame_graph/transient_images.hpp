@@ -0,0 +1,148 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/render_target_pool.hpp>
+#include <backend/renderer/vulkan/image.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <limits>
+
+#include <map>
+#include <vector>
+#include <span>
+
+#include <string>
+#include <string_view>
+
+namespace pbrlib::backend::vk
+{
+    class Device;
+}
+
+namespace pbrlib::backend
+{
+    /// Attachments which a pass reads and writes. Passes are added in the order of execution,
+    /// written attachments are fully overwritten by the pass.
+    struct PassAttachments final
+    {
+        std::vector<std::string_view>   reads;
+        std::vector<std::string_view>   writes;
+        VkPipelineStageFlags2           stage   = VK_PIPELINE_STAGE_2_NONE;
+    };
+
+    /// Passes [first_pass, last_pass] between which the content of an image must be kept.
+    struct ImageLifetime final
+    {
+        uint32_t first_pass = std::numeric_limits<uint32_t>::max();
+        uint32_t last_pass  = 0;
+
+        /// The image is written before it's read in the frame, so it never needs a clear.
+        bool is_overwritten = false;
+
+        /// Nothing is kept between frames and the image may share memory with other images.
+        bool is_transient = true;
+
+        [[nodiscard]] bool overlaps(const ImageLifetime& lifetime) const noexcept;
+    };
+
+    /// Content of the image is discarded before the pass, which has to wait for
+    /// the stage of the previous image that used the same memory.
+    struct ImageDiscard final
+    {
+        std::string_view        name;
+        uint32_t                pass        = 0;
+        VkPipelineStageFlags2   src_stage   = VK_PIPELINE_STAGE_2_NONE;
+    };
+
+    /// Places the transient images of the frame in one allocation. Images whose lifetimes
+    /// don't overlap share the same memory range.
+    class TransientImages final
+    {
+        struct Description final
+        {
+            std::string         name;
+            VkFormat            format  = VK_FORMAT_UNDEFINED;
+            VkImageUsageFlags   usage   = 0;
+            uint32_t            divisor = 1;
+        };
+
+        struct Slot final
+        {
+            VkDeviceSize offset     = 0;
+            VkDeviceSize size       = 0;
+            VkDeviceSize alignment  = 1;
+
+            /// Indices of the descriptions, sorted by the first pass.
+            std::vector<size_t> images;
+        };
+
+        void computeLifetimes();
+        void placeImages(uint32_t width, uint32_t height);
+        void collectDiscards();
+
+        [[nodiscard]] vk::builders::Image& setup(vk::builders::Image& builder, const Description& description, uint32_t width, uint32_t height) const;
+
+        [[nodiscard]] RenderTargetDescription targetDescription(const Description& description, uint32_t width, uint32_t height) const noexcept;
+
+    public:
+        using Images = std::map <
+            std::string,
+            vk::Image,
+            std::less<void>
+        >;
+
+        explicit TransientImages(vk::Device& device) noexcept;
+
+        TransientImages(TransientImages&& transient_images)      = delete;
+        TransientImages(const TransientImages& transient_images) = delete;
+
+        TransientImages& operator = (TransientImages&& transient_images)         = delete;
+        TransientImages& operator = (const TransientImages& transient_images)    = delete;
+
+        /// The image has the size of the frame divided by the divisor, rounded up.
+        TransientImages& addImage(std::string_view name, VkFormat format, VkImageUsageFlags usage, uint32_t divisor = 1);
+        TransientImages& addPass(const PassAttachments& pass);
+
+        /// Without aliasing every image gets its own memory, lifetimes are still computed.
+        TransientImages& aliasing(bool is_enabled) noexcept;
+
+        /// Images which don't share memory are taken from the pool instead of the allocator.
+        TransientImages& pool(RenderTargetPool* ptr_pool) noexcept;
+
+        /// Creates all added images. Images which are used only by one frame are placed in the shared allocation.
+        void build(uint32_t width, uint32_t height, Images& images);
+
+        /// Returns the images with their own memory to the pool, the GPU may use them until release_value.
+        /// Images in the shared allocation stay in the map.
+        void release(Images& images, uint64_t release_value);
+
+        [[nodiscard]] bool isAliased(std::string_view name) const noexcept;
+
+        /// No pass overwrites the image before it's read, so its content must be cleared every frame.
+        [[nodiscard]] bool needsClear(std::string_view name) const noexcept;
+
+        [[nodiscard]] std::span<const ImageDiscard> discards() const noexcept;
+
+        /// Size of the shared allocation.
+        [[nodiscard]] VkDeviceSize size() const noexcept;
+
+    private:
+        vk::Device& _device;
+
+        std::vector<Description>        _descriptions;
+        std::vector<PassAttachments>    _passes;
+
+        std::vector<ImageLifetime>          _lifetimes;
+        std::vector<VkMemoryRequirements>   _requirements;
+        std::vector<Slot>                   _slots;
+        std::vector<ImageDiscard>           _discards;
+
+        vk::AllocationHandle _allocation_handle;
+
+        RenderTargetPool* _ptr_pool = nullptr;
+
+        uint32_t _width     = 0;
+        uint32_t _height    = 0;
+
+        bool _aliasing = true;
+    };
+}
@@ -0,0 +1,438 @@
+#include <backend/renderer/frame_graph/visibility_buffer.hpp>
+#include <backend/renderer/frame_graph/gbuffer_generator.hpp>
+#include <backend/renderer/vulkan/render_pass.hpp>
+#include <backend/renderer/vulkan/shader_compiler.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
+#include <backend/renderer/vulkan/framebuffer.hpp>
+#include <backend/renderer/vulkan/graphics_pipeline.hpp>
+#include <backend/renderer/vulkan/compute_pipeline.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+#include <backend/scene/mesh_manager.hpp>
+#include <backend/components.hpp>
+#include <backend/logger/logger.hpp>
+
+#include <pbrlib/scene/scene.hpp>
+#include <pbrlib/math/matrix4x4.hpp>
+#include <backend/events.hpp>
+
+#include <array>
+
+namespace pbrlib::backend
+{
+    struct VisibilityResolveBindings final
+    {
+        enum :
+            uint8_t
+        {
+            eIds,
+            eUv,
+            eNormalTangent,
+            eMaterialIndices
+        };
+    };
+}
+
+namespace pbrlib::backend
+{
+    VisibilityBuffer::VisibilityBuffer(vk::Device& device) :
+        RenderPass(device)
+    {
+        createResultDescriptorSet();
+
+        _resolve_descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(device)
+            .addBinding(VisibilityResolveBindings::eIds, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(VisibilityResolveBindings::eUv, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(VisibilityResolveBindings::eNormalTangent, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(VisibilityResolveBindings::eMaterialIndices, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        _resolve_descriptor_set_handle = device.allocateDescriptorSet (
+            _resolve_descriptor_set_layout_handle,
+            "[visibility-buffer] resolve descriptor set"
+        );
+    }
+
+    bool VisibilityBuffer::init(const RenderContext& context, uint32_t width, uint32_t height)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!RenderPass::init(context, width, height)) [[unlikely]]
+        {
+            log::error("[visibility-buffer] failed initialize");
+            return false;
+        }
+
+        on([this] ([[maybe_unused]] const events::RecompilePipeline& event)
+        {
+            createPipelines();
+        });
+
+        createRenderPass();
+
+        constexpr VkPushConstantRange push_constant_range =
+        {
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+            .offset     = 0,
+            .size       = sizeof(VisibilityBufferPushConstantBlock)
+        };
+
+        constexpr VkPushConstantRange resolve_push_constant_range =
+        {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset     = 0,
+            .size       = sizeof(math::mat4)
+        };
+
+        const auto [_, mesh_manager_set_layout] = context.ptr_mesh_manager->descriptorSet();
+
+        _pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .pushConstant(push_constant_range)
+            .addSetLayout(mesh_manager_set_layout)
+            .build();
+
+        _resolve_pipeline_layout_handle = vk::builders::PipelineLayout(device())
+            .pushConstant(resolve_push_constant_range)
+            .addSetLayout(mesh_manager_set_layout)
+            .addSetLayout(_resolve_descriptor_set_layout_handle)
+            .build();
+
+        createFramebuffer();
+
+        _sampler_handle = device().nearestSampler();
+
+        initResolveDescriptorSet();
+        initResultDescriptorSet();
+
+        return createPipelines();
+    }
+
+    bool VisibilityBuffer::createPipelines()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        constexpr auto vert_shader      = "shaders/visibility_buffer/visibility_buffer.glsl.vert";
+        constexpr auto frag_shader      = "shaders/visibility_buffer/visibility_buffer.glsl.frag";
+        constexpr auto resolve_shader   = "shaders/visibility_buffer/resolve.glsl.comp";
+
+        auto new_pipeline = vk::builders::GraphicsPipeline(device())
+            .addStage(vert_shader, VK_SHADER_STAGE_VERTEX_BIT)
+            .addStage(frag_shader, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addAttachmentsState(false)
+            .depthStencilTest(true)
+            .pipelineLayoutHandle(_pipeline_layout_handle)
+            .renderPassHandle(_render_pass_handle)
+            .subpass(0)
+            .build();
+
+        auto new_resolve_pipeline = vk::builders::ComputePipeline(device())
+            .shader(resolve_shader)
+            .pipelineLayoutHandle(_resolve_pipeline_layout_handle)
+            .build();
+
+        _pipeline_handle            = std::move(new_pipeline);
+        _resolve_pipeline_handle    = std::move(new_resolve_pipeline);
+
+        return true;
+    }
+}
+
+namespace pbrlib::backend
+{
+    void VisibilityBuffer::createRenderPass()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto* ptr_ids_attach = colorOutputAttach(AttachmentsTraits<VisibilityBuffer>::ids);
+
+        _render_pass_handle = vk::builders::RenderPass(device())
+            .addColorAttachment(ptr_ids_attach, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
+            .depthAttachment(depthStencil(), VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
+            .build();
+    }
+
+    void VisibilityBuffer::createFramebuffer()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto ptr_ids_attach = colorOutputAttach(AttachmentsTraits<VisibilityBuffer>::ids);
+
+        const auto [width, height] = size();
+
+        _framebuffer_handle = vk::builders::Framebuffer(device())
+            .size(width, height)
+            .layers(1)
+            .renderPass(_render_pass_handle)
+            .addAttachment(*ptr_ids_attach)
+            .addAttachment(*depthStencil())
+            .build();
+    }
+
+    void VisibilityBuffer::initResolveDescriptorSet()
+    {
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<VisibilityBuffer>::ids)->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _resolve_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .binding                = VisibilityResolveBindings::eIds
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::uv)->view_handle,
+            .set_handle             = _resolve_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = VisibilityResolveBindings::eUv
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent)->view_handle,
+            .set_handle             = _resolve_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = VisibilityResolveBindings::eNormalTangent
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index)->view_handle,
+            .set_handle             = _resolve_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_GENERAL,
+            .binding                = VisibilityResolveBindings::eMaterialIndices
+        });
+    }
+
+    void VisibilityBuffer::initResultDescriptorSet()
+    {
+        constexpr auto expected_image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::uv)->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eUv
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::normal_tangent)->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eNormalTangent
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = colorOutputAttach(AttachmentsTraits<GBufferGenerator>::material_index)->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = expected_image_layout,
+            .binding                = GBufferDescriptorSetBindings::eMaterialIndices
+        });
+
+        device().writeDescriptorSet ({
+            .view_handle            = depthStencil()->view_handle,
+            .sampler_handle         = _sampler_handle,
+            .set_handle             = _result_descriptor_set_handle,
+            .expected_image_layout  = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+            .binding                = GBufferDescriptorSetBindings::eDepthBuffer
+        });
+    }
+}
+
+namespace pbrlib::backend
+{
+    void VisibilityBuffer::beginPass(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        _push_constant_block.projection_view = context().projection * context().view;
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[visibility-buffer] pre-pass");
+
+            /// Pixels without geometry keep invalid ids.
+            constexpr VkClearValue ids_clear_value
+            {
+                .color
+                {
+                    .uint32 = {~0u, ~0u, 0u, 0u}
+                }
+            };
+
+            constexpr VkClearValue depth_clear_value
+            {
+                .depthStencil = {1.0f, 0}
+            };
+
+            constexpr std::array clear_values
+            {
+                ids_clear_value,
+                depth_clear_value
+            };
+
+            const auto [width, height] = size();
+
+            const VkRect2D area
+            {
+                0,
+                0,
+                width,
+                height
+            };
+
+            const VkRenderPassBeginInfo render_pass_begin_info
+            {
+                .sType              = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+                .renderPass         = _render_pass_handle,
+                .framebuffer        = _framebuffer_handle,
+                .renderArea         = area,
+                .clearValueCount    = static_cast<uint32_t>(clear_values.size()),
+                .pClearValues       = clear_values.data()
+            };
+
+            constexpr VkSubpassBeginInfo subpass_begin_info
+            {
+                .sType      = VK_STRUCTURE_TYPE_SUBPASS_BEGIN_INFO,
+                .contents   = VK_SUBPASS_CONTENTS_INLINE
+            };
+
+            const VkViewport viewport
+            {
+                .width      = static_cast<float>(width),
+                .height     = static_cast<float>(height),
+                .minDepth   = 0.0f,
+                .maxDepth   = 1.0
+            };
+
+            const auto [descriptor_set, _] = context().ptr_mesh_manager->descriptorSet();
+
+            vkCmdBeginRenderPass2(command_buffer_handle, &render_pass_begin_info, &subpass_begin_info);
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline_handle);
+            vkCmdBindDescriptorSets(command_buffer_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline_layout_handle, 0, 1, &descriptor_set, 0, nullptr);
+            vkCmdSetViewport(command_buffer_handle, 0, 1, &viewport);
+            vkCmdSetScissor(command_buffer_handle, 0, 1, &area);
+        }, "[visibility-buffer] begin-pass", vk::marker_colors::graphics_pipeline);
+    }
+
+    void VisibilityBuffer::render(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        beginPass(command_buffer);
+
+        for (const auto ptr_item: context().items)
+        {
+            const auto& tag = ptr_item->getComponent<pbrlib::components::Tag>();
+
+            command_buffer.write([this, ptr_item] (VkCommandBuffer command_buffer_handle)
+            {
+                PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[visibility-buffer] run-pipeline");
+
+                const auto& renderable = ptr_item->getComponent<components::Renderable>();
+
+                _push_constant_block.instance_id = renderable.instance_id;
+
+                vkCmdPushConstants (
+                    command_buffer_handle,
+                    _pipeline_layout_handle,
+                    VK_SHADER_STAGE_VERTEX_BIT,
+                    0, sizeof(VisibilityBufferPushConstantBlock), &_push_constant_block
+                );
+
+                const auto& index_buffer = context().ptr_mesh_manager->indexBuffer(renderable.instance_id);
+
+                vkCmdBindIndexBuffer(command_buffer_handle, index_buffer.handle, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexed(command_buffer_handle, static_cast<uint32_t>(renderable.index_count), 1, 0, 0, 0);
+            }, std::format("[visibility-buffer] run-pipeline: {}", tag.name), vk::marker_colors::graphics_pipeline);
+        }
+
+        endPass(command_buffer);
+        resolve(command_buffer);
+    }
+
+    void VisibilityBuffer::endPass(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[visibility-buffer] post-pass");
+
+            vkCmdEndRenderPass(command_buffer_handle);
+        }, "[visibility-buffer] end-pass", vk::marker_colors::graphics_pipeline);
+    }
+
+    void VisibilityBuffer::resolve(vk::CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        auto ptr_ids_image = colorOutputAttach(AttachmentsTraits<VisibilityBuffer>::ids);
+
+        if (const auto barrier = ptr_ids_image->barrier(vk::image_access::compute_sampled_read))
+            vk::pipelineBarrier(command_buffer, std::span(&barrier.value(), 1));
+
+        command_buffer.write([this] (VkCommandBuffer command_buffer_handle)
+        {
+            PBRLIB_PROFILING_VK_ZONE_SCOPED(device(), command_buffer_handle, "[visibility-buffer] resolve");
+
+            const std::array sets_descriptors
+            {
+                context().ptr_mesh_manager->descriptorSet().first,
+                _resolve_descriptor_set_handle.handle()
+            };
+
+            vkCmdBindPipeline(command_buffer_handle, VK_PIPELINE_BIND_POINT_COMPUTE, _resolve_pipeline_handle);
+
+            vkCmdBindDescriptorSets (
+                command_buffer_handle,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                _resolve_pipeline_layout_handle, 0,
+                static_cast<uint32_t>(sets_descriptors.size()), sets_descriptors.data(),
+                0, nullptr
+            );
+
+            vkCmdPushConstants (
+                command_buffer_handle,
+                _resolve_pipeline_layout_handle,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(math::mat4), &_push_constant_block.projection_view
+            );
+
+            const auto [width, height] = size();
+
+            const auto group_count_x = width / device().workGroupSize();
+            const auto group_count_y = height / device().workGroupSize();
+
+            vkCmdDispatch(command_buffer_handle, group_count_x, group_count_y, 1);
+        }, "[visibility-buffer] resolve", vk::marker_colors::compute_pipeline);
+    }
+
+    void VisibilityBuffer::createResultDescriptorSet()
+    {
+        _result_descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(device())
+            .addBinding(GBufferDescriptorSetBindings::eUv, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eNormalTangent, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eMaterialIndices, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(GBufferDescriptorSetBindings::eDepthBuffer, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+        _result_descriptor_set_handle = device().allocateDescriptorSet (
+            _result_descriptor_set_layout_handle,
+            "[visibility-buffer] descritor set with results"
+        );
+    }
+
+    auto VisibilityBuffer::resultDescriptorSet() const noexcept
+        -> std::pair<VkDescriptorSet, VkDescriptorSetLayout>
+    {
+        return std::make_pair (
+            _result_descriptor_set_handle.handle(),
+            _result_descriptor_set_layout_handle
+        );
+    }
+
+    std::string_view VisibilityBuffer::name() const noexcept
+    {
+        return "visibility-buffer";
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <backend/renderer/frame_graph/render_pass.hpp>
+#include <backend/renderer/vulkan/buffer.hpp>
+#include <backend/renderer/vulkan/pipeline_layout.hpp>
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/event_system.hpp>
+
+#include <array>
+
+namespace pbrlib::backend
+{
+    class VisibilityBuffer;
+
+    template<>
+    struct AttachmentsTraits<VisibilityBuffer>
+    {
+        static constexpr auto metadata()
+        {
+            constexpr auto usage_flags =
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+            |   VK_IMAGE_USAGE_SAMPLED_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+            /// Instance id and triangle id of the visible surface.
+            constexpr std::array metadata
+            {
+                AttachmentMetadata(ids, VK_FORMAT_R32G32_UINT, usage_flags)
+            };
+
+            return metadata;
+        }
+
+        constexpr static auto ids = "visibility-buffer-ids";
+    };
+}
+
+namespace pbrlib::backend
+{
+    struct VisibilityBufferPushConstantBlock final
+    {
+        math::mat4  projection_view;
+        uint32_t    instance_id = ~0u;
+    };
+
+    /// Rasterizes only the ids of the visible triangles and resolves them in a compute pass
+    /// into the same attachments and descriptor set as GBufferGenerator.
+    class VisibilityBuffer final :
+        public RenderPass,
+        public pbrlib::EventSystem
+    {
+        void createResultDescriptorSet();
+
+        bool init(const RenderContext& context, uint32_t width, uint32_t height) override;
+
+        bool createPipelines();
+
+        void beginPass(vk::CommandBuffer& command_buffer);
+        void render(vk::CommandBuffer& command_buffer) override;
+        void endPass(vk::CommandBuffer& command_buffer);
+        void resolve(vk::CommandBuffer& command_buffer);
+
+        void createRenderPass();
+        void createFramebuffer();
+
+        void initResolveDescriptorSet();
+        void initResultDescriptorSet();
+
+        std::pair<VkDescriptorSet, VkDescriptorSetLayout> resultDescriptorSet() const noexcept override;
+
+        std::string_view name() const noexcept override;
+
+    public:
+        explicit VisibilityBuffer(vk::Device& device);
+
+    private:
+        vk::FramebufferHandle _framebuffer_handle;
+
+        VkPipelineLayout            _pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::RenderPassHandle        _render_pass_handle;
+        vk::PipelineHandle          _pipeline_handle;
+
+        VkPipelineLayout            _resolve_pipeline_layout_handle = VK_NULL_HANDLE;
+        vk::PipelineHandle          _resolve_pipeline_handle;
+
+        VisibilityBufferPushConstantBlock _push_constant_block;
+
+        VkDescriptorSetLayout           _resolve_descriptor_set_layout_handle = VK_NULL_HANDLE;
+        vk::DescriptorSetHandle         _resolve_descriptor_set_handle;
+
+        VkDescriptorSetLayout           _result_descriptor_set_layout_handle = VK_NULL_HANDLE;
+        vk::DescriptorSetHandle         _result_descriptor_set_handle;
+
+        VkSampler _sampler_handle = VK_NULL_HANDLE;
+    };
+}
@@ -14,8 +14,9 @@ namespace pbrlib::backend::vk
     { }
 
     Buffer::Buffer(Buffer&& buffer) noexcept :
-        _device (buffer._device),
-        usage   (buffer.usage)
+        _device     (buffer._device),
+        usage       (buffer.usage),
+        _setup_batch(buffer._setup_batch)
     {
         std::swap(handle, buffer.handle);
         std::swap(size, buffer.size);
@@ -28,11 +29,19 @@ namespace pbrlib::backend::vk
         std::swap(size, buffer.size);
         std::swap(type, buffer.type);
         std::swap(usage, buffer.usage);
+        std::swap(_setup_batch, buffer._setup_batch);
 
         return *this;
     }
 
-    void Buffer::writeToVram(const uint8_t* ptr_data, size_t data_size, VkDeviceSize offset)
+    Buffer::~Buffer()
+    {
+        /// The submitted frames and the pending setup commands may still use the buffer.
+        if (handle.handle() != VK_NULL_HANDLE)
+            _device.retire(std::move(handle), _setup_batch);
+    }
+
+    void Buffer::writeToVram(const uint8_t* ptr_data, size_t data_size, VkDeviceSize offset, QueueType queue_type)
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
@@ -46,23 +55,91 @@ namespace pbrlib::backend::vk
 
         staging_buffer.writeToRam(ptr_data, data_size, 0);
 
-        auto command_buffer = _device.oneTimeSubmitCommandBuffer("uplaod-data-to-buffer");
+        /// Contents of an exclusive buffer are undefined on another queue family, so only
+        /// a write of the whole buffer may go to the dedicated transfer queue.
+        const auto use_transfer_queue =
+                queue_type == QueueType::eTransfer
+            &&  _device.hasDedicatedQueue(QueueType::eTransfer)
+            &&  offset == 0
+            &&  static_cast<VkDeviceSize>(data_size) == size;
 
-        command_buffer.write([&staging_buffer, offset, data_size, this](VkCommandBuffer command_buffer_handle)
+        if (!use_transfer_queue)
         {
-            PBRLIB_PROFILING_VK_ZONE_SCOPED(_device, command_buffer_handle, "[vk-buffer] upalod-data-to-device-only-buffer");
+            _setup_batch = _device.setupBatch();
+
+            _device.setupCommandBuffer().write([&staging_buffer, offset, data_size, this](VkCommandBuffer command_buffer_handle)
+            {
+                PBRLIB_PROFILING_VK_ZONE_SCOPED(_device, command_buffer_handle, "[vk-buffer] upalod-data-to-device-only-buffer");
+
+                const VkBufferCopy copy
+                {
+                    .srcOffset  = 0,
+                    .dstOffset  = offset,
+                    .size       = static_cast<VkDeviceSize>(data_size)
+                };
 
+                vkCmdCopyBuffer(command_buffer_handle, staging_buffer.handle, handle, 1, &copy);
+            }, "[vk-buffer] upalod-data-to-device-only-buffer", marker_colors::write_data_in_buffer);
+
+            _device.retireWithSetupCommands(std::move(staging_buffer));
+            return ;
+        }
+
+        const VkBufferMemoryBarrier2 ownership_barrier
+        {
+            .sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask           = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask          = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask           = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask          = VK_ACCESS_2_MEMORY_READ_BIT,
+            .srcQueueFamilyIndex    = _device.queue(QueueType::eTransfer).family_index,
+            .dstQueueFamilyIndex    = _device.queue().family_index,
+            .buffer                 = handle,
+            .offset                 = 0,
+            .size                   = VK_WHOLE_SIZE
+        };
+
+        auto command_buffer = _device.oneTimeSubmitCommandBuffer("uplaod-data-to-buffer", QueueType::eTransfer);
+
+        command_buffer.write([&staging_buffer, &ownership_barrier, data_size, this](VkCommandBuffer command_buffer_handle)
+        {
             const VkBufferCopy copy
             {
                 .srcOffset  = 0,
-                .dstOffset  = offset,
+                .dstOffset  = 0,
                 .size       = static_cast<VkDeviceSize>(data_size)
             };
 
             vkCmdCopyBuffer(command_buffer_handle, staging_buffer.handle, handle, 1, &copy);
-        }, "[vk-buffer] upalod-data-to-device-only-buffer", marker_colors::write_data_in_buffer);
 
-        _device.submit(command_buffer);
+            /// The release half of the ownership transfer, the destination stage is ignored.
+            VkBufferMemoryBarrier2 release_barrier = ownership_barrier;
+            release_barrier.dstStageMask    = VK_PIPELINE_STAGE_2_NONE;
+            release_barrier.dstAccessMask   = VK_ACCESS_2_NONE;
+
+            const VkDependencyInfo dependency_info
+            {
+                .sType                      = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount   = 1,
+                .pBufferMemoryBarriers      = &release_barrier
+            };
+
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+        }, "[vk-buffer] upalod-data-on-transfer-queue", marker_colors::write_data_in_buffer);
+
+        const auto release_value = _device.submit(command_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+        _device.retire(std::move(command_buffer), release_value);
+
+        /// The acquire half, the source access is ignored.
+        VkBufferMemoryBarrier2 acquire_barrier = ownership_barrier;
+        acquire_barrier.srcStageMask    = VK_PIPELINE_STAGE_2_NONE;
+        acquire_barrier.srcAccessMask   = VK_ACCESS_2_NONE;
+
+        _setup_batch = _device.setupBatch();
+        _device.acquireOnGeneralQueue(acquire_barrier, release_value);
+
+        /// The setup commands wait for the transfer, so the staging buffer lives as long as they do.
+        _device.retireWithSetupCommands(std::move(staging_buffer));
     }
 
     void Buffer::writeToRam(const uint8_t* ptr_data, size_t data_size, VkDeviceSize offset)
@@ -210,23 +287,44 @@ namespace pbrlib::backend::vk::builders
         };
 
         if (_type == BufferType::eDeviceOnly)
-            alloc_info.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+            alloc_info.pool = _device.memoryPool(MemoryPoolType::eGeometry);
         else if (_type == BufferType::eStaging)
-            alloc_info.flags =  VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |  VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        {
+            alloc_info.flags    = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            alloc_info.pool     = _device.memoryPool(MemoryPoolType::eStaging);
+        }
         else
             alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
         VkBuffer        buffer_handle       = VK_NULL_HANDLE;
         VmaAllocation   allocation_handle   = VK_NULL_HANDLE;
 
-        VK_CHECK(vmaCreateBuffer(
+        const auto result = vmaCreateBuffer(
             _device.vmaAllocator(),
             &buffer_info,
             &alloc_info,
             &buffer_handle,
             &allocation_handle,
             nullptr
-        ));
+        );
+
+        /// The memory type of the pool may be not compatible with the buffer usage,
+        /// in this case the buffer is allocated from the default pools of VMA.
+        if (result == VK_ERROR_FEATURE_NOT_PRESENT && alloc_info.pool != VK_NULL_HANDLE) [[unlikely]]
+        {
+            alloc_info.pool = VK_NULL_HANDLE;
+
+            VK_CHECK(vmaCreateBuffer(
+                _device.vmaAllocator(),
+                &buffer_info,
+                &alloc_info,
+                &buffer_handle,
+                &allocation_handle,
+                nullptr
+            ));
+        }
+        else
+            VK_CHECK(result);
 
         buffer.handle = BufferHandle(buffer_handle, allocation_handle);
 
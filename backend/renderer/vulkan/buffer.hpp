@@ -2,6 +2,7 @@
 
 #include <backend/renderer/vulkan/utils.hpp>
 #include <backend/renderer/vulkan/unique_handler.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
 
 #include <string_view>
 #include <vector>
@@ -33,13 +34,15 @@ namespace pbrlib::backend::vk
 
         explicit Buffer(Device& device) noexcept;
 
-        void writeToVram(const uint8_t* ptr_data, size_t size, VkDeviceSize offset);
+        void writeToVram(const uint8_t* ptr_data, size_t size, VkDeviceSize offset, QueueType queue_type = QueueType::eGeneral);
         void writeToRam(const uint8_t* ptr_data, size_t size, VkDeviceSize offset);
 
     public:
         Buffer(Buffer&& buffer) noexcept;
         Buffer(const Buffer& buffer) = delete;
 
+        ~Buffer();
+
         Buffer& operator = (Buffer&& buffer) noexcept;
         Buffer& operator = (const Buffer& buffer) = delete;
 
@@ -68,6 +71,19 @@ namespace pbrlib::backend::vk
 
         void write(const Buffer& buffer, VkDeviceSize offset_in_dst);
 
+        /// Fills the whole buffer which the GPU doesn't use yet, e.g. a new vertex buffer.
+        /// Goes to the dedicated transfer queue if the device has one.
+        template<typename T>
+        void upload(std::span<const T> data)
+        {
+            const auto ptr_data = reinterpret_cast<const uint8_t*>(data.data());
+
+            if (type == BufferType::eStaging)
+                writeToRam(ptr_data, data.size_bytes(), 0);
+            else
+                writeToVram(ptr_data, data.size_bytes(), 0, QueueType::eTransfer);
+        }
+
         template<typename T>
         void read(T& dst, VkDeviceSize offset_in_src)
         {
@@ -95,6 +111,9 @@ namespace pbrlib::backend::vk
 
     private:
         Device& _device;
+
+        /// Batch of the setup commands which last wrote the buffer.
+        uint64_t _setup_batch = 0;
     };
 }
 
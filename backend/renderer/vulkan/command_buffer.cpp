@@ -11,8 +11,9 @@
 
 namespace pbrlib::backend::vk
 {
-    CommandBuffer::CommandBuffer(const Device& device, VkCommandPool command_pool_handle) :
-        _device (device)
+    CommandBuffer::CommandBuffer(const Device& device, VkCommandPool command_pool_handle, QueueType type) :
+        queue_type  (type),
+        _device     (device)
     {
         const VkCommandBufferAllocateInfo alloc_info =
         {
@@ -32,6 +33,8 @@ namespace pbrlib::backend::vk
 
     CommandBuffer::CommandBuffer(CommandBuffer&& command_buffer) noexcept :
         level                   (command_buffer.level),
+        queue_type              (command_buffer.queue_type),
+        transfer_wait_value     (command_buffer.transfer_wait_value),
         _device                 (command_buffer._device),
         _is_recording_started   (command_buffer._is_recording_started)
     {
@@ -41,6 +44,8 @@ namespace pbrlib::backend::vk
     CommandBuffer& CommandBuffer::operator = (CommandBuffer&& command_buffer) noexcept
     {
         level                   = command_buffer.level;
+        queue_type              = command_buffer.queue_type;
+        transfer_wait_value     = command_buffer.transfer_wait_value;
         _is_recording_started   = command_buffer._is_recording_started;
 
         std::swap(handle, command_buffer.handle);
@@ -16,13 +16,23 @@ namespace pbrlib::backend::vk
 
 namespace pbrlib::backend::vk
 {
+    /// Queues of the device. Without a dedicated family a type falls back to the general queue.
+    enum class QueueType :
+        uint8_t
+    {
+        eGeneral,
+        eTransfer,
+
+        eCount
+    };
+
     class CommandBuffer final
     {
         friend class Device;
 
         using WriteFunctionType = std::function<void (VkCommandBuffer command_buffer)>;
 
-        CommandBuffer(const Device& device, VkCommandPool command_pool_handle);
+        CommandBuffer(const Device& device, VkCommandPool command_pool_handle, QueueType type);
 
     public:
         CommandBuffer(CommandBuffer&& command_buffer) noexcept;
@@ -38,7 +48,12 @@ namespace pbrlib::backend::vk
         );
 
         CommandBufferHandle     handle;
-        VkCommandBufferLevel    level   = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        VkCommandBufferLevel    level       = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        QueueType               queue_type  = QueueType::eGeneral;
+
+        /// Value of the transfer timeline which releases the resources the command buffer acquires.
+        /// The submit waits for it.
+        uint64_t transfer_wait_value = 0;
 
     private:
         const Device&   _device;
@@ -10,6 +10,7 @@
 #include <backend/renderer/vulkan/shader_compiler.hpp>
 
 #include <backend/renderer/vulkan/buffer.hpp>
+#include <backend/renderer/vulkan/gpu_marker_colors.hpp>
 
 #include <backend/renderer/vulkan/sync.hpp>
 
@@ -17,17 +18,26 @@
 
 #include <SDL3/SDL_vulkan.h>
 
+#include <algorithm>
 #include <array>
 #include <format>
+#include <optional>
 
 #include <ranges>
 
 namespace pbrlib::backend::vk
 {
+    Device::Device() = default;
+
     Device::~Device()
     {
         if (_device_handle != VK_NULL_HANDLE) [[likely]]
             vkDeviceWaitIdle(_device_handle);
+
+        /// The GPU is idle, the staging buffers retire their handles and everything is destroyed at once.
+        _setup_staging_buffers.clear();
+        _retired_staging_buffers.clear();
+        _retired_resources.clear();
     }
 
     void Device::init()
@@ -47,7 +57,9 @@ namespace pbrlib::backend::vk
             _allocator_handle
         );
 
+        createMemoryPools();
         createCommandPools();
+        createTimelineSemaphores();
         createDescriptorPool();
         createTracyContext();
     }
@@ -255,7 +267,7 @@ namespace pbrlib::backend::vk
 
 namespace pbrlib::backend::vk
 {
-    void Device::getGeneralQueueIndex()
+    void Device::getQueueIndices()
     {
         uint32_t family_count = 0;
         vkGetPhysicalDeviceQueueFamilyProperties(_physical_device_handle, &family_count, nullptr);
@@ -263,27 +275,38 @@ namespace pbrlib::backend::vk
         std::vector<VkQueueFamilyProperties> families (family_count);
         vkGetPhysicalDeviceQueueFamilyProperties(_physical_device_handle, &family_count, families.data());
 
-        std::vector<uint32_t> num_queues_in_family (families.size(), 0);
+        const auto find_family = [&families] (VkQueueFlags required_flags, VkQueueFlags excluded_flags) -> std::optional<uint32_t>
+        {
+            for (const auto index: std::views::iota(0u, static_cast<uint32_t>(families.size())))
+            {
+                const auto flags = families[index].queueFlags;
+
+                if ((flags & required_flags) == required_flags && !(flags & excluded_flags))
+                    return index;
+            }
+
+            return std::nullopt;
+        };
 
-        constexpr auto queue_flags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+        const auto general_family = find_family(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT, 0);
 
-        for (const auto index: std::views::iota(0u, families.size()))
+        if (!general_family) [[unlikely]]
+            throw exception::RuntimeError("[vk-device] couldn't find queue index");
+
+        /// Dedicated families run beside the general queue, e.g. DMA engines for transfers.
+        const std::array families_by_type
         {
-            const auto supportGraphics  = (families[index].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
-            const auto supportCompute   = (families[index].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
-            const auto supportTransfer  = (families[index].queueFlags & VK_QUEUE_TRANSFER_BIT) != 0;
+            general_family,
+            find_family(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)
+        };
 
-            if (supportGraphics && supportCompute && supportTransfer) [[likely]]
-            {
-                _general_queue.family_index = index;
-                _general_queue.index        = num_queues_in_family[index]++;
+        for (const auto type: std::views::iota(0u, families_by_type.size()))
+        {
+            auto& queue = _queues[type].queue;
 
-                return ;
-            }
+            queue.family_index  = families_by_type[type].value_or(general_family.value());
+            queue.index         = 0;
         }
-
-        throw exception::RuntimeError("[vk-device] couldn't find queue index");
-        std::unreachable();
     }
 
     bool Device::isRunFromFrameDebugger() const
@@ -320,19 +343,84 @@ namespace pbrlib::backend::vk
         return is_run_from_frame_debugger.value();
     }
 
+    bool Device::isExtensionSupported(std::string_view extension_name) const
+    {
+        uint32_t num_properties = 0u;
+
+        vkEnumerateDeviceExtensionProperties(
+            _physical_device_handle,
+            nullptr,
+            &num_properties, nullptr
+        );
+
+        std::vector<VkExtensionProperties> extension_properties (num_properties);
+
+        vkEnumerateDeviceExtensionProperties(
+            _physical_device_handle,
+            nullptr,
+            &num_properties, extension_properties.data()
+        );
+
+        return std::ranges::any_of(extension_properties, [extension_name] (const auto& properties)
+        {
+            return extension_name == properties.extensionName;
+        });
+    }
+
+    bool Device::isPresentWaitSupported() const
+    {
+        if (!isExtensionSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME) || !isExtensionSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+            return false;
+
+        VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features =
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR
+        };
+
+        VkPhysicalDevicePresentIdFeaturesKHR present_id_features =
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .pNext = &present_wait_features
+        };
+
+        VkPhysicalDeviceFeatures2 features =
+        {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &present_id_features
+        };
+
+        vkGetPhysicalDeviceFeatures2(_physical_device_handle, &features);
+
+        return present_id_features.presentId && present_wait_features.presentWait;
+    }
+
     void Device::createDevice()
     {
-        getGeneralQueueIndex();
+        getQueueIndices();
 
         constexpr float priority = 1.0f;
 
-        const VkDeviceQueueCreateInfo queue_info
+        std::vector<VkDeviceQueueCreateInfo> queue_infos;
+
+        for (const auto& context: _queues)
         {
-            .sType              = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-            .queueFamilyIndex   = _general_queue.family_index,
-            .queueCount         = 1,
-            .pQueuePriorities   = &priority
-        };
+            const auto family_index = context.queue.family_index;
+
+            const auto is_created = std::ranges::any_of(queue_infos, [family_index] (const auto& queue_info)
+            {
+                return queue_info.queueFamilyIndex == family_index;
+            });
+
+            if (is_created)
+                continue;
+
+            queue_infos.push_back ({
+                .sType              = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                .queueFamilyIndex   = family_index,
+                .queueCount         = 1,
+                .pQueuePriorities   = &priority
+            });
+        }
 
         std::vector extensions
         {
@@ -342,9 +430,34 @@ namespace pbrlib::backend::vk
         if (isRunFromFrameDebugger()) [[unlikely]]
             extensions.push_back(VK_EXT_DEBUG_MARKER_EXTENSION_NAME);
 
+        _memory_budget_is_supported = isExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (_memory_budget_is_supported) [[likely]]
+            extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        _present_wait_is_supported = isPresentWaitSupported();
+        if (_present_wait_is_supported)
+        {
+            extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+
+        VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features =
+        {
+            .sType          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+            .presentWait    = VK_TRUE
+        };
+
+        VkPhysicalDevicePresentIdFeaturesKHR present_id_features =
+        {
+            .sType      = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .pNext      = &present_wait_features,
+            .presentId  = VK_TRUE
+        };
+
         VkPhysicalDevice16BitStorageFeatures physical_device_16_bit_storage_features =
         {
             .sType                      = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES,
+            .pNext                      = _present_wait_is_supported ? &present_id_features : nullptr,
             .storageBuffer16BitAccess   = VK_TRUE
         };
 
@@ -362,6 +475,7 @@ namespace pbrlib::backend::vk
             .descriptorBindingStorageBufferUpdateAfterBind  = VK_TRUE,
             .runtimeDescriptorArray                         = VK_TRUE,
             .separateDepthStencilLayouts                    = VK_TRUE,
+            .timelineSemaphore                              = VK_TRUE,
             .bufferDeviceAddress                            = VK_TRUE
         };
 
@@ -369,15 +483,16 @@ namespace pbrlib::backend::vk
         {
             .sType              = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
             .pNext              = &vulkan_1_2_features,
-            .synchronization2   = VK_TRUE
+            .synchronization2   = VK_TRUE,
+            .dynamicRendering   = VK_TRUE
         };
 
         const VkDeviceCreateInfo device_info =
         {
             .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
             .pNext                   = &vulkan_1_3_features,
-            .queueCreateInfoCount    = 1,
-            .pQueueCreateInfos       = &queue_info,
+            .queueCreateInfoCount    = static_cast<uint32_t>(queue_infos.size()),
+            .pQueueCreateInfos       = queue_infos.data(),
             .enabledExtensionCount   = static_cast<uint32_t>(extensions.size()),
             .ppEnabledExtensionNames = extensions.data()
         };
@@ -391,7 +506,8 @@ namespace pbrlib::backend::vk
 
         loadDeviceFunctions();
 
-        vkGetDeviceQueue(_device_handle, _general_queue.family_index, _general_queue.index, &_general_queue.handle);
+        for (auto& context: _queues)
+            vkGetDeviceQueue(_device_handle, context.queue.family_index, context.queue.index, &context.queue.handle);
     }
 
     VkDevice Device::device() const noexcept
@@ -401,7 +517,27 @@ namespace pbrlib::backend::vk
 
     const Queue& Device::queue() const noexcept
     {
-        return _general_queue;
+        return queue(QueueType::eGeneral);
+    }
+
+    const Queue& Device::queue(QueueType type) const noexcept
+    {
+        return queueContext(type).queue;
+    }
+
+    bool Device::hasDedicatedQueue(QueueType type) const noexcept
+    {
+        return queue(type).family_index != queue().family_index;
+    }
+
+    Device::QueueContext& Device::queueContext(QueueType type) noexcept
+    {
+        return _queues[static_cast<size_t>(type)];
+    }
+
+    const Device::QueueContext& Device::queueContext(QueueType type) const noexcept
+    {
+        return _queues[static_cast<size_t>(type)];
     }
 
     const VkPhysicalDeviceProperties2& Device::gpuProperties() const noexcept
@@ -414,9 +550,14 @@ namespace pbrlib::backend::vk
 {
     void Device::createGpuAllocator()
     {
+        VmaAllocatorCreateFlags flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+
+        if (_memory_budget_is_supported) [[likely]]
+            flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+
         const VmaAllocatorCreateInfo allocator_info =
         {
-            .flags              =  VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+            .flags              = flags,
             .physicalDevice     = _physical_device_handle,
             .device             = _device_handle,
             .instance           = _instance_handle,
@@ -433,30 +574,195 @@ namespace pbrlib::backend::vk
     {
         return _allocator_handle;
     }
+
+    void Device::createMemoryPools()
+    {
+        const auto create_pool = [this] (uint32_t memory_type_index, float priority)
+        {
+            const VmaPoolCreateInfo pool_info
+            {
+                .memoryTypeIndex    = memory_type_index,
+                .priority           = priority
+            };
+
+            MemoryPoolHandle pool_handle;
+            VK_CHECK(vmaCreatePool(_allocator_handle, &pool_info, &pool_handle.handle()));
+
+            return pool_handle;
+        };
+
+        const auto find_buffer_memory_type = [this] (VkBufferUsageFlags usage, VmaAllocationCreateFlags flags)
+        {
+            const VkBufferCreateInfo buffer_info
+            {
+                .sType  = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                .size   = 1024,
+                .usage  = usage
+            };
+
+            const VmaAllocationCreateInfo alloc_info
+            {
+                .flags = flags,
+                .usage = VMA_MEMORY_USAGE_AUTO
+            };
+
+            uint32_t memory_type_index = 0;
+            VK_CHECK(vmaFindMemoryTypeIndexForBufferInfo(_allocator_handle, &buffer_info, &alloc_info, &memory_type_index));
+
+            return memory_type_index;
+        };
+
+        const auto find_image_memory_type = [this] (VkFormat format, VkImageUsageFlags usage)
+        {
+            const VkImageCreateInfo image_info
+            {
+                .sType          = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType      = VK_IMAGE_TYPE_2D,
+                .format         = format,
+                .extent         = {16, 16, 1},
+                .mipLevels      = 1,
+                .arrayLayers    = 1,
+                .samples        = VK_SAMPLE_COUNT_1_BIT,
+                .tiling         = VK_IMAGE_TILING_OPTIMAL,
+                .usage          = usage
+            };
+
+            constexpr VmaAllocationCreateInfo alloc_info
+            {
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+            };
+
+            uint32_t memory_type_index = 0;
+            VK_CHECK(vmaFindMemoryTypeIndexForImageInfo(_allocator_handle, &image_info, &alloc_info, &memory_type_index));
+
+            return memory_type_index;
+        };
+
+        constexpr VkBufferUsageFlags geometry_usage =
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+            |   VK_BUFFER_USAGE_TRANSFER_DST_BIT
+            |   VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+            |   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+            |   VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+            |   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+            |   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        constexpr VkImageUsageFlags render_target_usage =
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            |   VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            |   VK_IMAGE_USAGE_SAMPLED_BIT
+            |   VK_IMAGE_USAGE_STORAGE_BIT
+            |   VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+        constexpr VkImageUsageFlags texture_usage =
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT
+            |   VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        constexpr VmaAllocationCreateFlags staging_flags =
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+            |   VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        _memory_pools[static_cast<size_t>(MemoryPoolType::eRenderTargets)] = create_pool (
+            find_image_memory_type(VK_FORMAT_R32G32B32A32_SFLOAT, render_target_usage),
+            1.0f
+        );
+
+        _memory_pools[static_cast<size_t>(MemoryPoolType::eGeometry)] = create_pool (
+            find_buffer_memory_type(geometry_usage, 0),
+            1.0f
+        );
+
+        _memory_pools[static_cast<size_t>(MemoryPoolType::eTextures)] = create_pool (
+            find_image_memory_type(VK_FORMAT_R8G8B8A8_UNORM, texture_usage),
+            0.5f
+        );
+
+        _memory_pools[static_cast<size_t>(MemoryPoolType::eStaging)] = create_pool (
+            find_buffer_memory_type(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, staging_flags),
+            0.0f
+        );
+    }
+
+    VmaPool Device::memoryPool(MemoryPoolType type) const noexcept
+    {
+        return _memory_pools[static_cast<size_t>(type)].handle();
+    }
+
+    bool Device::presentWaitSupported() const noexcept
+    {
+        return _present_wait_is_supported;
+    }
+
+    MemoryBudget Device::memoryBudget() const
+    {
+        const VkPhysicalDeviceMemoryProperties* ptr_memory_properties = nullptr;
+        vmaGetMemoryProperties(_allocator_handle, &ptr_memory_properties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = { };
+        vmaGetHeapBudgets(_allocator_handle, budgets.data());
+
+        MemoryBudget memory_budget;
+
+        for (const auto i: std::views::iota(0u, ptr_memory_properties->memoryHeapCount))
+        {
+            if (ptr_memory_properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            {
+                memory_budget.usage     += budgets[i].usage;
+                memory_budget.budget    += budgets[i].budget;
+            }
+        }
+
+        return memory_budget;
+    }
 }
 
 namespace pbrlib::backend::vk
 {
-    void Device::createCommandPools()
+    void Device::createTimelineSemaphores()
     {
-        const VkCommandPoolCreateInfo command_pool_info =
+        constexpr VkSemaphoreTypeCreateInfo semaphore_type_info
         {
-            .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .flags              = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-            .queueFamilyIndex   = _general_queue.family_index
+            .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType  = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue   = 0
         };
 
-        VK_CHECK(vkCreateCommandPool(
-            _device_handle,
-            &command_pool_info,
-            nullptr,
-            &_command_pool_for_general_queue.handle()
-        ));
+        const VkSemaphoreCreateInfo semaphore_create_info
+        {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &semaphore_type_info
+        };
+
+        for (auto& context: _queues)
+        {
+            context.timeline_semaphore_handle   = create(_device_handle, semaphore_create_info);
+            context.timeline_value              = 0;
+        }
     }
 
-    CommandBuffer Device::oneTimeSubmitCommandBuffer(std::string_view name)
+    void Device::createCommandPools()
     {
-        CommandBuffer command_buffer (*this, _command_pool_for_general_queue);
+        for (auto& context: _queues)
+        {
+            const VkCommandPoolCreateInfo command_pool_info =
+            {
+                .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .flags              = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                .queueFamilyIndex   = context.queue.family_index
+            };
+
+            VK_CHECK(vkCreateCommandPool(
+                _device_handle,
+                &command_pool_info,
+                nullptr,
+                &context.command_pool_handle.handle()
+            ));
+        }
+    }
+
+    CommandBuffer Device::oneTimeSubmitCommandBuffer(std::string_view name, QueueType type)
+    {
+        CommandBuffer command_buffer (*this, queueContext(type).command_pool_handle, type);
 
         if (!name.empty()) [[likely]]
         {
@@ -474,35 +780,144 @@ namespace pbrlib::backend::vk
         return command_buffer;
     }
 
-    void Device::submit(const CommandBuffer& command_buffer)
+    void Device::acquireOnGeneralQueue(const VkBufferMemoryBarrier2& barrier, uint64_t release_value)
     {
-        PBRLIB_PROFILING_ZONE_SCOPED;
+        auto& command_buffer = setupCommandBuffer();
 
-        if (_submit_fence_handle == VK_NULL_HANDLE) [[unlikely]]
+        command_buffer.write([&barrier] (VkCommandBuffer command_buffer_handle)
         {
-            constexpr VkFenceCreateInfo fence_create_info
+            const VkDependencyInfo dependency_info
             {
-                .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+                .sType                      = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount   = 1,
+                .pBufferMemoryBarriers      = &barrier
             };
 
-            _submit_fence_handle = create(_device_handle, fence_create_info);
-        }
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+        }, "[vk-device] acquire-ownership", marker_colors::change_layout);
 
-        submit(command_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE, _submit_fence_handle);
-        sync(_device_handle, _submit_fence_handle);
+        command_buffer.transfer_wait_value = std::max(command_buffer.transfer_wait_value, release_value);
     }
 
-    void Device::submit (
+    void Device::acquireOnGeneralQueue(const VkImageMemoryBarrier2& barrier, uint64_t release_value)
+    {
+        auto& command_buffer = setupCommandBuffer();
+
+        command_buffer.write([&barrier] (VkCommandBuffer command_buffer_handle)
+        {
+            const VkDependencyInfo dependency_info
+            {
+                .sType                      = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount    = 1,
+                .pImageMemoryBarriers       = &barrier
+            };
+
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+        }, "[vk-device] acquire-ownership", marker_colors::change_layout);
+
+        command_buffer.transfer_wait_value = std::max(command_buffer.transfer_wait_value, release_value);
+    }
+
+    CommandBuffer& Device::setupCommandBuffer()
+    {
+        if (!_setup_command_buffer)
+            _setup_command_buffer.emplace(oneTimeSubmitCommandBuffer("setup-command-buffer"));
+
+        /// Separate submits used to order these operations, in one command buffer it is done by a barrier.
+        /// The first barrier orders the setup commands after the previous submits on the queue.
+        _setup_command_buffer->write([] (VkCommandBuffer command_buffer_handle)
+        {
+            constexpr VkMemoryBarrier2 memory_barrier
+            {
+                .sType          = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                .srcStageMask   = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .srcAccessMask  = VK_ACCESS_2_MEMORY_WRITE_BIT,
+                .dstStageMask   = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .dstAccessMask  = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT
+            };
+
+            const VkDependencyInfo dependency_info
+            {
+                .sType                  = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .memoryBarrierCount     = 1,
+                .pMemoryBarriers        = &memory_barrier
+            };
+
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+        });
+
+        return _setup_command_buffer.value();
+    }
+
+    uint64_t Device::setupBatch() const noexcept
+    {
+        return _setup_batch;
+    }
+
+    bool Device::isSetupBatchPending(uint64_t batch) const noexcept
+    {
+        return batch == _setup_batch && _setup_command_buffer.has_value();
+    }
+
+    void Device::retireWithSetupCommands(Buffer&& staging_buffer)
+    {
+        _setup_staging_buffers.push_back(std::make_unique<Buffer>(std::move(staging_buffer)));
+    }
+
+    uint64_t Device::flushSetupCommands()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto completed_value = completedValue();
+
+        while (!_retired_staging_buffers.empty() && _retired_staging_buffers.front().first <= completed_value)
+            _retired_staging_buffers.pop_front();
+
+        releaseCompletedResources();
+
+        if (!_setup_command_buffer)
+            return 0;
+
+        /// Taken out first, the submit flushes the setup commands itself.
+        auto command_buffer = std::move(_setup_command_buffer.value());
+        _setup_command_buffer.reset();
+
+        ++_setup_batch;
+
+        const auto value = submit(command_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+        retire(std::move(command_buffer), value);
+
+        if (!_setup_staging_buffers.empty())
+            _retired_staging_buffers.emplace_back(value, std::move(_setup_staging_buffers));
+
+        _setup_staging_buffers.clear();
+
+        return value;
+    }
+
+    void Device::submit(const CommandBuffer& command_buffer)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        wait(submit(command_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE), command_buffer.queue_type);
+    }
+
+    uint64_t Device::submit (
         const CommandBuffer&    command_buffer,
         VkSemaphore             wait_semaphore_handle,
-        VkSemaphore             signal_semaphore_handle,
-        VkFence                 fence_handle
+        VkSemaphore             signal_semaphore_handle
     )
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
+        const auto setup_value = flushSetupCommands();
+
+        auto& context = queueContext(command_buffer.queue_type);
+
 #ifdef PBRLIB_ENABLE_PROFILING
-        TracyVkCollect(_tracy_ctx_handle.handle(), command_buffer.handle);
+        /// The profiler context is created for the general queue.
+        if (command_buffer.queue_type == QueueType::eGeneral)
+            TracyVkCollect(_tracy_ctx_handle.handle(), command_buffer.handle);
 #endif
 
         vkEndCommandBuffer(command_buffer.handle);
@@ -520,33 +935,147 @@ namespace pbrlib::backend::vk
             .pCommandBufferInfos    = &command_buffer_info
         };
 
-        constexpr auto make_semaphore_info = [] (VkSemaphore semaphore_handle)
+        constexpr auto make_semaphore_info = [] (VkSemaphore semaphore_handle, uint64_t value = 0)
         {
             const VkSemaphoreSubmitInfo submit_info
             {
                 .sType      = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
                 .semaphore  = semaphore_handle,
+                .value      = value,
                 .stageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
             };
 
             return submit_info;
         };
 
-        const auto wait_semaphore_info = make_semaphore_info(wait_semaphore_handle);
+        std::array<VkSemaphoreSubmitInfo, 3>    wait_semaphore_infos;
+        uint32_t                                wait_semaphore_count = 0;
+
         if (wait_semaphore_handle != VK_NULL_HANDLE)
+            wait_semaphore_infos[wait_semaphore_count++] = make_semaphore_info(wait_semaphore_handle);
+
+        /// The setup commands are complete and their writes are visible before the command buffer starts.
+        if (setup_value != 0)
+            wait_semaphore_infos[wait_semaphore_count++] = make_semaphore_info(queueContext(QueueType::eGeneral).timeline_semaphore_handle, setup_value);
+
+        /// The command buffer acquires resources which the transfer queue released.
+        if (command_buffer.transfer_wait_value != 0)
         {
-            submit_info.pWaitSemaphoreInfos     = &wait_semaphore_info;
-            submit_info.waitSemaphoreInfoCount  = 1;
+            wait_semaphore_infos[wait_semaphore_count++] = make_semaphore_info (
+                queueContext(QueueType::eTransfer).timeline_semaphore_handle,
+                command_buffer.transfer_wait_value
+            );
         }
 
-        const auto signal_semaphore_info = make_semaphore_info(signal_semaphore_handle);
-        if (signal_semaphore_handle != VK_NULL_HANDLE)
+        submit_info.pWaitSemaphoreInfos     = wait_semaphore_infos.data();
+        submit_info.waitSemaphoreInfoCount  = wait_semaphore_count;
+
+        const auto value = ++context.timeline_value;
+
+        const std::array signal_semaphore_infos
         {
-            submit_info.pSignalSemaphoreInfos       = &signal_semaphore_info;
-            submit_info.signalSemaphoreInfoCount    = 1;
-        }
+            make_semaphore_info(context.timeline_semaphore_handle, value),
+            make_semaphore_info(signal_semaphore_handle)
+        };
 
-        VK_CHECK(vkQueueSubmit2(_general_queue.handle, 1, &submit_info, fence_handle));
+        submit_info.pSignalSemaphoreInfos       = signal_semaphore_infos.data();
+        submit_info.signalSemaphoreInfoCount    = signal_semaphore_handle != VK_NULL_HANDLE ? 2 : 1;
+
+        VK_CHECK(vkQueueSubmit2(context.queue.handle, 1, &submit_info, VK_NULL_HANDLE));
+
+        releaseCompletedCommandBuffers(context);
+
+        return value;
+    }
+
+    void Device::wait(uint64_t value, QueueType type, uint64_t timeout) const
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        vk::wait(_device_handle, queueContext(type).timeline_semaphore_handle, value, timeout);
+    }
+
+    uint64_t Device::completedValue(QueueType type) const
+    {
+        return counterValue(_device_handle, queueContext(type).timeline_semaphore_handle);
+    }
+
+    uint64_t Device::submittedValue(QueueType type) const noexcept
+    {
+        return queueContext(type).timeline_value;
+    }
+
+    void Device::retire(CommandBuffer&& command_buffer, uint64_t value)
+    {
+        auto& context = queueContext(command_buffer.queue_type);
+        context.retired_command_buffers.emplace_back(value, std::move(command_buffer));
+    }
+
+    void Device::retire(BufferHandle&& buffer_handle, uint64_t setup_batch)
+    {
+        retireResource(RetiredResource {.buffer_handle = std::move(buffer_handle)}, setup_batch);
+    }
+
+    void Device::retire(ImageHandle&& image_handle, ImageViewHandle&& image_view_handle, uint64_t setup_batch)
+    {
+        retireResource (
+            RetiredResource
+            {
+                .image_handle       = std::move(image_handle),
+                .image_view_handle  = std::move(image_view_handle)
+            },
+            setup_batch
+        );
+    }
+
+    void Device::retireResource(RetiredResource&& resource, uint64_t setup_batch)
+    {
+        for (size_t i = 0; i < resource.values.size(); ++i)
+            resource.values[i] = _queues[i].timeline_value;
+
+        /// The pending setup commands are the next submit to the general queue.
+        if (isSetupBatchPending(setup_batch))
+            ++resource.values[static_cast<size_t>(QueueType::eGeneral)];
+
+        _retired_resources.push_back(std::move(resource));
+    }
+
+    void Device::releaseCompletedResources()
+    {
+        if (_retired_resources.empty())
+            return ;
+
+        std::array<uint64_t, static_cast<size_t>(QueueType::eCount)> completed_values;
+
+        for (size_t i = 0; i < completed_values.size(); ++i)
+            completed_values[i] = counterValue(_device_handle, _queues[i].timeline_semaphore_handle);
+
+        const auto is_complete = [&completed_values] (const RetiredResource& resource)
+        {
+            for (size_t i = 0; i < completed_values.size(); ++i)
+            {
+                if (resource.values[i] > completed_values[i])
+                    return false;
+            }
+
+            return true;
+        };
+
+        /// Values are retired almost in the submission order, a later resource waits for the earlier ones.
+        while (!_retired_resources.empty() && is_complete(_retired_resources.front()))
+            _retired_resources.pop_front();
+    }
+
+    void Device::releaseCompletedCommandBuffers(QueueContext& context)
+    {
+        if (context.retired_command_buffers.empty())
+            return ;
+
+        const auto completed_value = counterValue(_device_handle, context.timeline_semaphore_handle);
+
+        /// Values are retired in the submission order.
+        while (!context.retired_command_buffers.empty() && context.retired_command_buffers.front().first <= completed_value)
+            context.retired_command_buffers.pop_front();
     }
 }
 
@@ -598,6 +1127,9 @@ namespace pbrlib::backend::vk
             _device_functions.vkCmdDebugMarkerBeginEXT = loadFunction<PFN_vkCmdDebugMarkerBeginEXT>(_device_handle, "vkCmdDebugMarkerBeginEXT");
             _device_functions.vkCmdDebugMarkerEndEXT   = loadFunction<PFN_vkCmdDebugMarkerEndEXT>(_device_handle, "vkCmdDebugMarkerEndEXT");
         }
+
+        if (_present_wait_is_supported)
+            _device_functions.vkWaitForPresentKHR = loadFunction<PFN_vkWaitForPresentKHR>(_device_handle, "vkWaitForPresentKHR");
     }
 
     void Device::loadInstanceFunctions()
@@ -782,28 +1314,41 @@ namespace pbrlib::backend::vk
         );
     }
 
-    vk::SamplerHandle Device::createLinearSampler()
+    VkSampler Device::sampler(const VkSamplerCreateInfo& create_info)
+    {
+        if (create_info.pNext) [[unlikely]]
+            throw exception::InvalidArgument("[vk-device] samplers with extension structures aren't cached");
+
+        return _samplers.get(SamplerKey(create_info), [this] (const SamplerKey& key)
+        {
+            SamplerHandle sampler_handle;
+
+            VK_CHECK(vkCreateSampler (
+                _device_handle,
+                &key.create_info,
+                nullptr,
+                &sampler_handle.handle()
+            ));
+
+            return sampler_handle;
+        });
+    }
+
+    VkSampler Device::linearSampler()
     {
         constexpr VkSamplerCreateInfo sampler_create_info
         {
             .sType          = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
             .magFilter      = VK_FILTER_LINEAR,
-            .minFilter      = VK_FILTER_LINEAR
+            .minFilter      = VK_FILTER_LINEAR,
+            .mipmapMode     = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+            .maxLod         = VK_LOD_CLAMP_NONE
         };
 
-        vk::SamplerHandle sampler_handle;
-
-        VK_CHECK(vkCreateSampler (
-            _device_handle,
-            &sampler_create_info,
-            nullptr,
-            &sampler_handle.handle()
-        ));
-
-        return sampler_handle;
+        return sampler(sampler_create_info);
     }
 
-    vk::SamplerHandle Device::createNearestSampler()
+    VkSampler Device::nearestSampler()
     {
         constexpr VkSamplerCreateInfo sampler_create_info
         {
@@ -812,16 +1357,89 @@ namespace pbrlib::backend::vk
             .minFilter      = VK_FILTER_NEAREST
         };
 
-        vk::SamplerHandle sampler_handle;
+        return sampler(sampler_create_info);
+    }
 
-        VK_CHECK(vkCreateSampler (
-            _device_handle,
-            &sampler_create_info,
-            nullptr,
-            &sampler_handle.handle()
-        ));
+    VkDescriptorSetLayout Device::descriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings)
+    {
+        if (bindings.empty()) [[unlikely]]
+            throw exception::InvalidArgument("[vk-device] bindings count is 0");
+
+        DescriptorSetLayoutKey key;
+        key.bindings.assign(std::begin(bindings), std::end(bindings));
+
+        return _descriptor_set_layouts.get(key, [this] (const DescriptorSetLayoutKey& key)
+        {
+            const std::vector<VkDescriptorBindingFlags> bindings_flags (key.bindings.size(), VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT);
+
+            const VkDescriptorSetLayoutBindingFlagsCreateInfo set_layout_binding_flags_create_info
+            {
+                .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+                .bindingCount   = static_cast<uint32_t>(bindings_flags.size()),
+                .pBindingFlags  = bindings_flags.data()
+            };
+
+            const VkDescriptorSetLayoutCreateInfo desc_set_create_info
+            {
+                .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .pNext          = &set_layout_binding_flags_create_info,
+                .flags          = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT,
+                .bindingCount   = static_cast<uint32_t>(key.bindings.size()),
+                .pBindings      = key.bindings.data()
+            };
+
+            DescriptorSetLayoutHandle set_layout_handle;
+
+            VK_CHECK(vkCreateDescriptorSetLayout(
+                _device_handle,
+                &desc_set_create_info,
+                nullptr,
+                &set_layout_handle.handle()
+            ));
+
+            return set_layout_handle;
+        });
+    }
+
+    VkPipelineLayout Device::pipelineLayout (
+        std::span<const VkDescriptorSetLayout>      set_layouts,
+        const std::optional<VkPushConstantRange>&   push_constant
+    )
+    {
+        PipelineLayoutKey key;
+        key.set_layouts.assign(std::begin(set_layouts), std::end(set_layouts));
+        key.push_constant = push_constant;
+
+        return _pipeline_layouts.get(key, [this] (const PipelineLayoutKey& key)
+        {
+            VkPipelineLayoutCreateInfo pipeline_layout_create_info
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO
+            };
+
+            if (!key.set_layouts.empty())
+            {
+                pipeline_layout_create_info.setLayoutCount  = static_cast<uint32_t>(key.set_layouts.size());
+                pipeline_layout_create_info.pSetLayouts     = key.set_layouts.data();
+            }
+
+            if (key.push_constant)
+            {
+                pipeline_layout_create_info.pushConstantRangeCount  = 1;
+                pipeline_layout_create_info.pPushConstantRanges     = &key.push_constant.value();
+            }
+
+            PipelineLayoutHandle layout_handle;
+
+            VK_CHECK(vkCreatePipelineLayout(
+                _device_handle,
+                &pipeline_layout_create_info,
+                nullptr,
+                &layout_handle.handle()
+            ));
 
-        return sampler_handle;
+            return layout_handle;
+        });
     }
 }
 
@@ -834,7 +1452,7 @@ namespace pbrlib::backend::vk
         auto tracy_ctx_handle = TracyVkContext(
             _physical_device_handle,
             _device_handle,
-            _general_queue.handle,
+            queue().handle,
             tracy_setup_command_buffer.handle
         );
 
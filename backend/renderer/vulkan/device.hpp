@@ -2,9 +2,17 @@
 
 #include <backend/renderer/vulkan/unique_handler.hpp>
 #include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/object_cache.hpp>
 
 #include <string_view>
 
+#include <array>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace pbrlib::backend
@@ -32,6 +40,8 @@ namespace pbrlib::backend::vk
 
         PFN_vkCmdDebugMarkerBeginEXT    vkCmdDebugMarkerBeginEXT    = VK_NULL_HANDLE;
         PFN_vkCmdDebugMarkerEndEXT      vkCmdDebugMarkerEndEXT      = VK_NULL_HANDLE;
+
+        PFN_vkWaitForPresentKHR vkWaitForPresentKHR = VK_NULL_HANDLE;
     };
 
     struct InstanceFunctions final
@@ -40,6 +50,24 @@ namespace pbrlib::backend::vk
         PFN_vkDestroyDebugUtilsMessengerEXT vkDestroyDebugUtilsMessengerEXT = VK_NULL_HANDLE;
     };
 
+    /// Usage classes of the custom VMA pools. Resources of one class are sub-allocated
+    /// from shared memory blocks, dedicated memory is used only when the driver prefers it.
+    enum class MemoryPoolType : uint8_t
+    {
+        eRenderTargets,
+        eGeometry,
+        eTextures,
+        eStaging,
+
+        eCount
+    };
+
+    struct MemoryBudget final
+    {
+        VkDeviceSize usage  = 0;
+        VkDeviceSize budget = 0;
+    };
+
     struct DescriptorImageInfo final
     {
         VkImageView     view_handle             = VK_NULL_HANDLE;
@@ -62,14 +90,46 @@ namespace pbrlib::backend::vk
 
     class Device final
     {
-        void getGeneralQueueIndex();
+        /// Per queue state, the types without a dedicated family share the general VkQueue.
+        struct QueueContext final
+        {
+            Queue               queue;
+            CommandPoolHandle   command_pool_handle;
+
+            SemaphoreHandle timeline_semaphore_handle;
+            uint64_t        timeline_value = 0;
+
+            std::deque<std::pair<uint64_t, CommandBuffer>> retired_command_buffers;
+        };
+
+        /// Handles of a destroyed buffer or image and the values of every timeline which complete its last use.
+        struct RetiredResource final
+        {
+            std::array<uint64_t, static_cast<size_t>(QueueType::eCount)> values;
+
+            BufferHandle    buffer_handle;
+            ImageHandle     image_handle;
+            ImageViewHandle image_view_handle;
+        };
+
+        void getQueueIndices();
 
         void createInstance(bool is_debug);
         void setupDebugUtilsMessenger();
         void getPhysicalDevice();
         void createDevice();
         void createGpuAllocator();
+        void createMemoryPools();
         void createCommandPools();
+        void createTimelineSemaphores();
+
+        void releaseCompletedCommandBuffers(QueueContext& context);
+        void releaseCompletedResources();
+
+        void retireResource(RetiredResource&& resource, uint64_t setup_batch);
+
+        [[nodiscard]] QueueContext&         queueContext(QueueType type) noexcept;
+        [[nodiscard]] const QueueContext&   queueContext(QueueType type) const noexcept;
 
         void loadDeviceFunctions();
         void loadInstanceFunctions();
@@ -77,13 +137,15 @@ namespace pbrlib::backend::vk
         void createDescriptorPool();
 
         bool isRunFromFrameDebugger() const;
+        bool isExtensionSupported(std::string_view extension_name) const;
+        bool isPresentWaitSupported() const;
 
         void createTracyContext();
 
         std::vector<const char*> instanceExtensions();
 
     public:
-        Device() = default;
+        Device();
 
         Device(Device&& device)      = delete;
         Device(const Device& device) = delete;
@@ -103,11 +165,29 @@ namespace pbrlib::backend::vk
 
         [[nodiscard]] const VkPhysicalDeviceProperties2& gpuProperties() const noexcept;
 
-        [[nodiscard]] const Queue& queue()  const noexcept;
+        [[nodiscard]] const Queue& queue()                  const noexcept;
+        [[nodiscard]] const Queue& queue(QueueType type)    const noexcept;
+
+        /// The type has its own queue family, resources used by it and the general queue need ownership transfers.
+        [[nodiscard]] bool hasDedicatedQueue(QueueType type) const noexcept;
 
         [[nodiscard]] VmaAllocator vmaAllocator() const noexcept;
 
-        [[nodiscard]] CommandBuffer oneTimeSubmitCommandBuffer(std::string_view name = "");
+        /// Usage and budget of the device local heaps. When VK_EXT_memory_budget
+        /// isn't supported VMA estimates them from its own allocations.
+        [[nodiscard]] MemoryBudget memoryBudget() const;
+
+        [[nodiscard]] VmaPool memoryPool(MemoryPoolType type) const noexcept;
+
+        /// VK_KHR_present_id and VK_KHR_present_wait are enabled.
+        [[nodiscard]] bool presentWaitSupported() const noexcept;
+
+        [[nodiscard]] CommandBuffer oneTimeSubmitCommandBuffer(std::string_view name = "", QueueType type = QueueType::eGeneral);
+
+        /// The general queue acquires a resource released by the transfer queue. The barrier is recorded
+        /// into the setup command buffer, whose submit waits for release_value of the transfer timeline.
+        void acquireOnGeneralQueue(const VkBufferMemoryBarrier2& barrier, uint64_t release_value);
+        void acquireOnGeneralQueue(const VkImageMemoryBarrier2& barrier, uint64_t release_value);
 
         [[nodiscard]] DescriptorSetHandle allocateDescriptorSet(VkDescriptorSetLayout desc_set_layout_handle, std::string_view name = "") const;
 
@@ -116,15 +196,58 @@ namespace pbrlib::backend::vk
 
         void setName(const VkDebugUtilsObjectNameInfoEXT& name_info) const;
 
+        /// General command buffer which collects the standalone layout transitions and copies.
+        /// It is submitted by flushSetupCommands() or right before the next submit of any queue.
+        /// Every call serializes the next commands after the already recorded and submitted ones.
+        [[nodiscard]] CommandBuffer& setupCommandBuffer();
+
+        /// Increases with every flush. A resource which records into the setup command buffer
+        /// remembers the batch, so its handles are retired until the commands which use it complete.
+        [[nodiscard]] uint64_t setupBatch() const noexcept;
+        [[nodiscard]] bool isSetupBatchPending(uint64_t batch) const noexcept;
+
+        /// Keeps the staging buffer alive until the setup commands which read it are complete.
+        void retireWithSetupCommands(Buffer&& staging_buffer);
+
+        /// Submits the recorded setup commands without waiting and returns the value
+        /// of the general timeline which completes them, 0 if nothing was recorded.
+        uint64_t flushSetupCommands();
+
+        /// Submits and blocks until the command buffer is complete.
         void submit(const CommandBuffer& command_buffer);
 
-        void submit (
+        /// Submits to the queue of the command buffer. Every submit signals the timeline semaphore
+        /// of that queue with the next value and returns it. The command buffer is complete
+        /// once completedValue() of the queue reaches the returned value. Pending setup commands
+        /// are flushed first and the submit waits for them on the general timeline.
+        uint64_t submit (
             const CommandBuffer&    command_buffer,
             VkSemaphore             wait_semaphore_handle,
-            VkSemaphore             signal_semaphore_handle,
-            VkFence                 fence_handle
+            VkSemaphore             signal_semaphore_handle
         );
 
+        /// Blocks until the submit which returned value is complete.
+        void wait (
+            uint64_t    value,
+            QueueType   type    = QueueType::eGeneral,
+            uint64_t    timeout = std::numeric_limits<uint64_t>::max()
+        ) const;
+
+        /// Value of the last complete submit, doesn't block.
+        [[nodiscard]] uint64_t completedValue(QueueType type = QueueType::eGeneral) const;
+
+        /// Value which the last submit to the queue signals. Resources used by the submitted
+        /// command buffers may be destroyed once completedValue() reaches it.
+        [[nodiscard]] uint64_t submittedValue(QueueType type = QueueType::eGeneral) const noexcept;
+
+        /// Keeps the command buffer alive until the submit which returned value is complete.
+        void retire(CommandBuffer&& command_buffer, uint64_t value);
+
+        /// Destroys the handles of a buffer or an image once the submits which may use them are complete:
+        /// everything already submitted to any queue and the setup commands of setup_batch if it is pending.
+        void retire(BufferHandle&& buffer_handle, uint64_t setup_batch);
+        void retire(ImageHandle&& image_handle, ImageViewHandle&& image_view_handle, uint64_t setup_batch);
+
         void writeDescriptorSet(const DescriptorImageInfo& descriptor_image_info)   const;
         void writeDescriptorSet(const DescriptorBufferInfo& descriptor_buffer_info) const;
 
@@ -134,8 +257,18 @@ namespace pbrlib::backend::vk
         [[nodiscard]]
         const uint8_t workGroupSize() const noexcept;
 
-        [[nodiscard]] vk::SamplerHandle createLinearSampler();
-        [[nodiscard]] vk::SamplerHandle createNearestSampler();
+        /// The samplers and layouts are cached, identical create infos return the same handle.
+        /// The device owns them, they are valid until it is destroyed.
+        [[nodiscard]] VkSampler sampler(const VkSamplerCreateInfo& create_info);
+        [[nodiscard]] VkSampler linearSampler();
+        [[nodiscard]] VkSampler nearestSampler();
+
+        [[nodiscard]] VkDescriptorSetLayout descriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+
+        [[nodiscard]] VkPipelineLayout pipelineLayout (
+            std::span<const VkDescriptorSetLayout>      set_layouts,
+            const std::optional<VkPushConstantRange>&   push_constant
+        );
 
 #ifdef PBRLIB_ENABLE_PROFILING
         [[nodiscard]] auto tracyContext() const noexcept
@@ -153,17 +286,35 @@ namespace pbrlib::backend::vk
 
         VkPhysicalDeviceProperties2 _gpu_properties = { };
 
-        Queue               _general_queue;
-        CommandPoolHandle   _command_pool_for_general_queue;
-        FenceHandle         _submit_fence_handle;
+        std::array<QueueContext, static_cast<size_t>(QueueType::eCount)> _queues;
 
         AllocatorHandle _allocator_handle;
 
+        std::array<MemoryPoolHandle, static_cast<size_t>(MemoryPoolType::eCount)> _memory_pools;
+
+        /// Declared before the staging buffers, which retire their handles here when they are destroyed.
+        std::deque<RetiredResource> _retired_resources;
+
+        /// Declared after the allocator, the staging buffers are destroyed before it.
+        std::optional<CommandBuffer>            _setup_command_buffer;
+        std::vector<std::unique_ptr<Buffer>>    _setup_staging_buffers;
+        uint64_t                                _setup_batch = 1;
+
+        /// Staging buffers of the flushed setup commands and the general timeline value which completes them.
+        std::deque<std::pair<uint64_t, std::vector<std::unique_ptr<Buffer>>>> _retired_staging_buffers;
+
+        bool _memory_budget_is_supported    = false;
+        bool _present_wait_is_supported     = false;
+
         DeviceFunctions     _device_functions;
         InstanceFunctions   _instance_functions;
 
         DescriptorPoolHandle _descriptor_pool_handle;
 
+        ObjectCache<SamplerKey, SamplerHandle>                          _samplers;
+        ObjectCache<DescriptorSetLayoutKey, DescriptorSetLayoutHandle>  _descriptor_set_layouts;
+        ObjectCache<PipelineLayoutKey, PipelineLayoutHandle>            _pipeline_layouts;
+
         DebugUtilsMessengerHandle _debug_utils_messenger_handle;
 
 #ifdef PBRLIB_ENABLE_PROFILING
@@ -20,4 +20,6 @@ namespace pbrlib::backend::vk::marker_colors
     constexpr auto fxaa             = generateColor(9);
 
     constexpr auto clear = generateColor(10);
+
+    constexpr auto upscale = generateColor(11);
 }
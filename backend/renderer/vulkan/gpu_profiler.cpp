@@ -0,0 +1,151 @@
+#include <backend/renderer/vulkan/gpu_profiler.hpp>
+#include <backend/renderer/vulkan/command_buffer.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/renderer/vulkan/check.hpp>
+
+#include <backend/logger/logger.hpp>
+
+#include <pbrlib/exceptions.hpp>
+
+#include <ranges>
+
+namespace pbrlib::backend::vk
+{
+    GPUProfiler::GPUProfiler(const Device& device, uint32_t frames_in_flight, uint32_t max_pass_count) :
+        _device             (device),
+        _max_pass_count     (max_pass_count),
+        _timestamp_period   (device.limits().timestampPeriod)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!device.limits().timestampComputeAndGraphics) [[unlikely]]
+        {
+            log::warning("[vk-gpu-profiler] timestamps aren't supported, render passes won't be measured");
+            return ;
+        }
+
+        const VkQueryPoolCreateInfo create_info
+        {
+            .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = max_pass_count * 2
+        };
+
+        _frames.resize(frames_in_flight);
+
+        for (auto& frame: _frames)
+        {
+            VkQueryPool query_pool_handle = VK_NULL_HANDLE;
+
+            VK_CHECK(vkCreateQueryPool(_device.device(), &create_info, nullptr, &query_pool_handle));
+
+            if (query_pool_handle == VK_NULL_HANDLE) [[unlikely]]
+                throw exception::InitializeError("[vk-gpu-profiler] failed create query pool");
+
+            frame.query_pool_handle = QueryPoolHandle(query_pool_handle);
+            frame.recorded_passes.reserve(max_pass_count);
+        }
+
+        _query_results.resize(max_pass_count * 2);
+    }
+
+    void GPUProfiler::beginFrame(CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        if (_frames.empty()) [[unlikely]]
+            return ;
+
+        _frame_index = frame_index;
+
+        auto& frame = _frames[_frame_index];
+        frame.recorded_passes.clear();
+
+        command_buffer.write([this, &frame] (VkCommandBuffer command_buffer_handle)
+        {
+            vkCmdResetQueryPool(command_buffer_handle, frame.query_pool_handle, 0, _max_pass_count * 2);
+        });
+    }
+
+    void GPUProfiler::beginPass(CommandBuffer& command_buffer, std::string_view name)
+    {
+        if (_frames.empty()) [[unlikely]]
+            return ;
+
+        auto& frame = _frames[_frame_index];
+
+        if (frame.recorded_passes.size() == _max_pass_count) [[unlikely]]
+            return ;
+
+        const auto query = static_cast<uint32_t>(frame.recorded_passes.size() * 2);
+
+        frame.recorded_passes.emplace_back(name);
+        _is_pass_open = true;
+
+        command_buffer.write([&frame, query] (VkCommandBuffer command_buffer_handle)
+        {
+            vkCmdWriteTimestamp2(command_buffer_handle, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, frame.query_pool_handle, query);
+        });
+    }
+
+    void GPUProfiler::endPass(CommandBuffer& command_buffer)
+    {
+        if (!_is_pass_open)
+            return ;
+
+        _is_pass_open = false;
+
+        auto& frame = _frames[_frame_index];
+
+        const auto query = static_cast<uint32_t>(frame.recorded_passes.size() * 2 - 1);
+
+        command_buffer.write([&frame, query] (VkCommandBuffer command_buffer_handle)
+        {
+            vkCmdWriteTimestamp2(command_buffer_handle, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, frame.query_pool_handle, query);
+        });
+    }
+
+    void GPUProfiler::collect(uint32_t frame_index)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (_frames.empty()) [[unlikely]]
+            return ;
+
+        auto& frame = _frames[frame_index];
+
+        const auto pass_count = static_cast<uint32_t>(frame.submitted_passes.size());
+
+        if (pass_count > 0)
+        {
+            const auto result = vkGetQueryPoolResults (
+                _device.device(),
+                frame.query_pool_handle,
+                0, pass_count * 2,
+                pass_count * 2 * sizeof(uint64_t),
+                _query_results.data(),
+                sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT
+            );
+
+            /// The queries of a frame are read only when its slot is reused, VK_NOT_READY keeps the old timings.
+            if (result == VK_SUCCESS) [[likely]]
+            {
+                _timings.resize(pass_count);
+
+                for (const auto i: std::views::iota(0u, pass_count))
+                {
+                    const auto ticks = _query_results[i * 2 + 1] - _query_results[i * 2];
+
+                    _timings[i].name            = frame.submitted_passes[i];
+                    _timings[i].milliseconds    = static_cast<double>(ticks) * _timestamp_period * 1e-6;
+                }
+            }
+        }
+
+        std::swap(frame.submitted_passes, frame.recorded_passes);
+    }
+
+    std::span<const PassTiming> GPUProfiler::timings() const noexcept
+    {
+        return _timings;
+    }
+}
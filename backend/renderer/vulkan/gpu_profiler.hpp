@@ -0,0 +1,63 @@
+#pragma once
+
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <pbrlib/pass_timing.hpp>
+
+#include <span>
+#include <vector>
+
+#include <string>
+#include <string_view>
+
+namespace pbrlib::backend::vk
+{
+    class Device;
+    class CommandBuffer;
+}
+
+namespace pbrlib::backend::vk
+{
+    /// Measures render passes with timestamp queries, a query pool per frame in flight.
+    /// The results of a frame are read when its slot is reused, so the CPU never waits for them.
+    class GPUProfiler final
+    {
+        struct Frame final
+        {
+            QueryPoolHandle query_pool_handle;
+
+            std::vector<std::string> recorded_passes;
+            std::vector<std::string> submitted_passes;
+        };
+
+    public:
+        GPUProfiler(const Device& device, uint32_t frames_in_flight, uint32_t max_pass_count = 64);
+
+        /// Resets the queries of the frame, must be recorded before the first pass.
+        void beginFrame(CommandBuffer& command_buffer, uint32_t frame_index);
+
+        void beginPass(CommandBuffer& command_buffer, std::string_view name);
+        void endPass(CommandBuffer& command_buffer);
+
+        /// Called once the previous submit of the frame has completed and before the next one.
+        void collect(uint32_t frame_index);
+
+        [[nodiscard]] std::span<const PassTiming> timings() const noexcept;
+
+    private:
+        const Device& _device;
+
+        std::vector<Frame> _frames;
+
+        uint32_t _frame_index       = 0;
+        uint32_t _max_pass_count    = 0;
+
+        bool _is_pass_open = false;
+
+        /// Nanoseconds per tick of the timestamp.
+        double _timestamp_period = 1.0;
+
+        std::vector<uint64_t>   _query_results;
+        std::vector<PassTiming> _timings;
+    };
+}
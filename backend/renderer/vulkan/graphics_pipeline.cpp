@@ -67,6 +67,21 @@ namespace pbrlib::backend::vk::utils
         return VK_FRONT_FACE_MAX_ENUM;
     }
 
+    VkCompareOp cast(CompareOp op) noexcept
+    {
+        switch (op)
+        {
+            case CompareOp::eLess:
+                return VK_COMPARE_OP_LESS;
+            case CompareOp::eLessOrEqual:
+                return VK_COMPARE_OP_LESS_OR_EQUAL;
+            case CompareOp::eEqual:
+                return VK_COMPARE_OP_EQUAL;
+        };
+
+        return VK_COMPARE_OP_MAX_ENUM;
+    }
+
     VkSampleCountFlagBits cast(SampleCount count) noexcept
     {
         switch (count)
@@ -189,6 +204,18 @@ namespace pbrlib::backend::vk::builders
         return *this;
     }
 
+    GraphicsPipeline& GraphicsPipeline::depthWrite(bool is_enable) noexcept
+    {
+        _enable_depth_write = is_enable;
+        return *this;
+    }
+
+    GraphicsPipeline& GraphicsPipeline::depthCompareOp(CompareOp op) noexcept
+    {
+        _depth_compare_op = op;
+        return *this;
+    }
+
     GraphicsPipeline& GraphicsPipeline::pipelineLayoutHandle(VkPipelineLayout layout_handle) noexcept
     {
         _pipeline_layout_handle = layout_handle;
@@ -207,6 +234,18 @@ namespace pbrlib::backend::vk::builders
         return *this;
     }
 
+    GraphicsPipeline& GraphicsPipeline::addColorAttachmentFormat(VkFormat format)
+    {
+        _color_attachment_formats.push_back(format);
+        return *this;
+    }
+
+    GraphicsPipeline& GraphicsPipeline::depthAttachmentFormat(VkFormat format) noexcept
+    {
+        _depth_attachment_format = format;
+        return *this;
+    }
+
     GraphicsPipeline& GraphicsPipeline::addDefine(const vk::shader::Define& define)
     {
         _defines.push_back(define);
@@ -218,11 +257,18 @@ namespace pbrlib::backend::vk::builders
         if (_pipeline_layout_handle == VK_NULL_HANDLE) [[unlikely]]
             throw exception::InvalidState("[vk-graphics-pipeline-builder] pipeline layout handle is null");
 
-        if (_render_pass_handle == VK_NULL_HANDLE) [[unlikely]]
-            throw exception::InvalidState("[vk-graphics-pipeline-builder] render pass handle is null");
+        const bool is_dynamic_rendering = !_color_attachment_formats.empty() || _depth_attachment_format != VK_FORMAT_UNDEFINED;
 
-        if (_subpass == std::numeric_limits<uint32_t>::max()) [[unlikely]]
-            throw exception::InvalidState("[vk-graphics-pipeline-builder] subpass index didn't set");
+        if (!is_dynamic_rendering)
+        {
+            if (_render_pass_handle == VK_NULL_HANDLE) [[unlikely]]
+                throw exception::InvalidState("[vk-graphics-pipeline-builder] render pass handle is null");
+
+            if (_subpass == std::numeric_limits<uint32_t>::max()) [[unlikely]]
+                throw exception::InvalidState("[vk-graphics-pipeline-builder] subpass index didn't set");
+        }
+        else if (_render_pass_handle != VK_NULL_HANDLE) [[unlikely]]
+            throw exception::InvalidState("[vk-graphics-pipeline-builder] render pass is set with the formats of dynamic rendering");
 
         constexpr VkPipelineVertexInputStateCreateInfo vertex_input_state =
         {
@@ -260,12 +306,12 @@ namespace pbrlib::backend::vk::builders
             .rasterizationSamples   = utils::cast(_sample_count)
         };
 
-        constexpr VkPipelineDepthStencilStateCreateInfo depth_stencil_state =
+        const VkPipelineDepthStencilStateCreateInfo depth_stencil_state =
         {
             .sType              = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
             .depthTestEnable    = VK_TRUE,
-            .depthWriteEnable   = VK_TRUE,
-            .depthCompareOp     = VK_COMPARE_OP_LESS,
+            .depthWriteEnable   = utils::cast(_enable_depth_write),
+            .depthCompareOp     = utils::cast(_depth_compare_op),
             .stencilTestEnable  = VK_FALSE,
             .minDepthBounds     = 0.0f,
             .maxDepthBounds     = 1.0f
@@ -311,6 +357,20 @@ namespace pbrlib::backend::vk::builders
             .subpass                = _subpass
         };
 
+        const VkPipelineRenderingCreateInfo rendering_create_info =
+        {
+            .sType                      = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+            .colorAttachmentCount       = static_cast<uint32_t>(_color_attachment_formats.size()),
+            .pColorAttachmentFormats    = _color_attachment_formats.data(),
+            .depthAttachmentFormat      = _depth_attachment_format
+        };
+
+        if (is_dynamic_rendering)
+        {
+            pipeline_create_info.pNext      = &rendering_create_info;
+            pipeline_create_info.subpass    = 0;
+        }
+
         if (_enable_depth_stencil_test)
             pipeline_create_info.pDepthStencilState = &depth_stencil_state;
 
@@ -45,6 +45,14 @@ namespace pbrlib::backend::vk
         eCounterClockwise
     };
 
+    enum class CompareOp :
+        uint8_t
+    {
+        eLess,
+        eLessOrEqual,
+        eEqual
+    };
+
     enum class SampleCount :
         uint8_t
     {
@@ -82,13 +90,19 @@ namespace pbrlib::backend::vk::builders
         GraphicsPipeline& frontFace(FrontFace front_face)               noexcept;
         GraphicsPipeline& sampleCount(SampleCount count)                noexcept;
 
-        GraphicsPipeline& depthStencilTest(bool is_enable) noexcept;
+        GraphicsPipeline& depthStencilTest(bool is_enable)  noexcept;
+        GraphicsPipeline& depthWrite(bool is_enable)        noexcept;
+        GraphicsPipeline& depthCompareOp(CompareOp op)      noexcept;
 
         GraphicsPipeline& pipelineLayoutHandle(VkPipelineLayout layout_handle)  noexcept;
         GraphicsPipeline& renderPassHandle(VkRenderPass render_pass_handle)     noexcept;
 
         GraphicsPipeline& subpass(uint32_t subpass_index) noexcept;
 
+        /// Formats of the attachments bound by vkCmdBeginRendering, used instead of the render pass.
+        GraphicsPipeline& addColorAttachmentFormat(VkFormat format);
+        GraphicsPipeline& depthAttachmentFormat(VkFormat format) noexcept;
+
         GraphicsPipeline& addDefine(const vk::shader::Define& define);
 
         [[nodiscard]] PipelineHandle build();
@@ -103,13 +117,18 @@ namespace pbrlib::backend::vk::builders
 
         SampleCount _sample_count = SampleCount::e1;
 
-        bool _enable_depth_stencil_test = false;
+        bool        _enable_depth_stencil_test  = false;
+        bool        _enable_depth_write         = true;
+        CompareOp   _depth_compare_op           = CompareOp::eLess;
 
         VkPipelineLayout    _pipeline_layout_handle = VK_NULL_HANDLE;
         VkRenderPass        _render_pass_handle     = VK_NULL_HANDLE;
 
         uint32_t _subpass = std::numeric_limits<uint32_t>::max();
 
+        std::vector<VkFormat>   _color_attachment_formats;
+        VkFormat                _depth_attachment_format = VK_FORMAT_UNDEFINED;
+
         std::vector<VkPipelineShaderStageCreateInfo>        _stages;
         std::vector<VkPipelineColorBlendAttachmentState>    _attachments_state;
         std::vector<VkSpecializationInfo>                   _specialization_infos;
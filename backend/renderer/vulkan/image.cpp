@@ -40,7 +40,10 @@ namespace pbrlib::backend::vk
         format      (image.format),
         level_count (image.level_count),
         layer_count (image.layer_count),
-        layout      (image.layout)
+        layout      (image.layout),
+        _last_stage (image._last_stage),
+        _last_access(image._last_access),
+        _setup_batch(image._setup_batch)
     {
         std::swap(handle, image.handle);
         std::swap(view_handle, image.view_handle);
@@ -57,16 +60,34 @@ namespace pbrlib::backend::vk
 
         layout = image.layout;
 
+        _last_stage     = image._last_stage;
+        _last_access    = image._last_access;
+
         std::swap(handle, image.handle);
         std::swap(view_handle, image.view_handle);
+        std::swap(_setup_batch, image._setup_batch);
 
         return *this;
     }
 
-    void Image::write(const ChunkyImageWriteData& data)
+    Image::~Image()
     {
-        PBRLIB_PROFILING_ZONE_SCOPED;
+        /// The swapchain owns its images, their views are destroyed along with it.
+        const auto is_own = handle.context<bool>();
 
+        /// The submitted frames and the pending setup commands may still use the image.
+        if (handle.handle() != VK_NULL_HANDLE && is_own)
+            _device.retire(std::move(handle), std::move(view_handle), _setup_batch);
+    }
+
+    CommandBuffer& Image::setupCommandBuffer()
+    {
+        _setup_batch = _device.setupBatch();
+        return _device.setupCommandBuffer();
+    }
+
+    Buffer Image::createStagingBuffer(const ChunkyImageWriteData& data) const
+    {
         const auto format_size      = formatSize(data.format);
         const auto scanline_size    = data.width * format_size;
         const auto image_size       = scanline_size * data.height;
@@ -83,49 +104,156 @@ namespace pbrlib::backend::vk
 
         staging_buffer.write(image_data, 0);
 
-        auto command_buffer = _device.oneTimeSubmitCommandBuffer("command-buffer-for-copy-buffer-to-image");
+        return staging_buffer;
+    }
+
+    void Image::copyFromBuffer(VkCommandBuffer command_buffer_handle, const Buffer& staging_buffer, const ChunkyImageWriteData& data) const
+    {
+        const auto aspect = data.format == VK_FORMAT_D32_SFLOAT ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+
+        const VkImageSubresourceLayers subresource
+        {
+            .aspectMask     = static_cast<VkImageAspectFlags>(aspect),
+            .mipLevel       = data.mip_level,
+            .baseArrayLayer = 0,
+            .layerCount     = 1
+        };
+
+        const VkBufferImageCopy2 region
+        {
+            .sType              = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
+            .bufferOffset       = 0,
+            .bufferRowLength    = static_cast<uint32_t>(data.width), // scanline_size
+            .bufferImageHeight  = static_cast<uint32_t>(data.height),
+            .imageSubresource   = subresource,
+            .imageOffset        = { },
+            .imageExtent        = {static_cast<uint32_t>(data.width), static_cast<uint32_t>(data.height), 1}
+        };
+
+        const VkCopyBufferToImageInfo2 copy_info
+        {
+            .sType          = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
+            .srcBuffer      = staging_buffer.handle,
+            .dstImage       = handle.handle(),
+            .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .regionCount    = 1,
+            .pRegions       = &region
+        };
+
+        vkCmdCopyBufferToImage2(command_buffer_handle, &copy_info);
+    }
+
+    void Image::write(const ChunkyImageWriteData& data)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        auto staging_buffer = createStagingBuffer(data);
 
         changeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-        command_buffer.write([&data, &staging_buffer, this] (VkCommandBuffer command_buffer_handle)
+        setupCommandBuffer().write([&data, &staging_buffer, this] (VkCommandBuffer command_buffer_handle)
         {
             PBRLIB_PROFILING_VK_ZONE_SCOPED(_device, command_buffer_handle, "[vk-image] write-data-in-image");
+            copyFromBuffer(command_buffer_handle, staging_buffer, data);
+        }, "[vk-image] write-data-in-image", marker_colors::write_data_in_image);
 
-            const auto aspect = data.format == VK_FORMAT_D32_SFLOAT ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        _device.retireWithSetupCommands(std::move(staging_buffer));
+    }
 
-            const VkImageSubresourceLayers subresource
-            {
-                .aspectMask     = static_cast<VkImageAspectFlags>(aspect),
-                .mipLevel       = 0,
-                .baseArrayLayer = 0,
-                .layerCount     = 1
-            };
+    void Image::upload(std::span<const ChunkyImageWriteData> levels, VkImageLayout final_layout)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (!_device.hasDedicatedQueue(QueueType::eTransfer))
+        {
+            for (const auto& level: levels)
+                write(level);
 
-            const VkBufferImageCopy2 region
+            changeLayout(final_layout);
+            return ;
+        }
+
+        std::vector<Buffer> staging_buffers;
+        staging_buffers.reserve(levels.size());
+
+        for (const auto& level: levels)
+            staging_buffers.push_back(createStagingBuffer(level));
+
+        const VkImageMemoryBarrier2 ownership_barrier
+        {
+            .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask           = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask          = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask           = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask          = VK_ACCESS_2_MEMORY_READ_BIT,
+            .oldLayout              = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout              = final_layout,
+            .srcQueueFamilyIndex    = _device.queue(QueueType::eTransfer).family_index,
+            .dstQueueFamilyIndex    = _device.queue().family_index,
+            .image                  = handle.handle(),
+            .subresourceRange       = subresourceRange()
+        };
+
+        auto command_buffer = _device.oneTimeSubmitCommandBuffer("command-buffer-for-upload-image", QueueType::eTransfer);
+
+        command_buffer.write([&levels, &staging_buffers, &ownership_barrier, this] (VkCommandBuffer command_buffer_handle)
+        {
+            /// The image isn't used yet, the transfer queue family takes it without an ownership transfer.
+            const VkImageMemoryBarrier2 to_transfer_dst
             {
-                .sType              = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
-                .bufferOffset       = 0,
-                .bufferRowLength    = static_cast<uint32_t>(data.width), // scanline_size
-                .bufferImageHeight  = static_cast<uint32_t>(data.height),
-                .imageSubresource   = subresource,
-                .imageOffset        = { },
-                .imageExtent        = {static_cast<uint32_t>(data.width), static_cast<uint32_t>(data.height), 1}
+                .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask           = VK_PIPELINE_STAGE_2_NONE,
+                .srcAccessMask          = VK_ACCESS_2_NONE,
+                .dstStageMask           = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .dstAccessMask          = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .oldLayout              = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout              = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED,
+                .image                  = handle.handle(),
+                .subresourceRange       = subresourceRange()
             };
 
-            const VkCopyBufferToImageInfo2 copy_info
+            VkDependencyInfo dependency_info
             {
-                .sType          = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
-                .srcBuffer      = staging_buffer.handle,
-                .dstImage       = handle.handle(),
-                .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .regionCount    = 1,
-                .pRegions       = &region
+                .sType                      = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount    = 1,
+                .pImageMemoryBarriers       = &to_transfer_dst
             };
 
-            vkCmdCopyBufferToImage2(command_buffer_handle, &copy_info);
-        }, "[vk-image] write-data-in-image", marker_colors::write_data_in_image);
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+
+            for (const auto i: std::views::iota(size_t(0), levels.size()))
+                copyFromBuffer(command_buffer_handle, staging_buffers[i], levels[i]);
+
+            /// The release half of the ownership transfer, the destination stage is ignored.
+            VkImageMemoryBarrier2 release_barrier = ownership_barrier;
+            release_barrier.dstStageMask    = VK_PIPELINE_STAGE_2_NONE;
+            release_barrier.dstAccessMask   = VK_ACCESS_2_NONE;
+
+            dependency_info.pImageMemoryBarriers = &release_barrier;
+
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+        }, "[vk-image] upload-on-transfer-queue", marker_colors::write_data_in_image);
+
+        const auto release_value = _device.submit(command_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+        _device.retire(std::move(command_buffer), release_value);
+
+        /// The acquire half repeats the layout transition, the source access is ignored.
+        VkImageMemoryBarrier2 acquire_barrier = ownership_barrier;
+        acquire_barrier.srcStageMask    = VK_PIPELINE_STAGE_2_NONE;
+        acquire_barrier.srcAccessMask   = VK_ACCESS_2_NONE;
+
+        _setup_batch = _device.setupBatch();
+        _device.acquireOnGeneralQueue(acquire_barrier, release_value);
 
-        _device.submit(command_buffer);
+        /// The setup commands wait for the transfer, so the staging buffers live as long as they do.
+        for (auto& staging_buffer: staging_buffers)
+            _device.retireWithSetupCommands(std::move(staging_buffer));
+
+        layout          = final_layout;
+        _last_stage     = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        _last_access    = VK_ACCESS_2_NONE;
     }
 
     template<typename PixelChannelTypePrecision>
@@ -206,10 +334,13 @@ namespace pbrlib::backend::vk
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
-        auto command_buffer = _device.oneTimeSubmitCommandBuffer("command-buffer-for-change-image-layout");
+        /// Commands around it in the setup command buffer are unknown, so no stage means all of them.
+        const auto or_all_commands = [] (VkPipelineStageFlags2 stage)
+        {
+            return stage != VK_PIPELINE_STAGE_2_NONE ? stage : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        };
 
-        changeLayout(command_buffer, new_layout, src_stage, dst_stage);
-        _device.submit(command_buffer);
+        changeLayout(setupCommandBuffer(), new_layout, or_all_commands(src_stage), or_all_commands(dst_stage));
     }
 
     void Image::changeLayout (
@@ -227,20 +358,6 @@ namespace pbrlib::backend::vk
 
             const auto family_index = _device.queue().family_index;
 
-            const auto aspect_mask =
-                    format == VK_FORMAT_D32_SFLOAT
-                ?   VK_IMAGE_ASPECT_DEPTH_BIT
-                :   VK_IMAGE_ASPECT_COLOR_BIT;
-
-            const VkImageSubresourceRange range
-            {
-                .aspectMask     = static_cast<VkImageAspectFlags>(aspect_mask),
-                .baseMipLevel   = 0,
-                .levelCount     = 1,
-                .baseArrayLayer = 0,
-                .layerCount     = 1
-            };
-
             const VkImageMemoryBarrier2 image_mem_barrier
             {
                 .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
@@ -251,7 +368,7 @@ namespace pbrlib::backend::vk
                 .srcQueueFamilyIndex    = family_index,
                 .dstQueueFamilyIndex    = family_index,
                 .image                  = handle.handle(),
-                .subresourceRange       = range
+                .subresourceRange       = subresourceRange()
             };
 
             const VkDependencyInfo dependency_info
@@ -265,6 +382,91 @@ namespace pbrlib::backend::vk
         }, "[vk-image] changle-image-layout", vk::marker_colors::change_layout);
 
         layout = new_layout;
+
+        _last_stage     = dst_stage;
+        _last_access    = VK_ACCESS_2_NONE;
+    }
+
+    VkImageSubresourceRange Image::subresourceRange() const noexcept
+    {
+        const auto aspect_mask =
+                format == VK_FORMAT_D32_SFLOAT
+            ?   VK_IMAGE_ASPECT_DEPTH_BIT
+            :   VK_IMAGE_ASPECT_COLOR_BIT;
+
+        return VkImageSubresourceRange
+        {
+            .aspectMask     = static_cast<VkImageAspectFlags>(aspect_mask),
+            .baseMipLevel   = 0,
+            .levelCount     = level_count,
+            .baseArrayLayer = 0,
+            .layerCount     = 1
+        };
+    }
+
+    std::optional<VkImageMemoryBarrier2> Image::barrier(const ImageAccess& access)
+    {
+        if (!access.isWrite() && layout == access.layout && !(_last_access & ImageAccess::write_mask))
+        {
+            _last_stage     |= access.stage;
+            _last_access    |= access.access;
+            return std::nullopt;
+        }
+
+        const auto family_index = _device.queue().family_index;
+
+        /// Only writes have to be made available, earlier reads need just the execution dependency.
+        const VkImageMemoryBarrier2 image_mem_barrier
+        {
+            .sType                  = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask           = _last_stage,
+            .srcAccessMask          = _last_access & ImageAccess::write_mask,
+            .dstStageMask           = access.stage,
+            .dstAccessMask          = access.access,
+            .oldLayout              = layout,
+            .newLayout              = access.layout,
+            .srcQueueFamilyIndex    = family_index,
+            .dstQueueFamilyIndex    = family_index,
+            .image                  = handle.handle(),
+            .subresourceRange       = subresourceRange()
+        };
+
+        layout          = access.layout;
+        _last_stage     = access.stage;
+        _last_access    = access.access;
+
+        return image_mem_barrier;
+    }
+
+    void Image::discard(VkPipelineStageFlags2 src_stage) noexcept
+    {
+        layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (src_stage != VK_PIPELINE_STAGE_2_NONE)
+        {
+            _last_stage     |= src_stage;
+            _last_access    |= VK_ACCESS_2_MEMORY_WRITE_BIT;
+        }
+    }
+
+    void pipelineBarrier(CommandBuffer& command_buffer, std::span<const VkImageMemoryBarrier2> barriers)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        if (barriers.empty())
+            return ;
+
+        command_buffer.write([barriers = std::vector(std::begin(barriers), std::end(barriers))] (VkCommandBuffer command_buffer_handle)
+        {
+            const VkDependencyInfo dependency_info
+            {
+                .sType                      = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount    = static_cast<uint32_t>(barriers.size()),
+                .pImageMemoryBarriers       = barriers.data()
+            };
+
+            vkCmdPipelineBarrier2(command_buffer_handle, &dependency_info);
+        }, "[vk-image] pipeline-barrier", vk::marker_colors::change_layout);
     }
 
     Buffer Image::fetch(std::string_view name) const
@@ -283,7 +485,8 @@ namespace pbrlib::backend::vk
             .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
             .build();
 
-        auto command_buffer = _device.oneTimeSubmitCommandBuffer("[vk-image] copy from image to buffer");
+        /// The data is read on the CPU right after, so the setup commands are flushed and waited for.
+        auto& command_buffer = _device.setupCommandBuffer();
         command_buffer.write([&buffer, this] (const auto command_buffer_handle)
         {
             constexpr VkImageSubresourceLayers color_image_subresource
@@ -314,7 +517,7 @@ namespace pbrlib::backend::vk
             vkCmdCopyImageToBuffer2(command_buffer_handle, &copy_image_to_buffer_info);
         });
 
-        _device.submit(command_buffer);
+        _device.wait(_device.flushSetupCommands());
 
         return buffer;
     }
@@ -339,6 +542,9 @@ namespace pbrlib::backend::vk::builders
 
         if (_usage == VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM) [[unlikely]]
             throw pbrlib::exception::InvalidState("[vk-image::builder] invalid usage");
+
+        if (_level_count == 0) [[unlikely]]
+            throw pbrlib::exception::InvalidState("[vk-image::builder] mip level count is zero");
     }
 
     Image& Image::size(uint32_t width, uint32_t height) noexcept
@@ -390,35 +596,40 @@ namespace pbrlib::backend::vk::builders
         return *this;
     }
 
+    Image& Image::mipLevels(uint8_t level_count) noexcept
+    {
+        _level_count = level_count;
+        return *this;
+    }
+
     Image& Image::name(std::string_view image_name)
     {
         _name = image_name;
         return *this;
     }
 
-    VkSharingMode Image::sharingMode()
+    Image& Image::aliasMemory(VmaAllocation allocation_handle, VkDeviceSize offset) noexcept
+    {
+        _alias_allocation_handle    = allocation_handle;
+        _alias_offset               = offset;
+        return *this;
+    }
+
+    VkSharingMode Image::sharingMode() const
     {
         std::unordered_set<uint32_t> families (std::begin(_queues), std::end(_queues));
         return families.size() == 1 ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
     }
 
-    vk::Image Image::build()
+    VkImageCreateInfo Image::imageCreateInfo() const
     {
-        validate();
-
-        vk::Image image (_device);
-
-        image.width     = _width;
-        image.height    = _height;
-        image.format    = _format;
-
-        const VkImageCreateInfo image_info
+        return VkImageCreateInfo
         {
             .sType                  = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
             .imageType              = VK_IMAGE_TYPE_2D,
             .format                 = _format,
             .extent                 = {_width, _height, 1},
-            .mipLevels              = 1,
+            .mipLevels              = _level_count,
             .arrayLayers            = 1,
             .samples                = _sample_count,
             .tiling                 = _tiling,
@@ -428,27 +639,99 @@ namespace pbrlib::backend::vk::builders
             .pQueueFamilyIndices    = _queues.data(),
             .initialLayout          = VK_IMAGE_LAYOUT_UNDEFINED
         };
+    }
+
+    VkMemoryRequirements Image::memoryRequirements()
+    {
+        validate();
+
+        const auto image_info = imageCreateInfo();
+
+        const VkDeviceImageMemoryRequirements requirements_info
+        {
+            .sType          = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+            .pCreateInfo    = &image_info
+        };
+
+        VkMemoryRequirements2 requirements
+        {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2
+        };
+
+        vkGetDeviceImageMemoryRequirements(_device.device(), &requirements_info, &requirements);
+
+        return requirements.memoryRequirements;
+    }
+
+    vk::Image Image::build()
+    {
+        validate();
+
+        vk::Image image (_device);
+
+        image.width         = _width;
+        image.height        = _height;
+        image.format        = _format;
+        image.level_count   = _level_count;
+
+        const auto image_info = imageCreateInfo();
 
         VmaAllocationCreateInfo alloc_info
         {
-            .flags      = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
             .usage      = VMA_MEMORY_USAGE_AUTO,
             .priority   = 1.0f
         };
 
+        constexpr VkImageUsageFlags render_target_usage =
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+            |   VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+            |   VK_IMAGE_USAGE_STORAGE_BIT;
+
         if (_tiling == VK_IMAGE_TILING_LINEAR)
             alloc_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |  VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        else if (_usage & render_target_usage)
+            alloc_info.pool = _device.memoryPool(MemoryPoolType::eRenderTargets);
+        else
+            alloc_info.pool = _device.memoryPool(MemoryPoolType::eTextures);
 
         VkImage         image_handle        = VK_NULL_HANDLE;
         VmaAllocation   allocation_handle   = VK_NULL_HANDLE;
-        VK_CHECK(vmaCreateImage(
-            _device.vmaAllocator(),
-            &image_info,
-            &alloc_info,
-            &image_handle,
-            &allocation_handle,
-            nullptr
-        ));
+
+        /// An aliasing image doesn't own its memory, so only the VkImage is destroyed with the handle.
+        const auto result = _alias_allocation_handle != VK_NULL_HANDLE
+            ?   vmaCreateAliasingImage2(
+                    _device.vmaAllocator(),
+                    _alias_allocation_handle,
+                    _alias_offset,
+                    &image_info,
+                    &image_handle
+                )
+            :   vmaCreateImage(
+                    _device.vmaAllocator(),
+                    &image_info,
+                    &alloc_info,
+                    &image_handle,
+                    &allocation_handle,
+                    nullptr
+                );
+
+        /// Some formats (e.g. depth) may require a memory type other than the one of the pool,
+        /// in this case the image is allocated from the default pools of VMA.
+        if (result == VK_ERROR_FEATURE_NOT_PRESENT && alloc_info.pool != VK_NULL_HANDLE && _alias_allocation_handle == VK_NULL_HANDLE) [[unlikely]]
+        {
+            alloc_info.pool = VK_NULL_HANDLE;
+
+            VK_CHECK(vmaCreateImage(
+                _device.vmaAllocator(),
+                &image_info,
+                &alloc_info,
+                &image_handle,
+                &allocation_handle,
+                nullptr
+            ));
+        }
+        else
+            VK_CHECK(result);
 
         image.handle = ImageHandle(image_handle, allocation_handle, true);
 
@@ -554,12 +837,8 @@ namespace pbrlib::backend::vk::decoders
             throw pbrlib::exception::InvalidState("[vk-image::decoder] compressed image data is empty");
     }
 
-    vk::Image Image::decode()
+    VkFormat Image::format() const
     {
-        PBRLIB_PROFILING_ZONE_SCOPED;
-
-        validate();
-
         constexpr std::array formats
         {
             VK_FORMAT_R8_UNORM,
@@ -568,9 +847,18 @@ namespace pbrlib::backend::vk::decoders
             VK_FORMAT_R8G8B8A8_UNORM
         };
 
+        return formats[_channels_per_pixel - 1];
+    }
+
+    vk::Image Image::decode()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        validate();
+
         ChunkyImageWriteData write_data
         {
-            .format = formats[_channels_per_pixel - 1]
+            .format = format()
         };
 
         stbi_set_flip_vertically_on_load(true);
@@ -601,6 +889,85 @@ namespace pbrlib::backend::vk::decoders
 
         return image;
     }
+
+    std::vector<ImageMipLevel> Image::decodeMipChain()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        validate();
+
+        int width   = 0;
+        int height  = 0;
+
+        /// Mip chains are decoded on the streaming threads too.
+        stbi_set_flip_vertically_on_load_thread(true);
+
+        const auto ptr_data = stbi_load_from_memory(
+            _compressed_image.ptr_data,
+            static_cast<int>(_compressed_image.size),
+            &width, &height,
+            nullptr,
+            _channels_per_pixel
+        );
+
+        if (!ptr_data) [[unlikely]]
+            throw pbrlib::exception::RuntimeError(std::format("[vk-image::decoder] failed decode '{}': {}", _name, stbi_failure_reason()));
+
+        const utils::ScopeExit scope_exit ([ptr_data]
+        {
+           stbi_image_free(ptr_data);
+        });
+
+        const size_t channel_count = static_cast<size_t>(_channels_per_pixel);
+
+        std::vector<ImageMipLevel> levels;
+
+        auto& base_level = levels.emplace_back();
+
+        base_level.width    = static_cast<uint32_t>(width);
+        base_level.height   = static_cast<uint32_t>(height);
+        base_level.pixels.assign(ptr_data, ptr_data + base_level.width * base_level.height * channel_count);
+
+        while (levels.back().width > 1 || levels.back().height > 1)
+        {
+            const auto& src = levels.back();
+
+            ImageMipLevel dst
+            {
+                .width  = std::max(src.width >> 1, 1u),
+                .height = std::max(src.height >> 1, 1u)
+            };
+
+            dst.pixels.resize(dst.width * dst.height * channel_count);
+
+            for (const auto y: std::views::iota(0u, dst.height))
+            {
+                const auto y0 = std::min(y * 2, src.height - 1);
+                const auto y1 = std::min(y * 2 + 1, src.height - 1);
+
+                for (const auto x: std::views::iota(0u, dst.width))
+                {
+                    const auto x0 = std::min(x * 2, src.width - 1);
+                    const auto x1 = std::min(x * 2 + 1, src.width - 1);
+
+                    for (const auto c: std::views::iota(0u, channel_count))
+                    {
+                        const uint32_t sum =
+                                src.pixels[(y0 * src.width + x0) * channel_count + c]
+                            +   src.pixels[(y0 * src.width + x1) * channel_count + c]
+                            +   src.pixels[(y1 * src.width + x0) * channel_count + c]
+                            +   src.pixels[(y1 * src.width + x1) * channel_count + c];
+
+                        dst.pixels[(y * dst.width + x) * channel_count + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                    }
+                }
+            }
+
+            levels.push_back(std::move(dst));
+        }
+
+        return levels;
+    }
 }
 
 namespace pbrlib::backend::vk::loaders
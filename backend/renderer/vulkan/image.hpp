@@ -1,6 +1,7 @@
 #pragma once
 
 #include <backend/renderer/vulkan/unique_handler.hpp>
+#include <backend/renderer/vulkan/image_access.hpp>
 #include <pbrlib/math/vec4.hpp>
 
 #include <backend/renderer/vulkan/buffer.hpp>
@@ -10,6 +11,9 @@
 
 #include <vector>
 #include <array>
+#include <span>
+
+#include <optional>
 
 #include <filesystem>
 
@@ -37,6 +41,14 @@ namespace pbrlib::backend::vk
         int         width       = 0;
         int         height      = 0;
         VkFormat    format      = VK_FORMAT_UNDEFINED;
+        uint8_t     mip_level   = 0;
+    };
+
+    struct ImageMipLevel final
+    {
+        uint32_t                width   = 0;
+        uint32_t                height  = 0;
+        std::vector<uint8_t>    pixels;
     };
 
     struct PlanarImageWriteData final
@@ -56,16 +68,31 @@ namespace pbrlib::backend::vk
 
         explicit Image(Device& device);
 
+        [[nodiscard]] VkImageSubresourceRange subresourceRange() const noexcept;
+
+        [[nodiscard]] Buffer createStagingBuffer(const ChunkyImageWriteData& data) const;
+
+        void copyFromBuffer(VkCommandBuffer command_buffer_handle, const Buffer& staging_buffer, const ChunkyImageWriteData& data) const;
+
+        /// Setup command buffer of the device, remembers its batch for the destructor.
+        [[nodiscard]] CommandBuffer& setupCommandBuffer();
+
     public:
         Image(Image&& image) noexcept;
         Image(const Image& image) = delete;
 
+        ~Image();
+
         Image& operator = (Image&& image) noexcept;
         Image& operator = (const Image& image) = delete;
 
         void write(const ChunkyImageWriteData& data);
         void write(const PlanarImageWriteData& data);
 
+        /// Fills the mip levels of an image which the GPU doesn't use yet and leaves it in final_layout.
+        /// Goes to the dedicated transfer queue if the device has one.
+        void upload(std::span<const ChunkyImageWriteData> levels, VkImageLayout final_layout);
+
         void changeLayout (
             VkImageLayout           new_layout,
             VkPipelineStageFlags2   src_stage = VK_PIPELINE_STAGE_2_NONE,
@@ -79,6 +106,14 @@ namespace pbrlib::backend::vk
             VkPipelineStageFlags2   dst_stage = VK_PIPELINE_STAGE_2_NONE
         );
 
+        /// Barrier that makes the image ready for the access. Returns nothing if the previous
+        /// access was a read in the same layout, the stages of both reads are merged.
+        [[nodiscard]] std::optional<VkImageMemoryBarrier2> barrier(const ImageAccess& access);
+
+        /// Content of the image isn't needed anymore: the next barrier transitions it from
+        /// the undefined layout and waits for src_stage, which last used the same memory.
+        void discard(VkPipelineStageFlags2 src_stage) noexcept;
+
         Buffer fetch(std::string_view name) const;
 
         ImageHandle     handle;
@@ -95,7 +130,15 @@ namespace pbrlib::backend::vk
 
     private:
         Device& _device;
+
+        VkPipelineStageFlags2   _last_stage     = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2          _last_access    = VK_ACCESS_2_NONE;
+
+        uint64_t _setup_batch = 0;
     };
+
+    /// Records all barriers in one vkCmdPipelineBarrier2.
+    void pipelineBarrier(CommandBuffer& command_buffer, std::span<const VkImageMemoryBarrier2> barriers);
 }
 
 namespace pbrlib::backend::vk::builders
@@ -106,7 +149,9 @@ namespace pbrlib::backend::vk::builders
 
         void validate();
 
-        [[nodiscard]] VkSharingMode sharingMode();
+        [[nodiscard]] VkSharingMode sharingMode() const;
+
+        [[nodiscard]] VkImageCreateInfo imageCreateInfo() const;
 
     public:
         explicit Image(Device& device) noexcept;
@@ -125,9 +170,17 @@ namespace pbrlib::backend::vk::builders
         [[maybe_unused]] Image& filter(VkFilter filter)                             noexcept;
         [[maybe_unused]] Image& sampleCount(VkSampleCountFlagBits sample_count)     noexcept;
         [[maybe_unused]] Image& tiling(VkImageTiling tiling)                        noexcept;
+        [[maybe_unused]] Image& mipLevels(uint8_t level_count)                      noexcept;
         [[maybe_unused]] Image& fillColor(const pbrlib::math::vec4& fill_color);
         [[maybe_unused]] Image& name(std::string_view image_name);
 
+        /// The image is placed in the existing allocation instead of its own memory,
+        /// the allocation must outlive the image.
+        [[maybe_unused]] Image& aliasMemory(VmaAllocation allocation_handle, VkDeviceSize offset) noexcept;
+
+        /// Memory requirements of the image that would be built, the image isn't created.
+        [[nodiscard]] VkMemoryRequirements memoryRequirements();
+
         [[nodiscard]] vk::Image build();
 
     private:
@@ -147,6 +200,11 @@ namespace pbrlib::backend::vk::builders
         VkImageTiling           _tiling         = VK_IMAGE_TILING_OPTIMAL;
         VkImageUsageFlags       _usage          = VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM;
 
+        uint8_t _level_count = 1;
+
+        VmaAllocation   _alias_allocation_handle    = VK_NULL_HANDLE;
+        VkDeviceSize    _alias_offset               = 0;
+
         std::string _name;
     };
 }
@@ -172,6 +230,12 @@ namespace pbrlib::backend::vk::decoders
 
         [[nodiscard]] vk::Image decode();
 
+        /// Decodes the image on the CPU and builds the full mip chain with a box filter.
+        /// The first element is the base level. Doesn't use the device, may run on any thread.
+        [[nodiscard]] std::vector<ImageMipLevel> decodeMipChain();
+
+        [[nodiscard]] VkFormat format() const;
+
     private:
         Device& _device;
 
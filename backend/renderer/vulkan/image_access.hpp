@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+namespace pbrlib::backend::vk
+{
+    /// Stages, memory accesses and layout with which a pass uses an image.
+    struct ImageAccess final
+    {
+        static constexpr VkAccessFlags2 write_mask =
+                VK_ACCESS_2_SHADER_WRITE_BIT
+            |   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+            |   VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+            |   VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+            |   VK_ACCESS_2_TRANSFER_WRITE_BIT
+            |   VK_ACCESS_2_HOST_WRITE_BIT
+            |   VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+        [[nodiscard]] constexpr bool isWrite() const noexcept
+        {
+            return (access & write_mask) != 0;
+        }
+
+        VkPipelineStageFlags2   stage   = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2          access  = VK_ACCESS_2_NONE;
+        VkImageLayout           layout  = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+}
+
+namespace pbrlib::backend::vk::image_access
+{
+    constexpr ImageAccess compute_sampled_read
+    {
+        .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+        .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+
+    constexpr ImageAccess compute_depth_read
+    {
+        .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+        .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+    };
+
+    constexpr ImageAccess compute_storage_write
+    {
+        .stage  = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .access = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        .layout = VK_IMAGE_LAYOUT_GENERAL
+    };
+
+    constexpr ImageAccess color_attachment_write
+    {
+        .stage  = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        .access = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+        .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    };
+
+    constexpr ImageAccess depth_attachment_write
+    {
+        .stage  = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+        .access = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .layout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL
+    };
+
+    constexpr ImageAccess transfer_read
+    {
+        .stage  = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        .access = VK_ACCESS_2_TRANSFER_READ_BIT,
+        .layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+    };
+
+    constexpr ImageAccess transfer_write
+    {
+        .stage  = VK_PIPELINE_STAGE_2_CLEAR_BIT,
+        .access = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+    };
+
+    /// The presentation engine waits on a semaphore, the barrier only changes the layout.
+    constexpr ImageAccess present
+    {
+        .stage  = VK_PIPELINE_STAGE_2_NONE,
+        .access = VK_ACCESS_2_NONE,
+        .layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+    };
+}
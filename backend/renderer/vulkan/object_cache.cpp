@@ -0,0 +1,114 @@
+#include <backend/renderer/vulkan/object_cache.hpp>
+
+#include <pbrlib/utils/combine_hash.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace pbrlib::backend::vk
+{
+    static auto tie(const VkSamplerCreateInfo& info) noexcept
+    {
+        return std::tie (
+            info.flags,
+            info.magFilter,
+            info.minFilter,
+            info.mipmapMode,
+            info.addressModeU,
+            info.addressModeV,
+            info.addressModeW,
+            info.mipLodBias,
+            info.anisotropyEnable,
+            info.maxAnisotropy,
+            info.compareEnable,
+            info.compareOp,
+            info.minLod,
+            info.maxLod,
+            info.borderColor,
+            info.unnormalizedCoordinates
+        );
+    }
+
+    static auto tie(const VkDescriptorSetLayoutBinding& binding) noexcept
+    {
+        return std::tie (
+            binding.binding,
+            binding.descriptorType,
+            binding.descriptorCount,
+            binding.stageFlags,
+            binding.pImmutableSamplers
+        );
+    }
+
+    static auto tie(const VkPushConstantRange& range) noexcept
+    {
+        return std::tie(range.stageFlags, range.offset, range.size);
+    }
+
+    template<typename... Types>
+    static void combineFields(size_t& seed, const std::tuple<Types...>& fields) noexcept
+    {
+        std::apply([&seed] (const auto&... field)
+        {
+            (utils::combineHash(seed, field), ...);
+        }, fields);
+    }
+}
+
+namespace pbrlib::backend::vk
+{
+    bool SamplerKey::operator == (const SamplerKey& key) const noexcept
+    {
+        return tie(create_info) == tie(key.create_info);
+    }
+
+    bool DescriptorSetLayoutKey::operator == (const DescriptorSetLayoutKey& key) const noexcept
+    {
+        return std::ranges::equal(bindings, key.bindings, [] (const auto& lhs, const auto& rhs)
+        {
+            return tie(lhs) == tie(rhs);
+        });
+    }
+
+    bool PipelineLayoutKey::operator == (const PipelineLayoutKey& key) const noexcept
+    {
+        if (set_layouts != key.set_layouts || push_constant.has_value() != key.push_constant.has_value())
+            return false;
+
+        return !push_constant || tie(*push_constant) == tie(*key.push_constant);
+    }
+}
+
+namespace pbrlib::backend::vk
+{
+    size_t ObjectKeyHash::operator () (const SamplerKey& key) const noexcept
+    {
+        size_t hash = 0;
+        combineFields(hash, tie(key.create_info));
+
+        return hash;
+    }
+
+    size_t ObjectKeyHash::operator () (const DescriptorSetLayoutKey& key) const noexcept
+    {
+        size_t hash = key.bindings.size();
+
+        for (const auto& binding: key.bindings)
+            combineFields(hash, tie(binding));
+
+        return hash;
+    }
+
+    size_t ObjectKeyHash::operator () (const PipelineLayoutKey& key) const noexcept
+    {
+        size_t hash = key.set_layouts.size();
+
+        for (const auto set_layout: key.set_layouts)
+            utils::combineHash(hash, set_layout);
+
+        if (key.push_constant)
+            combineFields(hash, tie(*key.push_constant));
+
+        return hash;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <backend/renderer/vulkan/unique_handler.hpp>
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace pbrlib::backend::vk
+{
+    /// The create info without pNext, samplers with extension structures aren't cached.
+    struct SamplerKey final
+    {
+        VkSamplerCreateInfo create_info;
+
+        [[nodiscard]] bool operator == (const SamplerKey& key) const noexcept;
+    };
+
+    struct DescriptorSetLayoutKey final
+    {
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+
+        [[nodiscard]] bool operator == (const DescriptorSetLayoutKey& key) const noexcept;
+    };
+
+    struct PipelineLayoutKey final
+    {
+        std::vector<VkDescriptorSetLayout>  set_layouts;
+        std::optional<VkPushConstantRange>  push_constant;
+
+        [[nodiscard]] bool operator == (const PipelineLayoutKey& key) const noexcept;
+    };
+
+    struct ObjectKeyHash final
+    {
+        [[nodiscard]] size_t operator () (const SamplerKey& key)               const noexcept;
+        [[nodiscard]] size_t operator () (const DescriptorSetLayoutKey& key)   const noexcept;
+        [[nodiscard]] size_t operator () (const PipelineLayoutKey& key)        const noexcept;
+    };
+
+    /// Objects which are immutable after creation, an identical key returns the same handle.
+    /// The cache owns the objects until it is destroyed.
+    template<typename Key, typename Handle>
+    class ObjectCache final
+    {
+    public:
+        template<typename Create>
+        [[nodiscard]] auto get(const Key& key, Create&& create)
+        {
+            std::lock_guard lock (_mutex);
+
+            if (const auto it = _objects.find(key); it != std::end(_objects)) [[likely]]
+                return it->second.handle();
+
+            return _objects.emplace(key, create(key)).first->second.handle();
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return _objects.size();
+        }
+
+    private:
+        std::unordered_map<Key, Handle, ObjectKeyHash> _objects;
+
+        std::mutex _mutex;
+    };
+}
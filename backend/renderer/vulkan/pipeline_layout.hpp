@@ -26,7 +26,8 @@ namespace pbrlib::backend::vk::builders
         PipelineLayout& addSetLayout(VkDescriptorSetLayout layout_handle);
         PipelineLayout& pushConstant(const VkPushConstantRange& push_constant);
 
-        [[nodiscard]] PipelineLayoutHandle build();
+        /// The layout is cached by the device, which owns it.
+        [[nodiscard]] VkPipelineLayout build();
 
     private:
         Device& _device;
@@ -54,7 +55,8 @@ namespace pbrlib::backend::vk::builders
             VkShaderStageFlags  stages
         );
 
-        DescriptorSetLayoutHandle build();
+        /// The layout is cached by the device, which owns it.
+        [[nodiscard]] VkDescriptorSetLayout build();
 
     private:
         Device& _device;
@@ -46,7 +46,8 @@ namespace pbrlib::backend::vk::builders
 
     RenderPass& RenderPass::depthAttachment (
         const vk::Image*    ptr_image,
-        VkImageLayout       final_layout
+        VkImageLayout       final_layout,
+        VkAttachmentLoadOp  load_op
     )
     {
         _attachments.emplace_back
@@ -56,7 +57,7 @@ namespace pbrlib::backend::vk::builders
                 .sType          = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2,
                 .format         = ptr_image->format,
                 .samples        = VK_SAMPLE_COUNT_1_BIT,
-                .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .loadOp         = load_op,
                 .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
                 .initialLayout  = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
                 .finalLayout    = final_layout
@@ -76,8 +77,8 @@ namespace pbrlib::backend::vk::builders
 
     RenderPassHandle RenderPass::build()
     {
-        if (_color_attachments_refs.empty())
-            throw exception::InvalidState("[render-pass-builder] color attachment count is 0");
+        if (_color_attachments_refs.empty() && !_depth_attachment_ref)
+            throw exception::InvalidState("[render-pass-builder] render pass has no attachments");
 
         VkSubpassDescription2 subpass_description
         {
@@ -29,9 +29,11 @@ namespace pbrlib::backend::vk::builders
             VkImageLayout   final_layout
         );
 
+        /// With VK_ATTACHMENT_LOAD_OP_LOAD the depth written by an earlier pass is kept.
         RenderPass& depthAttachment (
-            const Image*    ptr_image,
-            VkImageLayout   final_layout
+            const Image*        ptr_image,
+            VkImageLayout       final_layout,
+            VkAttachmentLoadOp  load_op = VK_ATTACHMENT_LOAD_OP_CLEAR
         );
 
         [[nodiscard]] RenderPassHandle build();
@@ -12,6 +12,7 @@
 
 #include <SDL3/SDL_vulkan.h>
 
+#include <algorithm>
 #include <ranges>
 
 namespace pbrlib::backend::vk
@@ -108,13 +109,25 @@ namespace pbrlib::backend::vk
 
         throw exception::InvalidState("[vk-surface] failed find surface format");
     }
+
+    VkPresentModeKHR toVkPresentMode(pbrlib::settings::PresentMode mode) noexcept
+    {
+        switch (mode)
+        {
+            case pbrlib::settings::PresentMode::eImmediate:     return VK_PRESENT_MODE_IMMEDIATE_KHR;
+            case pbrlib::settings::PresentMode::eMailbox:       return VK_PRESENT_MODE_MAILBOX_KHR;
+            case pbrlib::settings::PresentMode::eFifoRelaxed:   return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            default:                                            return VK_PRESENT_MODE_FIFO_KHR;
+        }
+    }
 }
 
 namespace pbrlib::backend::vk
 {
-    Surface::Surface(Device& device, const pbrlib::Window& window) :
-        _window (window),
-        _device (device)
+    Surface::Surface(Device& device, const pbrlib::Window& window, const pbrlib::settings::Present& settings) :
+        _window     (window),
+        _settings   (settings),
+        _device     (device)
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
@@ -123,7 +136,11 @@ namespace pbrlib::backend::vk
 
     Surface::Surface(Surface&& surface) :
         _window         (surface._window),
+        _settings       (std::move(surface._settings)),
         _surface_format (surface._surface_format),
+        _storage_usage  (surface._storage_usage),
+        _present_mode   (surface._present_mode),
+        _present_id     (surface._present_id),
         _device         (surface._device),
         _images         (std::move(surface._images))
     {
@@ -138,7 +155,8 @@ namespace pbrlib::backend::vk
         _swapchain_handle   = SwapchainHandle();
         _surface_handle     = SurfaceHandle();
 
-        _current_image_index = 0;
+        _current_image_index    = 0;
+        _present_id             = 0;
 
         createSurface();
 
@@ -176,6 +194,29 @@ namespace pbrlib::backend::vk
             &capabilities
         ));
 
+        VkFormatProperties format_properties = { };
+
+        vkGetPhysicalDeviceFormatProperties(
+            _device.physicalDevice(),
+            _surface_format.format,
+            &format_properties
+        );
+
+        _storage_usage =
+                (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT)
+            &&  (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
+
+        _present_mode = choosePresentMode();
+
+        /// Mailbox needs a spare image to replace the queued one without blocking.
+        uint32_t image_count = std::max<uint32_t>(capabilities.minImageCount, framesInFlight());
+
+        if (_present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
+            ++image_count;
+
+        if (capabilities.maxImageCount > 0)
+            image_count = std::min(image_count, capabilities.maxImageCount);
+
         const auto [width, height] = _window.size();
 
         const auto family_index = _device.queue().family_index;
@@ -184,7 +225,7 @@ namespace pbrlib::backend::vk
         {
             .sType                  = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
             .surface                = _surface_handle,
-            .minImageCount          = framesInFlight(),
+            .minImageCount          = image_count,
             .imageFormat            = _surface_format.format,
             .imageColorSpace        = _surface_format.colorSpace,
             .imageExtent            = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)},
@@ -195,7 +236,7 @@ namespace pbrlib::backend::vk
             .pQueueFamilyIndices    = &family_index,
             .preTransform           = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
             .compositeAlpha         = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
-            .presentMode            = VK_PRESENT_MODE_IMMEDIATE_KHR,
+            .presentMode            = _present_mode,
             .clipped                = VK_TRUE
         };
 
@@ -207,6 +248,37 @@ namespace pbrlib::backend::vk
         ));
     }
 
+    VkPresentModeKHR Surface::choosePresentMode() const
+    {
+        uint32_t num_modes = 0;
+
+        VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(
+            _device.physicalDevice(),
+            _surface_handle,
+            &num_modes,
+            nullptr
+        ));
+
+        std::vector<VkPresentModeKHR> modes (num_modes);
+
+        VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(
+            _device.physicalDevice(),
+            _surface_handle,
+            &num_modes,
+            modes.data()
+        ));
+
+        for (const auto preferred_mode: _settings.modes | std::views::transform(toVkPresentMode))
+        {
+            if (std::ranges::find(modes, preferred_mode) != modes.end())
+                return preferred_mode;
+        }
+
+        log::warning("[vk-surface] no preferred present mode is supported, fifo is used");
+
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
     std::vector<VkSurfaceFormatKHR> Surface::getSurfaceFormats()
     {
         uint32_t num_formats = 0;
@@ -300,11 +372,11 @@ namespace pbrlib::backend::vk
         }
     }
 
-    std::optional<NextImageInfo> Surface::nextImage(VkSemaphore wait_semaphore)
+    std::optional<NextImageInfo> Surface::nextImage(VkSemaphore wait_semaphore, bool wait_on_host)
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
-        if (_next_image_fence_handle == VK_NULL_HANDLE) [[unlikely]]
+        if (wait_on_host && _next_image_fence_handle == VK_NULL_HANDLE) [[unlikely]]
         {
             constexpr VkFenceCreateInfo fence_create_info
             {
@@ -318,16 +390,19 @@ namespace pbrlib::backend::vk
             _device.device(),
             _swapchain_handle,
             std::numeric_limits<uint64_t>::max(),
-            wait_semaphore, _next_image_fence_handle,
+            wait_semaphore, wait_on_host ? _next_image_fence_handle.handle() : VK_NULL_HANDLE,
             &_current_image_index
         );
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR) [[unlikely]]
         {
-            VK_CHECK(vkResetFences(
-                _device.device(),
-                1, &_next_image_fence_handle.handle()
-            ));
+            if (wait_on_host)
+            {
+                VK_CHECK(vkResetFences(
+                    _device.device(),
+                    1, &_next_image_fence_handle.handle()
+                ));
+            }
 
             return std::nullopt;
         }
@@ -335,7 +410,8 @@ namespace pbrlib::backend::vk
         if (result != VK_SUCCESS) [[unlikely]]
             throw exception::RuntimeError("[vk-surface] failed get next image");
 
-        sync(_device.device(), _next_image_fence_handle);
+        if (wait_on_host)
+            sync(_device.device(), _next_image_fence_handle);
 
         return NextImageInfo
         {
@@ -343,4 +419,49 @@ namespace pbrlib::backend::vk
             .index      = _current_image_index
         };
     }
+
+    bool Surface::storageUsage() const noexcept
+    {
+        return _storage_usage;
+    }
+
+    void Surface::waitForPresent()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const uint64_t latency = framesInFlight();
+
+        if (!presentWait() || _present_id < latency)
+            return ;
+
+        /// A minimized window may never present, the frame isn't blocked forever then.
+        constexpr uint64_t timeout = 100'000'000;
+
+        const auto result = _device.deviceFunctions().vkWaitForPresentKHR(
+            _device.device(),
+            _swapchain_handle,
+            _present_id - latency + 1,
+            timeout
+        );
+
+        if (result == VK_TIMEOUT || result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) [[unlikely]]
+            return ;
+
+        VK_CHECK(result);
+    }
+
+    uint64_t Surface::nextPresentId() noexcept
+    {
+        return presentWait() ? ++_present_id : 0;
+    }
+
+    uint8_t Surface::framesInFlight() const noexcept
+    {
+        return static_cast<uint8_t>(std::clamp(_settings.max_frame_latency, 1u, 3u));
+    }
+
+    bool Surface::presentWait() const noexcept
+    {
+        return _settings.wait_for_present && _device.presentWaitSupported();
+    }
 }
@@ -2,6 +2,8 @@
 
 #include <backend/renderer/vulkan/image.hpp>
 
+#include <pbrlib/config.hpp>
+
 #include <vector>
 #include <optional>
 
@@ -30,6 +32,9 @@ namespace pbrlib::backend::vk
         [[nodiscard]]
         std::vector<VkSurfaceFormatKHR> getSurfaceFormats();
 
+        [[nodiscard]] VkPresentModeKHR choosePresentMode() const;
+        [[nodiscard]] bool presentWait() const noexcept;
+
         void createSurface();
         void createSwapchain();
         void getImages(uint32_t width, uint32_t height);
@@ -38,20 +43,30 @@ namespace pbrlib::backend::vk
         void create();
 
     public:
-        explicit Surface(Device& device, const pbrlib::Window& window);
+        explicit Surface(Device& device, const pbrlib::Window& window, const pbrlib::settings::Present& settings);
 
         Surface(Surface&& surface);
 
-        [[nodiscard]] std::optional<NextImageInfo> nextImage(VkSemaphore wait_semaphore);
+        /// Without the wait on host, the image may be used only by a submit that waits on wait_semaphore.
+        [[nodiscard]] std::optional<NextImageInfo> nextImage(VkSemaphore wait_semaphore, bool wait_on_host = true);
+
+        /// Swapchain images can be written by compute shaders.
+        [[nodiscard]] bool storageUsage() const noexcept;
+
+        /// Blocks until the frame max_frame_latency presents back is on screen.
+        /// Does nothing without VK_KHR_present_wait or if the wait isn't requested.
+        void waitForPresent();
+
+        /// Id for VkPresentIdKHR of the next present, 0 if presents aren't tracked.
+        [[nodiscard]] uint64_t nextPresentId() noexcept;
 
-        [[nodiscard]] constexpr static uint8_t framesInFlight() noexcept
-        {
-            return 2;
-        }
+        [[nodiscard]] uint8_t framesInFlight() const noexcept;
 
     private:
         const pbrlib::Window& _window;
 
+        pbrlib::settings::Present _settings;
+
         SurfaceHandle       _surface_handle;
         SwapchainHandle     _swapchain_handle;
 
@@ -59,6 +74,12 @@ namespace pbrlib::backend::vk
 
         VkSurfaceFormatKHR _surface_format = { };
 
+        bool _storage_usage = false;
+
+        VkPresentModeKHR _present_mode = VK_PRESENT_MODE_FIFO_KHR;
+
+        uint64_t _present_id = 0;
+
         Device& _device;
 
         mutable uint32_t _current_image_index = 0;
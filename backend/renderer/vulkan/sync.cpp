@@ -50,4 +50,26 @@ namespace pbrlib::backend::vk
 
         VK_CHECK(vkResetFences(device_handle, 1, &fence_handle));
     }
+
+    void wait(VkDevice device_handle, VkSemaphore timeline_semaphore_handle, uint64_t value, uint64_t timeout)
+    {
+        const VkSemaphoreWaitInfo wait_info
+        {
+            .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores    = &timeline_semaphore_handle,
+            .pValues        = &value
+        };
+
+        VK_CHECK(vkWaitSemaphores(device_handle, &wait_info, timeout));
+    }
+
+    uint64_t counterValue(VkDevice device_handle, VkSemaphore timeline_semaphore_handle)
+    {
+        uint64_t value = 0;
+
+        VK_CHECK(vkGetSemaphoreCounterValue(device_handle, timeline_semaphore_handle, &value));
+
+        return value;
+    }
 }
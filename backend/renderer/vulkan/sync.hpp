@@ -10,4 +10,14 @@ namespace pbrlib::backend::vk
     [[nodiscard]] FenceHandle     create(VkDevice device_handle, const VkFenceCreateInfo& create_info);
 
     void sync(VkDevice device_handle, VkFence fence_handle, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+
+    /// Blocks until the timeline semaphore reaches value, unlike the fence nothing is reset.
+    void wait (
+        VkDevice    device_handle,
+        VkSemaphore timeline_semaphore_handle,
+        uint64_t    value,
+        uint64_t    timeout = std::numeric_limits<uint64_t>::max()
+    );
+
+    [[nodiscard]] uint64_t counterValue(VkDevice device_handle, VkSemaphore timeline_semaphore_handle);
 }
@@ -114,6 +114,18 @@ namespace pbrlib::backend::vk
             vmaDestroyAllocator(allocator_handle);
     }
 
+    void ResourceDestroyer::destroy(VmaPool pool_handle) noexcept
+    {
+        if (pool_handle != VK_NULL_HANDLE)
+            vmaDestroyPool(_allocator_handle, pool_handle);
+    }
+
+    void ResourceDestroyer::destroy(VmaAllocation allocation_handle) noexcept
+    {
+        if (allocation_handle != VK_NULL_HANDLE)
+            vmaFreeMemory(_allocator_handle, allocation_handle);
+    }
+
     void ResourceDestroyer::destroy(VkRenderPass render_pass_handle) noexcept
     {
         if (render_pass_handle != VK_NULL_HANDLE)
@@ -176,6 +188,12 @@ namespace pbrlib::backend::vk
             vkDestroySemaphore(_device_handle, semaphore_handle, nullptr);
     }
 
+    void ResourceDestroyer::destroy(VkQueryPool query_pool_handle) noexcept
+    {
+        if (query_pool_handle != VK_NULL_HANDLE)
+            vkDestroyQueryPool(_device_handle, query_pool_handle, nullptr);
+    }
+
     void ResourceDestroyer::destroy(VkDebugUtilsMessengerEXT debug_utils_messenger_handle) noexcept
     {
         if (debug_utils_messenger_handle && _ptr_instance_functions->vkDestroyDebugUtilsMessengerEXT)
@@ -37,6 +37,8 @@ namespace pbrlib::backend::vk
         static void destroy(VkPipeline pipeline_handle)                                                     noexcept;
         static void destroy(VkSampler sampler_handle)                                                       noexcept;
         static void destroy(VmaAllocator allocator_handle)                                                  noexcept;
+        static void destroy(VmaPool pool_handle)                                                            noexcept;
+        static void destroy(VmaAllocation allocation_handle)                                                noexcept;
         static void destroy(VkRenderPass render_pass_handle)                                                noexcept;
         static void destroy(VkFramebuffer framebuffer_handle)                                               noexcept;
         static void destroy(VkCommandPool command_pool_handle)                                              noexcept;
@@ -47,6 +49,7 @@ namespace pbrlib::backend::vk
         static void destroy(VkSwapchainKHR swapchain_handle)                                                noexcept;
         static void destroy(VkFence fence_handle)                                                           noexcept;
         static void destroy(VkSemaphore semaphore_handle)                                                   noexcept;
+        static void destroy(VkQueryPool query_pool_handle)                                                  noexcept;
         static void destroy(VkDebugUtilsMessengerEXT debug_utils_messenger_handle)                          noexcept;
 
 #ifdef PBRLIB_ENABLE_PROFILING
@@ -126,6 +129,8 @@ namespace pbrlib::backend::vk
     using PipelineHandle            = UniqueHandle<VkPipeline>;
     using SamplerHandle             = UniqueHandle<VkSampler>;
     using AllocatorHandle           = UniqueHandle<VmaAllocator>;
+    using MemoryPoolHandle          = UniqueHandle<VmaPool>;
+    using AllocationHandle          = UniqueHandle<VmaAllocation>;
     using RenderPassHandle          = UniqueHandle<VkRenderPass>;
     using FramebufferHandle         = UniqueHandle<VkFramebuffer>;
     using CommandPoolHandle         = UniqueHandle<VkCommandPool>;
@@ -137,6 +142,7 @@ namespace pbrlib::backend::vk
     using SwapchainHandle           = UniqueHandle<VkSwapchainKHR>;
     using FenceHandle               = UniqueHandle<VkFence>;
     using SemaphoreHandle           = UniqueHandle<VkSemaphore>;
+    using QueryPoolHandle           = UniqueHandle<VkQueryPool>;
     using DebugUtilsMessengerHandle = UniqueHandle<VkDebugUtilsMessengerEXT>;
 
 #ifdef PBRLIB_ENABLE_PROFILING
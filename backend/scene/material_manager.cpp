@@ -8,13 +8,32 @@
 
 #include <pbrlib/scene/scene.hpp>
 #include <pbrlib/exceptions.hpp>
+#include <pbrlib/camera.hpp>
 
 #include <pbrlib/math/vec3.hpp>
+#include <pbrlib/math/vec4.hpp>
+#include <pbrlib/math/casts.hpp>
 
 #include <format>
 
+#include <algorithm>
 #include <array>
 #include <ranges>
+#include <chrono>
+
+#include <cmath>
+
+namespace pbrlib::backend
+{
+    /// Mips whose largest side is not greater than this size stay resident.
+    constexpr uint32_t min_resident_size = 128;
+
+    /// Part of the device local budget that textures are allowed to take.
+    constexpr double texture_budget_factor = 0.8;
+
+    /// Limit of textures which are decoded at the same time, to bound the CPU memory of the decoded levels.
+    constexpr size_t max_pending_images = 4;
+}
 
 namespace pbrlib::backend
 {
@@ -35,7 +54,9 @@ namespace pbrlib::backend
                 .build()
         );
 
-        _sampler_handle = _device.createLinearSampler();
+        _streamed_images.emplace_back();
+
+        _sampler_handle = _device.linearSampler();
 
         constexpr auto stages  = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
 
@@ -87,21 +108,363 @@ namespace pbrlib::backend
         if (!compressed_image.ptr_data || !compressed_image.channels_per_pixel || !compressed_image.size) [[unlikely]]
             return 0;
 
+        const auto hash = utils::hashContent (
+            std::span<const uint8_t>(&compressed_image.channels_per_pixel, 1),
+            utils::hashContent(std::span(compressed_image.ptr_data, compressed_image.size))
+        );
+
+        if (const auto it = _image_ids.find(hash); it != std::end(_image_ids))
+            return it->second;
+
         const auto image_id = static_cast<uint32_t>(_images.size());
 
-        _images.push_back (
-            vk::decoders::Image(_device)
-                .name(name)
-                .channelsPerPixel(compressed_image.channels_per_pixel)
-                .compressedImage(compressed_image.ptr_data, compressed_image.size)
-                .decode()
-        );
+        vk::decoders::Image decoder (_device);
+
+        decoder
+            .name(name)
+            .channelsPerPixel(compressed_image.channels_per_pixel)
+            .compressedImage(compressed_image.ptr_data, compressed_image.size);
+
+        const auto levels = decoder.decodeMipChain();
+
+        auto& streamed_image = _streamed_images.emplace_back();
+
+        streamed_image.name     = name;
+        streamed_image.format   = decoder.format();
+        streamed_image.width    = levels.front().width;
+        streamed_image.height   = levels.front().height;
+
+        for (const auto& level: levels)
+            streamed_image.level_sizes.push_back(level.pixels.size());
+
+        const auto level_count = static_cast<uint8_t>(levels.size());
+
+        while (streamed_image.tail_level + 1 < level_count)
+        {
+            const auto& level = levels[streamed_image.tail_level];
+
+            if (std::max(level.width, level.height) <= min_resident_size)
+                break;
+
+            ++streamed_image.tail_level;
+        }
+
+        /// The source is kept only if some levels may be streamed in later.
+        if (streamed_image.tail_level > 0)
+        {
+            streamed_image.compressed_data = std::make_shared<const std::vector<uint8_t>> (
+                compressed_image.ptr_data,
+                compressed_image.ptr_data + compressed_image.size
+            );
+
+            streamed_image.channels_per_pixel = compressed_image.channels_per_pixel;
+        }
+
+        const auto [usage, budget] = _device.memoryBudget();
+
+        const auto full_size = levelsSize(streamed_image, 0);
+        if (static_cast<double>(usage + full_size) > static_cast<double>(budget) * texture_budget_factor) [[unlikely]]
+            streamed_image.resident_level = streamed_image.tail_level;
+
+        streamed_image.requested_level = streamed_image.resident_level;
+
+        _images.push_back(createResidentImage(streamed_image, std::span(levels).subspan(streamed_image.resident_level)));
+        _resident_size += levelsSize(streamed_image, streamed_image.resident_level);
+
+        _image_ids.emplace(hash, image_id);
 
         return image_id;
     }
 
+    std::vector<uint8_t> MaterialManager::fitIntoBudget(std::span<const MipChain> mip_chains, double budget)
+    {
+        std::vector<uint8_t> levels;
+        levels.reserve(mip_chains.size());
+
+        double total_size = 0.0;
+
+        for (const auto& mip_chain: mip_chains)
+        {
+            levels.push_back(mip_chain.requested_level);
+
+            for (const auto i: std::views::iota(static_cast<size_t>(mip_chain.requested_level), mip_chain.level_sizes.size()))
+                total_size += static_cast<double>(mip_chain.level_sizes[i]);
+        }
+
+        /// Drop the most expensive mips until the textures fit into the budget.
+        while (total_size > budget)
+        {
+            size_t          chain_index = mip_chains.size();
+            VkDeviceSize    level_size  = 0;
+
+            for (const auto i: std::views::iota(size_t(0), mip_chains.size()))
+            {
+                const auto& mip_chain = mip_chains[i];
+
+                if (levels[i] >= mip_chain.tail_level)
+                    continue;
+
+                if (const auto size = mip_chain.level_sizes[levels[i]]; size > level_size)
+                {
+                    chain_index = i;
+                    level_size  = size;
+                }
+            }
+
+            if (chain_index == mip_chains.size()) [[unlikely]]
+                break;
+
+            total_size -= static_cast<double>(level_size);
+            ++levels[chain_index];
+        }
+
+        return levels;
+    }
+
+    VkDeviceSize MaterialManager::levelsSize(const StreamedImage& streamed_image, uint8_t first_level) noexcept
+    {
+        VkDeviceSize size = 0;
+
+        for (const auto i: std::views::iota(static_cast<size_t>(first_level), streamed_image.level_sizes.size()))
+            size += streamed_image.level_sizes[i];
+
+        return size;
+    }
+
+    vk::Image MaterialManager::createResidentImage (
+        const StreamedImage&                    streamed_image,
+        std::span<const vk::ImageMipLevel>      levels
+    ) const
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto& base_level = levels.front();
+
+        auto image = vk::builders::Image(_device)
+            .addQueueFamilyIndex(_device.queue().family_index)
+            .format(streamed_image.format)
+            .mipLevels(static_cast<uint8_t>(levels.size()))
+            .name(streamed_image.name)
+            .size(base_level.width, base_level.height)
+            .usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+            .build();
+
+        std::vector<vk::ChunkyImageWriteData> write_data;
+        write_data.reserve(levels.size());
+
+        for (const auto i: std::views::iota(size_t(0), levels.size()))
+        {
+            const auto& level = levels[i];
+
+            write_data.push_back ({
+                .ptr_data   = const_cast<uint8_t*>(level.pixels.data()),
+                .width      = static_cast<int>(level.width),
+                .height     = static_cast<int>(level.height),
+                .format     = streamed_image.format,
+                .mip_level  = static_cast<uint8_t>(i)
+            });
+        }
+
+        image.upload(write_data, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        return image;
+    }
+
+    void MaterialManager::requestMipLevels(const Camera& camera, std::span<const SceneItem* const> items)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        for (auto& streamed_image: _streamed_images)
+            streamed_image.requested_level = streamed_image.tail_level;
+
+        const auto camera_pos = camera.pos();
+
+        const float half_fov        = math::toRadians(camera.fovY()) * 0.5f;
+        const float pixels_per_unit = static_cast<float>(camera.height()) * 0.5f / std::tan(half_fov);
+        const float near_dist       = std::max(camera.range().near_dist, 0.001f);
+
+        for (const auto ptr_item: items)
+        {
+            if (!ptr_item || !ptr_item->hasComponent<components::Renderable>()) [[unlikely]]
+                continue;
+
+            const auto& renderable  = ptr_item->getComponent<components::Renderable>();
+            const auto& transform   = ptr_item->getComponent<pbrlib::components::Transform>().transform;
+
+            if (renderable.material_id >= _materials.size() || renderable.bbox.empty()) [[unlikely]]
+                continue;
+
+            const auto center   = (renderable.bbox.p_min + renderable.bbox.p_max) * 0.5f;
+            const auto world    = transform * math::vec4(center, 1.0f);
+
+            const float scale = std::max ({
+                math::vec3(transform[0][0], transform[0][1], transform[0][2]).length(),
+                math::vec3(transform[1][0], transform[1][1], transform[1][2]).length(),
+                math::vec3(transform[2][0], transform[2][1], transform[2][2]).length()
+            });
+
+            const float size        = renderable.bbox.diagonal().length() * scale;
+            const float distance    = std::max((math::vec3(world.x, world.y, world.z) - camera_pos).length() - size * 0.5f, near_dist);
+
+            const float screen_size = std::max(size * pixels_per_unit / distance, 1.0f);
+
+            const auto& material = _materials[renderable.material_id];
+
+            for (const auto image_id: {material.albedo, material.normal_map, material.metallic, material.roughness})
+            {
+                if (image_id == 0 || image_id >= _streamed_images.size()) [[unlikely]]
+                    continue;
+
+                auto& streamed_image = _streamed_images[image_id];
+
+                const float texel_count = static_cast<float>(std::max(streamed_image.width, streamed_image.height));
+
+                const auto level = static_cast<uint8_t>(std::clamp (
+                    std::floor(std::log2(texel_count / screen_size)),
+                    0.0f,
+                    static_cast<float>(streamed_image.tail_level)
+                ));
+
+                streamed_image.requested_level = std::min(streamed_image.requested_level, level);
+            }
+        }
+    }
+
+    void MaterialManager::updateResidency()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        const auto [usage, budget] = _device.memoryBudget();
+
+        const auto other_usage      = usage > _resident_size ? usage - _resident_size : 0;
+        const auto texture_budget   = static_cast<double>(budget) * texture_budget_factor - static_cast<double>(other_usage);
+
+        std::vector<MipChain> mip_chains;
+        mip_chains.reserve(_streamed_images.size());
+
+        for (const auto& streamed_image: _streamed_images)
+        {
+            mip_chains.push_back ({
+                .level_sizes        = streamed_image.level_sizes,
+                .requested_level    = streamed_image.requested_level,
+                .tail_level         = streamed_image.tail_level
+            });
+        }
+
+        const auto desired_levels = fitIntoBudget(mip_chains, texture_budget);
+
+        std::vector<size_t> evicted;
+        std::vector<size_t> streamed_in;
+
+        size_t pending_count = 0;
+
+        for (const auto i: std::views::iota(1u, _streamed_images.size()))
+        {
+            const auto& streamed_image = _streamed_images[i];
+
+            if (streamed_image.pending_levels.valid())
+                ++pending_count;
+            else if (desired_levels[i] > streamed_image.resident_level)
+                evicted.push_back(i);
+            else if (desired_levels[i] < streamed_image.resident_level)
+                streamed_in.push_back(i);
+        }
+
+        /// Evictions go first to free memory for the mips streamed in.
+        auto image_ids = evicted;
+        image_ids.insert(std::end(image_ids), std::begin(streamed_in), std::end(streamed_in));
+
+        if (pending_count + image_ids.size() > max_pending_images)
+            image_ids.resize(max_pending_images - std::min(pending_count, max_pending_images));
+
+        for (const auto image_id: image_ids)
+            streamLevels(_streamed_images[image_id], desired_levels[image_id]);
+    }
+
+    void MaterialManager::streamLevels(StreamedImage& streamed_image, uint8_t first_level)
+    {
+        streamed_image.pending_level = first_level;
+
+        streamed_image.pending_levels = std::async (
+            std::launch::async,
+            [
+                &device             = _device,
+                name                = streamed_image.name,
+                compressed_data     = streamed_image.compressed_data,
+                channels_per_pixel  = streamed_image.channels_per_pixel,
+                first_level
+            ]
+            {
+                PBRLIB_PROFILING_ZONE_SCOPED;
+
+                vk::decoders::Image decoder (device);
+
+                auto levels = decoder
+                    .name(name)
+                    .channelsPerPixel(channels_per_pixel)
+                    .compressedImage(compressed_data->data(), compressed_data->size())
+                    .decodeMipChain();
+
+                levels.erase(std::begin(levels), std::begin(levels) + first_level);
+
+                return levels;
+            }
+        );
+    }
+
+    void MaterialManager::finishStreaming()
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        for (const auto image_id: std::views::iota(1u, _streamed_images.size()))
+        {
+            auto& streamed_image = _streamed_images[image_id];
+
+            if (!streamed_image.pending_levels.valid()) [[likely]]
+                continue;
+
+            if (streamed_image.pending_levels.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+
+            const auto levels = streamed_image.pending_levels.get();
+
+            _resident_size -= levelsSize(streamed_image, streamed_image.resident_level);
+
+            streamed_image.resident_level = streamed_image.pending_level;
+
+            _resident_size += levelsSize(streamed_image, streamed_image.resident_level);
+
+            /// Frames which are already submitted may still sample the old image.
+            _retired_images.emplace_back(_device.submittedValue(), std::move(_images[image_id]));
+            _images[image_id] = createResidentImage(streamed_image, levels);
+
+            _device.writeDescriptorSet ({
+                .view_handle            = _images[image_id].view_handle,
+                .sampler_handle         = _sampler_handle,
+                .set_handle             = _descriptor_set_handle,
+                .expected_image_layout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .binding                = Bindings::eImages,
+                .array_element          = static_cast<uint32_t>(image_id)
+            });
+        }
+    }
+
+    void MaterialManager::retireImages()
+    {
+        const auto completed_value = _device.completedValue();
+
+        while (!_retired_images.empty() && _retired_images.front().first <= completed_value)
+            _retired_images.pop_front();
+    }
+
     void MaterialManager::update()
     {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
+        retireImages();
+        finishStreaming();
+        updateResidency();
+
         if (_descriptor_set_is_changed) [[unlikely]]
         {
             for (const auto i: std::views::iota(0u, _images.size()))
@@ -139,7 +502,7 @@ namespace pbrlib::backend
 
     std::pair<VkDescriptorSet, VkDescriptorSetLayout> MaterialManager::descriptorSet() const noexcept
     {
-        return std::make_pair(_descriptor_set_handle.handle(), _descriptor_set_layout_handle.handle());
+        return std::make_pair(_descriptor_set_handle.handle(), _descriptor_set_layout_handle);
     }
 
     size_t MaterialManager::imageCount() const noexcept
@@ -151,4 +514,9 @@ namespace pbrlib::backend
     {
         return _materials.size();
     }
+
+    VkDeviceSize MaterialManager::residentSize() const noexcept
+    {
+        return _resident_size;
+    }
 }
@@ -3,17 +3,27 @@
 #include <backend/renderer/vulkan/image.hpp>
 #include <backend/renderer/vulkan/buffer.hpp>
 
+#include <backend/utils/content_hash.hpp>
+
 #include <limits>
 
 #include <optional>
 
+#include <string>
 #include <string_view>
 
+#include <span>
+#include <deque>
+#include <future>
+#include <memory>
+
 #include <vector>
+#include <unordered_map>
 
 namespace pbrlib
 {
     class SceneItem;
+    class Camera;
 }
 
 namespace pbrlib::backend
@@ -35,8 +45,45 @@ namespace pbrlib::backend
 
     class MaterialManager final
     {
+        /// Mip chain of a texture. The levels [resident_level, level_sizes.size()) live in VRAM;
+        /// the levels starting from tail_level are never evicted. Pixels aren't kept on the CPU,
+        /// a new set of resident levels is decoded from the compressed source on a worker thread.
+        struct StreamedImage final
+        {
+            std::string                 name;
+            std::vector<VkDeviceSize>   level_sizes;
+            uint32_t                    width           = 0;
+            uint32_t                    height          = 0;
+            VkFormat                    format          = VK_FORMAT_UNDEFINED;
+            uint8_t                     resident_level  = 0;
+            uint8_t                     requested_level = 0;
+            uint8_t                     tail_level      = 0;
+
+            /// Empty for textures which are resident as a whole, they are never streamed.
+            std::shared_ptr<const std::vector<uint8_t>> compressed_data;
+            uint8_t                                     channels_per_pixel = 0;
+
+            /// Levels [pending_level, level_sizes.size()) while they are decoded.
+            std::future<std::vector<vk::ImageMipLevel>> pending_levels;
+            uint8_t                                     pending_level = 0;
+        };
+
         uint32_t getImageId(const CompressedImageData& compressed_image, std::string_view name);
 
+        [[nodiscard]] static VkDeviceSize levelsSize(const StreamedImage& streamed_image, uint8_t first_level) noexcept;
+
+        /// The levels start from resident_level.
+        [[nodiscard]] vk::Image createResidentImage (
+            const StreamedImage&                    streamed_image,
+            std::span<const vk::ImageMipLevel>      levels
+        ) const;
+
+        void streamLevels(StreamedImage& streamed_image, uint8_t first_level);
+        void finishStreaming();
+
+        void updateResidency();
+        void retireImages();
+
     public:
         struct Bindings
         {
@@ -49,6 +96,18 @@ namespace pbrlib::backend
             };
         };
 
+        /// Sizes of the mip levels of a texture and the levels it may keep resident.
+        struct MipChain final
+        {
+            std::span<const VkDeviceSize>   level_sizes;
+            uint8_t                         requested_level = 0;
+            uint8_t                         tail_level      = 0;
+        };
+
+        /// First resident level of every mip chain, so that all of them fit into the budget.
+        /// The most expensive mips are dropped first, the levels from tail_level are always kept.
+        [[nodiscard]] static std::vector<uint8_t> fitIntoBudget(std::span<const MipChain> mip_chains, double budget);
+
         explicit MaterialManager(vk::Device& device);
 
         MaterialManager(MaterialManager&& material_manager)         = delete;
@@ -66,6 +125,10 @@ namespace pbrlib::backend
             const CompressedImageData&  roughness
         );
 
+        /// Estimates the finest mip level of each texture that the visible items need
+        /// from their screen-space size. Streaming happens in update().
+        void requestMipLevels(const Camera& camera, std::span<const SceneItem* const> items);
+
         void update();
 
         [[nodiscard]] std::pair<VkDescriptorSet, VkDescriptorSetLayout> descriptorSet() const noexcept;
@@ -73,19 +136,32 @@ namespace pbrlib::backend
         [[nodiscard]] size_t imageCount()       const noexcept;
         [[nodiscard]] size_t materialCount()    const noexcept;
 
+        [[nodiscard]] VkDeviceSize residentSize() const noexcept;
+
     private:
         vk::Device& _device;
 
         std::vector<vk::Image>  _images;
         std::vector<Material>   _materials;
 
-        vk::SamplerHandle _sampler_handle;
+        /// Hash of compressed image bytes -> index in _images.
+        std::unordered_map<utils::ContentHash, uint32_t> _image_ids;
+
+        /// Same indices as _images, the default image has no levels and isn't streamed.
+        std::vector<StreamedImage> _streamed_images;
+
+        VkDeviceSize _resident_size = 0;
+
+        /// Replaced images and the general timeline value after which no frame uses them.
+        std::deque<std::pair<uint64_t, vk::Image>> _retired_images;
+
+        VkSampler _sampler_handle = VK_NULL_HANDLE;
 
         std::optional<vk::Buffer> _materials_indices_buffer;
 
         bool _descriptor_set_is_changed = true;
 
-        vk::DescriptorSetLayoutHandle   _descriptor_set_layout_handle;
+        VkDescriptorSetLayout           _descriptor_set_layout_handle = VK_NULL_HANDLE;
         vk::DescriptorSetHandle         _descriptor_set_handle;
     };
 }
@@ -7,6 +7,8 @@
 
 #include <backend/components.hpp>
 
+#include <backend/logger/logger.hpp>
+
 #include <pbrlib/scene/scene.hpp>
 
 #include <pbrlib/exceptions.hpp>
@@ -16,9 +18,13 @@ namespace pbrlib::backend
     MeshManager::MeshManager(vk::Device& device) :
         _device (device)
     {
+        /// The resolve pass of the visibility buffer pulls vertices in a compute shader.
+        constexpr VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+
         _descriptor_set_layout_handle = vk::builders::DescriptorSetLayout(_device)
-            .addBinding(Bindings::eVertexBuffers, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT)
-            .addBinding(Bindings::eInstances, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT)
+            .addBinding(Bindings::eVertexBuffers, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages)
+            .addBinding(Bindings::eInstances, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages)
+            .addBinding(Bindings::eIndexBuffers, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages)
             .build();
 
         _descriptor_set_handle = _device.allocateDescriptorSet (
@@ -45,6 +51,29 @@ namespace pbrlib::backend
         renderable.vertex_count = attributes.size();
         renderable.index_count  = indices.size();
 
+        const auto hash = utils::hashContent(indices, utils::hashContent(attributes));
+
+        const auto& transform = ptr_item->getComponent<pbrlib::components::Transform>();
+
+        if (const auto it = _mesh_ids.find(hash); it != std::end(_mesh_ids))
+        {
+            log::info("[mesh-manager] '{}' is a duplicate of mesh {}, add as instance", name, it->second);
+
+            const Instance instance
+            {
+                .model      = transform.transform,
+                .normal     = math::transpose(math::inverse(transform.transform)),
+                .mesh_id    = it->second
+            };
+
+            _item_to_instance_id.emplace(ptr_item, _instances.size());
+            _instances.push_back(instance);
+
+            _descriptor_set_is_changed = true;
+
+            return;
+        }
+
         constexpr VkFlags shared_buffer_usage =
                 VK_BUFFER_USAGE_TRANSFER_DST_BIT
             |   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
@@ -63,20 +92,22 @@ namespace pbrlib::backend
                 .name(std::format("[index-buffer] {}", name))
                 .addQueueFamilyIndex(_device.queue().family_index)
                 .size(indices.size_bytes())
-                .usage(shared_buffer_usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+                .usage(shared_buffer_usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
                 .build()
         );
 
-        _vbos.back().write(attributes, 0);
-        _ibos.back().write(indices, 0);
+        _vbos.back().upload(attributes);
+        _ibos.back().upload(indices);
 
-        const auto& transform = ptr_item->getComponent<pbrlib::components::Transform>();
+        const auto mesh_id = static_cast<uint32_t>(_vbos.size() - 1);
+
+        _mesh_ids.emplace(hash, mesh_id);
 
         const Instance instance
         {
             .model      = transform.transform,
             .normal     = math::transpose(math::inverse(transform.transform)),
-            .mesh_id    = static_cast<uint32_t>(_vbos.size() - 1)
+            .mesh_id    = mesh_id
         };
 
         _item_to_instance_id.emplace(ptr_item, _instances.size());
@@ -129,6 +160,12 @@ namespace pbrlib::backend
             for (const auto& buffer: _vbos)
                 buffres_address.push_back(buffer.address());
 
+            std::vector<VkDeviceAddress> index_buffers_address;
+            index_buffers_address.reserve(_ibos.size());
+
+            for (const auto& buffer: _ibos)
+                index_buffers_address.push_back(buffer.address());
+
             constexpr auto buffer_usage =
                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
                 |   VK_BUFFER_USAGE_TRANSFER_DST_BIT;
@@ -141,6 +178,14 @@ namespace pbrlib::backend
                 .usage(buffer_usage)
                 .build();
 
+            _ibos_refs = vk::builders::Buffer(_device)
+                .addQueueFamilyIndex(_device.queue().family_index)
+                .name("[mesh-manager] index-buffers-refs")
+                .size(_ibos.size() * sizeof(VkDeviceAddress))
+                .type(vk::BufferType::eDeviceOnly)
+                .usage(buffer_usage)
+                .build();
+
             _instances_buffer = vk::builders::Buffer(_device)
                 .addQueueFamilyIndex(_device.queue().family_index)
                 .name("instances")
@@ -150,6 +195,7 @@ namespace pbrlib::backend
                 .build();
 
             _vbos_refs->write(std::span<const VkDeviceAddress>(buffres_address), 0);
+            _ibos_refs->write(std::span<const VkDeviceAddress>(index_buffers_address), 0);
 
             _device.writeDescriptorSet ({
                 .buffer     = _vbos_refs.value(),
@@ -165,15 +211,26 @@ namespace pbrlib::backend
                 .binding    = Bindings::eInstances
             });
 
+            _device.writeDescriptorSet ({
+                .buffer     = _ibos_refs.value(),
+                .set_handle = _descriptor_set_handle,
+                .size       = static_cast<uint32_t>(_ibos_refs->size),
+                .binding    = Bindings::eIndexBuffers
+            });
+
             _descriptor_set_is_changed = false;
         }
 
+        /// Materials may be assigned after the mesh is added.
+        for (const auto [ptr_item, instance_id]: _item_to_instance_id)
+            _instances[instance_id].material_id = ptr_item->getComponent<components::Renderable>().material_id;
+
         _instances_buffer->write(std::span<const Instance>(_instances), 0);
     }
 
     std::pair<VkDescriptorSet, VkDescriptorSetLayout> MeshManager::descriptorSet() const noexcept
     {
-        return std::make_pair(_descriptor_set_handle.handle(), _descriptor_set_layout_handle.handle());
+        return std::make_pair(_descriptor_set_handle.handle(), _descriptor_set_layout_handle);
     }
 
     const vk::Buffer& MeshManager::indexBuffer(uint32_t instance_id) const
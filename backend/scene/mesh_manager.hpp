@@ -2,11 +2,14 @@
 
 #include <backend/renderer/vulkan/buffer.hpp>
 
+#include <backend/utils/content_hash.hpp>
+
 #include <pbrlib/math/vec4.hpp>
 #include <pbrlib/math/vec2.hpp>
 #include <pbrlib/math/matrix4x4.hpp>
 #include <pbrlib/math/aabb.hpp>
 
+#include <limits>
 #include <optional>
 
 #include <vector>
@@ -33,7 +36,8 @@ namespace pbrlib::backend
     {
         math::mat4  model;
         math::mat4  normal;
-        uint32_t    mesh_id = 0;
+        uint32_t    mesh_id     = 0;
+        uint32_t    material_id = std::numeric_limits<uint32_t>::max();
     };
 
     class MeshManager final
@@ -45,6 +49,7 @@ namespace pbrlib::backend
             {
                 eVertexBuffers,
                 eInstances,
+                eIndexBuffers,
 
                 eCount
             };
@@ -85,15 +90,19 @@ namespace pbrlib::backend
         std::vector<vk::Buffer> _ibos;
 
         std::optional<vk::Buffer> _vbos_refs;
+        std::optional<vk::Buffer> _ibos_refs;
 
         std::vector<Instance>       _instances;
         std::optional<vk::Buffer>   _instances_buffer;
 
-        vk::DescriptorSetLayoutHandle   _descriptor_set_layout_handle;
+        VkDescriptorSetLayout           _descriptor_set_layout_handle = VK_NULL_HANDLE;
         vk::DescriptorSetHandle         _descriptor_set_handle;
 
         bool _descriptor_set_is_changed = true;
 
         std::unordered_map<const SceneItem*, size_t> _item_to_instance_id;
+
+        /// Hash of vertex and index data -> mesh id.
+        std::unordered_map<utils::ContentHash, uint32_t> _mesh_ids;
     };
 }
@@ -0,0 +1,31 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+#define PBRLIB_MESH_MANAGER_EXPORTS_SET_ID 0
+#include <mesh_manager/exports.glsl>
+
+struct Globals
+{
+    mat4 projection_view;
+    uint instance_id;
+    uint material_index;
+};
+
+layout(push_constant) uniform Block
+{
+    Globals globals;
+};
+
+/// Must match gbuffer_generator.glsl.vert exactly for the equal depth test.
+invariant gl_Position;
+
+void main()
+{
+    Instance    instance    = instances[globals.instance_id];
+    Vertex      vertex      = vertex_buffers[instance.mesh_id].vertices[gl_VertexIndex];
+
+    vec3 pos = vec3(instance.model * vec4(vertex.pos.xyz, 1.0));
+
+    gl_Position = globals.projection_view * vec4(pos, 1.0);
+}
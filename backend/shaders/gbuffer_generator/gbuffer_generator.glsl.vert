@@ -18,11 +18,13 @@ layout(push_constant) uniform Block
 };
 
 layout(location = 0) out flat uint  material_index;
-layout(location = 1) out vec3       pos;
 layout(location = 2) out vec3       normal;
 layout(location = 3) out vec3       tangent;
 layout(location = 4) out vec2       uv;
 
+/// Must match depth_pre_pass.glsl.vert exactly for the equal depth test.
+invariant gl_Position;
+
 void main()
 {
     Instance    instance    = instances[globals.instance_id];
@@ -30,7 +32,8 @@ void main()
 
     material_index = globals.material_index;
 
-    pos     = vec3(instance.model * vec4(vertex.pos.xyz, 1.0));
+    vec3 pos = vec3(instance.model * vec4(vertex.pos.xyz, 1.0));
+
     normal  = vec3(instance.normal * vec4(vec3(vertex.nx, vertex.ny, vertex.nz), 0.0));
     tangent = vec3(instance.normal * vec4(vec3(vertex.tx, vertex.ty, vertex.tz), 0.0));
     uv      = vec2(vertex.uvx, vertex.uvy);
@@ -46,63 +46,58 @@ vec3 unpackUnitVec(vec2 v)
     return normalize(n);
 }
 
-uint pack(vec2 value)
-{
-    const float scale = 65535.0f;
-
-    uvec2 v = uvec2(round(clamp(value, vec2(0.0), vec2(1.0)) * scale));
-
-    return ((v.x & 0xffff) << 0u) | ((v.y & 0xffff) << 16u);
-}
-
-vec2 unpack(uint value)
-{
-    const float inv_scale = 1.0 /  65535.0f;
-
-    uvec2 v = uvec2((value << 16) >> 16, (value << 0) >> 16);
-
-    return vec2(v) * inv_scale;
-}
-
 void pack(
     in GBufferData  data,
-    out vec4        gbuffer_pos_uv,
+    out vec2        gbuffer_uv,
     out vec4        gbuffer_normal_tangent,
     out uint        gbuffer_material_index
 )
 {
-    vec2    pack_normal     = packUnitVec(data.normal);
-    vec2    pack_tangent    = packUnitVec(data.tangent);
-    float   pack_uv         = uintBitsToFloat(pack(data.uv));
+    vec2 pack_normal    = packUnitVec(data.normal);
+    vec2 pack_tangent   = packUnitVec(data.tangent);
 
-    gbuffer_pos_uv          = vec4(data.pos, pack_uv);
+    gbuffer_uv              = clamp(data.uv, vec2(0.0), vec2(1.0));
     gbuffer_normal_tangent  = vec4(pack_normal, pack_tangent);
     gbuffer_material_index  = data.material_index;
 }
 
+/// Position in view space from the depth buffer. Pixels without geometry keep the depth clear value.
+vec3 unpackViewPos(float depth, vec2 screen_uv, mat4 inv_projection)
+{
+    vec4 pos = inv_projection * vec4(screen_uv * 2.0 - 1.0, depth, 1.0);
+    return pos.xyz / pos.w;
+}
+
+/// Inverse of a rigid view transform.
+vec3 viewToWorld(vec3 view_pos, mat4 view)
+{
+    return transpose(mat3(view)) * (view_pos - view[3].xyz);
+}
+
+bool isBackground(float depth)
+{
+    return depth >= 1.0;
+}
+
 GBufferData unpack(
-    vec4 gbuffer_pos_uv,
+    vec3 pos,
+    vec2 gbuffer_uv,
     vec4 gbuffer_normal_tangent,
     uint gbuffer_material_index
 )
 {
     return GBufferData (
-        gbuffer_pos_uv.xyz,
+        pos,
         unpackUnitVec(gbuffer_normal_tangent.xy),
         unpackUnitVec(gbuffer_normal_tangent.zw),
-        unpack(floatBitsToUint(gbuffer_pos_uv.w)),
+        gbuffer_uv,
         gbuffer_material_index
     );
 }
 
-vec3 unpackPos(in vec4 gbuffer_pos_uv)
+vec2 unpackUv(in vec2 gbuffer_uv)
 {
-    return gbuffer_pos_uv.xyz;
-}
-
-vec2 unpackUv(in vec4 gbuffer_pos_uv)
-{
-    return unpack(floatBitsToUint(gbuffer_pos_uv.w));
+    return gbuffer_uv;
 }
 
 vec3 unpackNormal(in vec4 gbuffer_normal_tangent)
@@ -120,12 +115,6 @@ uint unpackMaterialIndex(in uint gbuffer_material_index)
     return gbuffer_material_index;
 }
 
-void unpackPosUv(in vec4 gbuffer_pos_uv, out vec3 pos, out vec2 uv)
-{
-    pos = unpackPos(gbuffer_pos_uv);
-    uv  = unpackUv(gbuffer_pos_uv);
-}
-
 void unpackNormalTangent(in vec4 gbuffer_normal_tangent, out vec3 normal, out vec3 tangent)
 {
     normal  = unpackNormal(gbuffer_normal_tangent);
@@ -3,4 +3,7 @@
 
 #define PBRLIB_WORK_GROUP_SIZE 8
 
+/// Fused filters share the halo of a tile between more pixels.
+#define PBRLIB_FUSED_TILE_SIZE 16
+
 #endif
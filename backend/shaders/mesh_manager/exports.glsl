@@ -19,6 +19,7 @@ struct Instance
     mat4 model;
     mat4 normal;
     uint mesh_id;
+    uint material_id;
 };
 
 layout(std430, scalar, buffer_reference, buffer_reference_align = 16) readonly buffer VertexBuffer
@@ -26,6 +27,11 @@ layout(std430, scalar, buffer_reference, buffer_reference_align = 16) readonly b
     Vertex vertices[];
 };
 
+layout(std430, buffer_reference, buffer_reference_align = 4) readonly buffer IndexBuffer
+{
+    uint indices[];
+};
+
 layout(set = PBRLIB_MESH_MANAGER_EXPORTS_SET_ID, binding = 0) buffer readonly VertexBuffers
 {
     VertexBuffer vertex_buffers[];
@@ -36,4 +42,9 @@ layout(set = PBRLIB_MESH_MANAGER_EXPORTS_SET_ID, binding = 1) buffer readonly In
     Instance instances[];
 };
 
+layout(set = PBRLIB_MESH_MANAGER_EXPORTS_SET_ID, binding = 2) buffer readonly IndexBuffers
+{
+    IndexBuffer index_buffers[];
+};
+
 #endif
\ No newline at end of file
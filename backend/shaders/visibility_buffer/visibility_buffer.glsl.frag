@@ -0,0 +1,10 @@
+#version 460
+
+layout(location = 0) in flat uint instance_id;
+
+layout(location = 0) out uvec2 ids;
+
+void main()
+{
+    ids = uvec2(instance_id, uint(gl_PrimitiveID));
+}
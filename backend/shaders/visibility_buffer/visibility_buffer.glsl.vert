@@ -0,0 +1,29 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+#define PBRLIB_MESH_MANAGER_EXPORTS_SET_ID 0
+#include <mesh_manager/exports.glsl>
+
+struct Globals
+{
+    mat4 projection_view;
+    uint instance_id;
+};
+
+layout(push_constant) uniform Block
+{
+    Globals globals;
+};
+
+layout(location = 0) out flat uint instance_id;
+
+void main()
+{
+    Instance    instance    = instances[globals.instance_id];
+    Vertex      vertex      = vertex_buffers[instance.mesh_id].vertices[gl_VertexIndex];
+
+    instance_id = globals.instance_id;
+
+    gl_Position = globals.projection_view * (instance.model * vec4(vertex.pos.xyz, 1.0));
+}
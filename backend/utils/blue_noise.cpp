@@ -0,0 +1,169 @@
+#include <backend/utils/blue_noise.hpp>
+
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cmath>
+
+namespace pbrlib::backend::utils
+{
+    class VoidAndCluster final
+    {
+    public:
+        explicit VoidAndCluster(uint32_t size) :
+            _size       (size),
+            _energy     (size * size, 0.0f),
+            _kernel     (size * size),
+            _pattern    (size * size, false)
+        {
+            constexpr auto sigma = 1.5f;
+
+            for (uint32_t y = 0; y < _size; ++y)
+            {
+                for (uint32_t x = 0; x < _size; ++x)
+                {
+                    const auto dx = static_cast<float>(std::min(x, _size - x));
+                    const auto dy = static_cast<float>(std::min(y, _size - y));
+
+                    _kernel[y * _size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+                }
+            }
+        }
+
+        void toggle(size_t index)
+        {
+            _pattern[index] = !_pattern[index];
+
+            const auto sign = _pattern[index] ? 1.0f : -1.0f;
+
+            const auto px = static_cast<uint32_t>(index % _size);
+            const auto py = static_cast<uint32_t>(index / _size);
+
+            for (uint32_t y = 0; y < _size; ++y)
+            {
+                const auto ky = (y + _size - py) % _size;
+
+                for (uint32_t x = 0; x < _size; ++x)
+                {
+                    const auto kx = (x + _size - px) % _size;
+                    _energy[y * _size + x] += sign * _kernel[ky * _size + kx];
+                }
+            }
+        }
+
+        [[nodiscard]] bool isSet(size_t index) const
+        {
+            return _pattern[index];
+        }
+
+        /// Point of the pattern with the highest energy.
+        [[nodiscard]] size_t tightestCluster() const
+        {
+            size_t  result      = 0;
+            float   max_energy  = -1.0f;
+
+            for (size_t i = 0; i < _energy.size(); ++i)
+            {
+                if (_pattern[i] && _energy[i] > max_energy)
+                {
+                    max_energy  = _energy[i];
+                    result      = i;
+                }
+            }
+
+            return result;
+        }
+
+        /// Empty pixel with the lowest energy.
+        [[nodiscard]] size_t largestVoid() const
+        {
+            size_t  result      = 0;
+            float   min_energy  = std::numeric_limits<float>::max();
+
+            for (size_t i = 0; i < _energy.size(); ++i)
+            {
+                if (!_pattern[i] && _energy[i] < min_energy)
+                {
+                    min_energy  = _energy[i];
+                    result      = i;
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        uint32_t _size;
+
+        std::vector<float>  _energy;
+        std::vector<float>  _kernel;
+        std::vector<bool>   _pattern;
+    };
+
+    std::vector<uint8_t> generateBlueNoise(uint32_t size)
+    {
+        const auto pixel_count      = static_cast<size_t>(size) * size;
+        const auto initial_count    = std::max<size_t>(pixel_count / 10, 1);
+
+        /// Fixed seed, the texture must be the same between runs.
+        std::mt19937                            generator (0x5eed);
+        std::uniform_int_distribution<size_t>   distribution (0, pixel_count - 1);
+
+        VoidAndCluster initial_pattern (size);
+
+        for (size_t count = 0; count < initial_count;)
+        {
+            const auto index = distribution(generator);
+
+            if (initial_pattern.isSet(index))
+                continue;
+
+            initial_pattern.toggle(index);
+            ++count;
+        }
+
+        /// Moves points from the tightest clusters to the largest voids until the pattern is stable.
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            const auto cluster = initial_pattern.tightestCluster();
+            initial_pattern.toggle(cluster);
+
+            const auto empty = initial_pattern.largestVoid();
+
+            if (empty == cluster)
+            {
+                initial_pattern.toggle(cluster);
+                break;
+            }
+
+            initial_pattern.toggle(empty);
+        }
+
+        std::vector<size_t> ranks (pixel_count, 0);
+
+        auto pattern = initial_pattern;
+        for (auto rank = initial_count; rank > 0; --rank)
+        {
+            const auto cluster = pattern.tightestCluster();
+            pattern.toggle(cluster);
+            ranks[cluster] = rank - 1;
+        }
+
+        pattern = initial_pattern;
+        for (auto rank = initial_count; rank < pixel_count; ++rank)
+        {
+            const auto empty = pattern.largestVoid();
+            pattern.toggle(empty);
+            ranks[empty] = rank;
+        }
+
+        std::vector<uint8_t> noise (pixel_count);
+
+        std::ranges::transform(ranks, noise.begin(), [pixel_count] (size_t rank)
+        {
+            return static_cast<uint8_t>(rank * 256 / pixel_count);
+        });
+
+        return noise;
+    }
+}
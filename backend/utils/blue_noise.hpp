@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+#include <cstdint>
+
+namespace pbrlib::backend::utils
+{
+    /// Tileable blue noise of size x size pixels made with the void-and-cluster method.
+    /// Every pixel keeps its rank in the dither array scaled to [0, 255].
+    [[nodiscard]] std::vector<uint8_t> generateBlueNoise(uint32_t size);
+}
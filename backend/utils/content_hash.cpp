@@ -0,0 +1,96 @@
+#include <backend/utils/content_hash.hpp>
+
+#include <algorithm>
+#include <bit>
+
+#include <cstring>
+
+namespace pbrlib::backend::utils
+{
+    constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+    constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+    constexpr uint64_t mixFinal(uint64_t k) noexcept
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ull;
+        k ^= k >> 33;
+
+        return k;
+    }
+
+    constexpr uint64_t mixK1(uint64_t k1) noexcept
+    {
+        return std::rotl(k1 * c1, 31) * c2;
+    }
+
+    constexpr uint64_t mixK2(uint64_t k2) noexcept
+    {
+        return std::rotl(k2 * c2, 33) * c1;
+    }
+
+    ContentHash hashContent(std::span<const std::byte> bytes, ContentHash seed) noexcept
+    {
+        constexpr size_t block_size = 2 * sizeof(uint64_t);
+
+        const auto ptr_data     = bytes.data();
+        const auto size         = bytes.size();
+        const auto block_count  = size / block_size;
+
+        uint64_t h1 = seed.low;
+        uint64_t h2 = seed.high;
+
+        for (size_t i = 0; i < block_count; ++i)
+        {
+            uint64_t k1 = 0;
+            uint64_t k2 = 0;
+
+            std::memcpy(&k1, ptr_data + i * block_size, sizeof(uint64_t));
+            std::memcpy(&k2, ptr_data + i * block_size + sizeof(uint64_t), sizeof(uint64_t));
+
+            h1 ^= mixK1(k1);
+            h1 = (std::rotl(h1, 27) + h2) * 5 + 0x52dce729;
+
+            h2 ^= mixK2(k2);
+            h2 = (std::rotl(h2, 31) + h1) * 5 + 0x38495ab5;
+        }
+
+        const auto ptr_tail     = ptr_data + block_count * block_size;
+        const auto tail_size    = size % block_size;
+
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
+
+        for (size_t i = sizeof(uint64_t); i < tail_size; ++i)
+            k2 ^= static_cast<uint64_t>(ptr_tail[i]) << ((i - sizeof(uint64_t)) * 8);
+
+        for (size_t i = 0; i < std::min(tail_size, sizeof(uint64_t)); ++i)
+            k1 ^= static_cast<uint64_t>(ptr_tail[i]) << (i * 8);
+
+        if (tail_size > sizeof(uint64_t))
+            h2 ^= mixK2(k2);
+
+        if (tail_size > 0)
+            h1 ^= mixK1(k1);
+
+        h1 ^= static_cast<uint64_t>(size);
+        h2 ^= static_cast<uint64_t>(size);
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = mixFinal(h1);
+        h2 = mixFinal(h2);
+
+        h1 += h2;
+        h2 += h1;
+
+        return ContentHash
+        {
+            .low    = h1,
+            .high   = h2
+        };
+    }
+}
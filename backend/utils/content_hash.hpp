@@ -0,0 +1,37 @@
+#pragma once
+
+#include <span>
+#include <functional>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pbrlib::backend::utils
+{
+    /// 128 bits make a collision improbable enough to identify data by its hash alone.
+    struct ContentHash final
+    {
+        uint64_t low    = 0;
+        uint64_t high   = 0;
+
+        bool operator == (const ContentHash& hash) const noexcept = default;
+    };
+
+    /// MurmurHash3 x64 128. A previous hash as the seed chains several blocks of data.
+    [[nodiscard]] ContentHash hashContent(std::span<const std::byte> bytes, ContentHash seed = { }) noexcept;
+
+    template<typename T>
+    [[nodiscard]] ContentHash hashContent(std::span<const T> data, ContentHash seed = { }) noexcept
+    {
+        return hashContent(std::as_bytes(data), seed);
+    }
+}
+
+template<>
+struct std::hash<pbrlib::backend::utils::ContentHash>
+{
+    size_t operator () (const pbrlib::backend::utils::ContentHash& hash) const noexcept
+    {
+        return static_cast<size_t>(hash.low);
+    }
+};
@@ -1,11 +1,42 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <cstdint>
 
 namespace pbrlib::settings
 {
+    /// Resolution at which the occlusion is computed, relative to the frame.
+    enum class SSAOResolution :
+        uint8_t
+    {
+        eFull,
+        eHalf,
+        eQuarter
+    };
+
+    enum class BlurKernel :
+        uint8_t
+    {
+        /// Full 2D neighbourhood, the cost is quadratic in the kernel radius.
+        eExact,
+
+        /// Horizontal and vertical passes, the cost is linear in the kernel radius.
+        eSeparable
+    };
+
+    enum class AOAlgorithm :
+        uint8_t
+    {
+        /// Random points in the hemisphere around the normal.
+        eSSAO,
+
+        /// Ground-truth ambient occlusion: horizons are searched along screen space slices
+        /// and the visible arc is integrated analytically, converges with far fewer taps.
+        eGTAO
+    };
+
     struct SSAO final
     {
         uint32_t blur_samples_count = 8;
@@ -13,7 +44,39 @@ namespace pbrlib::settings
         float spatial_sigma     = 1.5;
         float luminance_sigma   = 1.5;
 
+        BlurKernel blur_kernel = BlurKernel::eExact;
+
         float radius = 0.05f;
+
+        /// Samples of the hemisphere per pixel, from 4 to 64. The kernel is rotated
+        /// per pixel with blue noise, so low counts are blurred without visible patterns.
+        /// GTAO spends the same number of taps on the horizon search.
+        uint32_t sample_count = 64;
+
+        /// Below the full resolution the result is brought back to the frame
+        /// by a joint bilateral upsample guided by depth and normals.
+        SSAOResolution resolution = SSAOResolution::eFull;
+
+        /// Blends the occlusion with the history reprojected from the previous frame,
+        /// the kernel is rotated every frame. Applied when the frame graph is built.
+        bool temporal_accumulation = false;
+
+        /// The accumulated history is already smooth, the bilateral blur may be skipped.
+        /// Has an effect only with the temporal accumulation.
+        bool skip_blur = false;
+
+        AOAlgorithm algorithm = AOAlgorithm::eSSAO;
+    };
+
+    enum class GeometryPass :
+        uint8_t
+    {
+        /// Rasterization writes all attributes of the G-buffer.
+        eGBuffer,
+
+        /// Rasterization writes only instance and triangle ids, a compute pass
+        /// reconstructs the G-buffer from them.
+        eVisibilityBuffer
     };
 
     enum class AA :
@@ -23,12 +86,61 @@ namespace pbrlib::settings
         eFXAA
     };
 
+    enum class PresentMode :
+        uint8_t
+    {
+        /// No vertical sync, lowest latency, tearing.
+        eImmediate,
+
+        /// Vertical sync, a newer frame replaces the queued one, no tearing.
+        eMailbox,
+
+        /// Vertical sync, the CPU is throttled to the refresh rate. Always supported.
+        eFifo,
+
+        /// Vertical sync unless a frame is late, then it is presented immediately.
+        eFifoRelaxed
+    };
+
+    struct Present final
+    {
+        /// Modes in the order of preference, the first one supported by the surface is used.
+        /// Falls back to PresentMode::eFifo.
+        std::vector<PresentMode> modes = {PresentMode::eImmediate, PresentMode::eMailbox, PresentMode::eFifo};
+
+        /// Frames recorded by the CPU before it waits for the GPU, from 1 to 3.
+        /// Lower values reduce latency, higher values keep the GPU busy.
+        uint32_t max_frame_latency = 2;
+
+        /// Before a new frame the CPU waits until the frame max_frame_latency frames back is on screen.
+        /// Requires VK_KHR_present_wait, ignored without it.
+        bool wait_for_present = false;
+    };
+
     struct FXAA final
     {
         float span_max      = 0.5f;
         float reduce_min    = 0.5f;
         float reduce_mul    = 0.5f;
     };
+
+    /// The scene is rendered at a fraction of the frame size, which follows the GPU time of
+    /// the previous frames, and is upscaled to the frame. The render targets keep the full size.
+    /// Requires the GPU timings, GeometryPass::eGBuffer, the occlusion at the full resolution
+    /// and no temporal accumulation.
+    struct DynamicResolution final
+    {
+        bool enabled = false;
+
+        /// GPU time of a frame which the scale is adjusted to.
+        float frame_time_budget_ms = 16.0f;
+
+        float min_scale = 0.5f;
+        float max_scale = 1.0f;
+
+        /// Strength of the sharpening after the bilinear upscale, from 0 to 1.
+        float sharpness = 0.25f;
+    };
 }
 
 namespace pbrlib
@@ -43,7 +155,32 @@ namespace pbrlib
         bool resible        = false;
         bool draw_in_window = true;
 
+        settings::Present present;
+
+        /// Render targets whose lifetimes in the frame don't overlap share memory.
+        /// Intermediate attachments are overwritten then, so inspecting them needs it disabled.
+        bool alias_transient_images = true;
+
+        settings::GeometryPass geometry_pass = settings::GeometryPass::eGBuffer;
+
+        /// Depth-only pass before the G-buffer, so overdrawn fragments aren't shaded.
+        /// Pays a second vertex pass for the fill-rate, used only with GeometryPass::eGBuffer.
+        bool depth_pre_pass = false;
+
         settings::SSAO  ssao;
         settings::AA    aa = settings::AA::eNone;
+
+        /// The blur of the occlusion and FXAA run in one dispatch, the blurred image isn't written.
+        /// Valid only with FXAA, the occlusion at the full resolution and the blur not skipped.
+        bool fuse_post_processing = false;
+
+        /// FXAA writes directly into the swapchain image, its result image isn't written then.
+        /// Falls back to the copy if the surface format doesn't support storage usage.
+        bool zero_copy_present = true;
+
+        /// Every render pass is measured with timestamp queries, see Engine::gpuTimings().
+        bool gpu_timings = true;
+
+        settings::DynamicResolution dynamic_resolution;
     };
 }
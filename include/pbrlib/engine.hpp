@@ -3,17 +3,22 @@
 #include <pbrlib/window.hpp>
 #include <pbrlib/camera.hpp>
 #include <pbrlib/event_system.hpp>
+#include <pbrlib/pass_timing.hpp>
 
 #include <functional>
 #include <optional>
 #include <memory>
 
+#include <span>
+#include <vector>
+
 namespace pbrlib
 {
     struct  Config;
     class   Engine;
     struct  InputStay;
     class   Scene;
+    class   SceneItem;
 }
 
 namespace pbrlib::settings
@@ -56,7 +61,9 @@ namespace pbrlib
 
         static void updateInputState(InputStay& input_stay);
 
-        void draw();
+        [[nodiscard]] std::vector<const SceneItem*> renderableItems() const;
+
+        void draw(std::span<const SceneItem*> items);
         void updateTime();
 
         void initialize();
@@ -89,6 +96,9 @@ namespace pbrlib
         void postRenderCallback(const std::function<void()>& callback);
         void presentToDisplayCallback(const std::function<void()>& callback);
 
+        /// GPU time of every render pass, measured frames in flight ago. Requires Config::gpu_timings.
+        [[nodiscard]] std::span<const PassTiming> gpuTimings() const noexcept;
+
     private:
         std::optional<Window> _window;
 
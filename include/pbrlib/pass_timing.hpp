@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+namespace pbrlib
+{
+    /// GPU time of a render pass in a frame, measured with timestamp queries.
+    struct PassTiming final
+    {
+        std::string name;
+        double      milliseconds = 0.0;
+    };
+}
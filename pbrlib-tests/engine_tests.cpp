@@ -3,6 +3,8 @@
 #include <pbrlib/engine.hpp>
 #include <pbrlib/config.hpp>
 
+#include <ranges>
+
 TEST(EngineTests, PreRenderCallback)
 {
     if constexpr (!pbrlib::testing::vk::isSupport())
@@ -67,4 +69,33 @@ TEST(EngineTests, PresentToDisplayCallback)
     engine.run();
 
     pbrlib::testing::equality(value, 46362);
-}
\ No newline at end of file
+}
+
+TEST(EngineTests, GPUTimings)
+{
+    if constexpr (!pbrlib::testing::vk::isSupport())
+        GTEST_SKIP() << "skipped: vulkan support is not available on this platform";
+
+    pbrlib::Config config;
+    config.title            = "engine-gpu-timings-test";
+    config.draw_in_window   = false;
+    config.gpu_timings      = true;
+
+    pbrlib::Engine engine (config);
+
+    /// The timings are read back when the slot of the frame is reused.
+    constexpr auto frame_count = 5;
+
+    for ([[maybe_unused]] const auto i: std::views::iota(0, frame_count))
+        engine.run();
+
+    const auto timings = engine.gpuTimings();
+
+    pbrlib::testing::thisTrue(!timings.empty(), "render passes must be measured");
+
+    for (const auto& timing: timings)
+    {
+        pbrlib::testing::thisTrue(!timing.name.empty(), "timing must have name");
+        pbrlib::testing::greaterEquality(timing.milliseconds, 0.0);
+    }
+}
@@ -12,13 +12,13 @@
 #include <backend/renderer/vulkan/shader_compiler.hpp>
 
 #include <backend/utils/paths.hpp>
-#include <backend/renderer/vulkan/check.hpp>
 
 #include <backend/logger/logger.hpp>
 
 #include <backend/math/float16.hpp>
 
 #include <ranges>
+#include <filesystem>
 
 namespace pbrlib::math
 {
@@ -91,16 +91,16 @@ namespace pbrlib::math
 namespace pbrlib::testing
 {
     template<typename PixelType>
-    bool psnr(const backend::vk::Image& rendered_image, const backend::vk::Image& reference_image)
+    bool psnr(const backend::vk::Image& rendered_image, const backend::vk::Image& reference_image, double psnr_threshold)
     {
         const auto rendered_image_buffer = rendered_image.fetch("[vk-image-comparator] rendered image buffer");
         const auto reference_image_buffer = reference_image.fetch("[vk-image-comparator] reference image buffer");
 
         bool all_channels_passed = true;
 
-        rendered_image_buffer.map([&reference_image_buffer, &all_channels_passed](std::span<const uint8_t> rendered_image_src)
+        rendered_image_buffer.map([&reference_image_buffer, &all_channels_passed, psnr_threshold](std::span<const uint8_t> rendered_image_src)
         {
-           reference_image_buffer.map([&rendered_image_src, &all_channels_passed](std::span<const uint8_t> reference_image_src)
+           reference_image_buffer.map([&rendered_image_src, &all_channels_passed, psnr_threshold](std::span<const uint8_t> reference_image_src)
             {
                 using ChannelType = typename PixelType::ElementType;
 
@@ -141,8 +141,7 @@ namespace pbrlib::testing
                 
                 const auto max_i = max_value - min_value;
 
-                constexpr auto eps              = 2.2204460492503131e-16;
-                constexpr auto psnr_threshold   = 45.0;
+                constexpr auto eps = 2.2204460492503131e-16;
                 
                 for (const auto i: std::views::iota(0u, PixelType::element_count))
                 {
@@ -193,12 +192,7 @@ namespace pbrlib::testing
                 .minFilter  = VK_FILTER_NEAREST
             };
 
-            VK_CHECK(vkCreateSampler(
-                _device.device(),
-                &sampler_create_info,
-                nullptr,
-                &_sampler_handle.handle())
-            );
+            _sampler_handle = _device.sampler(sampler_create_info);
         }
     }
 
@@ -275,7 +269,62 @@ namespace pbrlib::testing
         _device.submit(command_buffer);
     }
 
-    bool ImageComparison::compare(backend::vk::Image& rendered_image, backend::vk::Image& reference_image)
+    backend::vk::Image ImageComparison::convert(backend::vk::Image& image, VkFormat format)
+    {
+        auto converted_image = backend::vk::builders::Image(_device)
+            .size(image.width, image.height)
+            .format(format)
+            .usage(VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+            .addQueueFamilyIndex(_device.queue().family_index)
+            .name("[vk-image-comparator] converted image")
+            .build();
+
+        if (image.layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) [[likely]]
+            image.changeLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+        converted_image.changeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        auto command_buffer = _device.oneTimeSubmitCommandBuffer("vk-image-converter");
+
+        command_buffer.write([&image, &converted_image] (auto command_buffer_handle)
+        {
+            const VkImageSubresourceLayers subresource
+            {
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel       = 0,
+                .baseArrayLayer = 0,
+                .layerCount     = 1
+            };
+
+            const VkImageBlit region
+            {
+                .srcSubresource = subresource,
+                .srcOffsets     = {{0, 0, 0}, {static_cast<int32_t>(image.width), static_cast<int32_t>(image.height), 1}},
+                .dstSubresource = subresource,
+                .dstOffsets     = {{0, 0, 0}, {static_cast<int32_t>(image.width), static_cast<int32_t>(image.height), 1}}
+            };
+
+            vkCmdBlitImage (
+                command_buffer_handle,
+                image.handle.handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                converted_image.handle.handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &region,
+                VK_FILTER_NEAREST
+            );
+        }, "[vk-image-comparator] convert-image", backend::vk::marker_colors::blit_image);
+
+        _device.submit(command_buffer);
+
+        converted_image.changeLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+        return converted_image;
+    }
+
+    bool ImageComparison::compare (
+        backend::vk::Image& rendered_image,
+        backend::vk::Image& reference_image,
+        double              psnr_threshold
+    )
     {
         if (rendered_image.width != reference_image.width || rendered_image.height != reference_image.height) [[unlikely]]
             return false;
@@ -286,6 +335,12 @@ namespace pbrlib::testing
         if (rendered_image.layer_count != reference_image.layer_count) [[unlikely]]
             return false;
 
+        if (rendered_image.format != reference_image.format)
+        {
+            auto converted_image = convert(rendered_image, reference_image.format);
+            return compare(converted_image, reference_image, psnr_threshold);
+        }
+
         if constexpr (pbrlib::testing::generate_image_diff)
             generateImageDiff(rendered_image, reference_image);
 
@@ -296,13 +351,13 @@ namespace pbrlib::testing
             reference_image.changeLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
         if (rendered_image.format == VK_FORMAT_R32G32B32A32_SFLOAT)
-            return psnr<pbrlib::math::vec4>(rendered_image, reference_image);
+            return psnr<pbrlib::math::vec4>(rendered_image, reference_image, psnr_threshold);
         
         if (rendered_image.format == VK_FORMAT_R16G16B16A16_SFLOAT)
-            return psnr<math::half4>(rendered_image, reference_image);
+            return psnr<math::half4>(rendered_image, reference_image, psnr_threshold);
 
         if (rendered_image.format == VK_FORMAT_R16_SFLOAT)
-            return psnr<math::Scalar<pbrlib::backend::math::float16_t>>(rendered_image, reference_image);
+            return psnr<math::Scalar<pbrlib::backend::math::float16_t>>(rendered_image, reference_image, psnr_threshold);
 
         backend::log::error("[vk-image-comparator] undefined pixel format: {}", static_cast<uint64_t>(rendered_image.format));
         return true;
@@ -310,13 +365,17 @@ namespace pbrlib::testing
 
     bool ImageComparison::compare (
         backend::vk::Image&             image,
-        const std::filesystem::path&    path_to_reference
+        const std::filesystem::path&    path_to_reference,
+        double                          psnr_threshold
     )
     {
         if (path_to_reference.empty()) [[unlikely]]
             return false;
 
-        if constexpr (generate_image_reference)
+        /// Approximate results are compared with references of the exact ones and never replace them.
+        const bool is_approximate = psnr_threshold < default_psnr_threshold;
+
+        if (generate_image_reference && !is_approximate)
         {
             backend::vk::exporters::Image(_device)
                 .filename(path_to_reference)
@@ -326,11 +385,23 @@ namespace pbrlib::testing
             return true;
         }
 
+        /// A new reference is written from the result, the test fails until it's reviewed and committed.
+        if (!is_approximate && !std::filesystem::exists(path_to_reference)) [[unlikely]]
+        {
+            backend::vk::exporters::Image(_device)
+                .filename(path_to_reference)
+                .image(&image)
+                .save();
+
+            backend::log::error("[vk-image-comparator] reference {} didn't exist, it's written from the result", path_to_reference.string());
+            return false;
+        }
+
         auto reference_image = backend::vk::loaders::Image(_device)
             .filename(path_to_reference)
             .load();
 
-        const bool is_equal = compare(image, reference_image);
+        const bool is_equal = compare(image, reference_image, psnr_threshold);
 
         if constexpr (generate_image_diff)
         {
@@ -17,10 +17,15 @@ namespace pbrlib::backend::vk
 
 namespace pbrlib::testing
 {
+    constexpr auto default_psnr_threshold = 45.0;
+
     class ImageComparison final
     {
         void generateImageDiff(backend::vk::Image& image_1, backend::vk::Image& image_2);
 
+        /// Copy of the image in another format, used when the reference is stored in a wider format.
+        [[nodiscard]] backend::vk::Image convert(backend::vk::Image& image, VkFormat format);
+
     public:
         explicit ImageComparison(backend::vk::Device& device);
 
@@ -30,25 +35,31 @@ namespace pbrlib::testing
         ImageComparison& operator = (ImageComparison&& image_comparison)        = delete;
         ImageComparison& operator = (const ImageComparison& image_comparison)   = delete;
 
+        /// Every channel must have a PSNR in decibels not lower than the threshold.
         [[nodiscard]]
-        bool compare(backend::vk::Image& rendered_image, backend::vk::Image& reference_image);
+        bool compare (
+            backend::vk::Image& rendered_image,
+            backend::vk::Image& reference_image,
+            double              psnr_threshold = default_psnr_threshold
+        );
 
         [[nodiscard]]
         bool compare (
             backend::vk::Image&             image,
-            const std::filesystem::path&    path_to_reference
+            const std::filesystem::path&    path_to_reference,
+            double                          psnr_threshold = default_psnr_threshold
         );
 
     private:
         backend::vk::Device& _device;
 
-        backend::vk::PipelineLayoutHandle   _pipeline_layout_handle;
+        VkPipelineLayout                    _pipeline_layout_handle = VK_NULL_HANDLE;
         backend::vk::PipelineHandle         _pipeline_handle;
 
-        backend::vk::DescriptorSetLayoutHandle  _descriptor_set_layout_handle;
+        VkDescriptorSetLayout                   _descriptor_set_layout_handle = VK_NULL_HANDLE;
         backend::vk::DescriptorSetHandle        _descriptor_set_handle;
 
-        backend::vk::SamplerHandle          _sampler_handle;
+        VkSampler                           _sampler_handle = VK_NULL_HANDLE;
         std::optional<backend::vk::Image>   _images_diff;
     };
 }
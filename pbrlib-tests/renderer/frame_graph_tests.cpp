@@ -3,6 +3,9 @@
 #include <pbrlib/config.hpp>
 
 #include <backend/renderer/frame_graph/frame_graph.hpp>
+#include <backend/renderer/frame_graph/transient_images.hpp>
+#include <backend/renderer/frame_graph/render_target_pool.hpp>
+#include <backend/renderer/frame_graph/dynamic_resolution.hpp>
 #include <backend/renderer/vulkan/device.hpp>
 
 #include <backend/renderer/canvas.hpp>
@@ -36,3 +39,146 @@ TEST(FrameGraphTests, Ctor)
         pbrlib::backend::FrameGraph frame_graph(device, config, canvas, material_manager, mesh_manager);
     });
 }
+
+TEST(FrameGraphTests, VisibilityBufferCtor)
+{
+    if constexpr (!pbrlib::testing::vk::isSupport())
+        GTEST_SKIP();
+
+    ASSERT_NO_THROW(
+    {
+        pbrlib::Config config;
+        config.width            = 800;
+        config.height           = 600;
+        config.draw_in_window   = false;
+        config.geometry_pass    = pbrlib::settings::GeometryPass::eVisibilityBuffer;
+
+        pbrlib::backend::vk::Device device;
+        device.init();
+
+        pbrlib::backend::Canvas canvas(device, config.width, config.height);
+
+        pbrlib::backend::MaterialManager    material_manager    (device);
+        pbrlib::backend::MeshManager        mesh_manager        (device);
+
+        pbrlib::backend::FrameGraph frame_graph(device, config, canvas, material_manager, mesh_manager);
+    });
+}
+
+TEST(FrameGraphTests, TransientImagesAliasing)
+{
+    if constexpr (!pbrlib::testing::vk::isSupport())
+        GTEST_SKIP();
+
+    constexpr uint32_t width    = 1024;
+    constexpr uint32_t height   = 1024;
+
+    constexpr auto usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+
+    pbrlib::backend::vk::Device device;
+    device.init();
+
+    pbrlib::backend::TransientImages            transient_images    (device);
+    pbrlib::backend::TransientImages::Images    images;
+
+    transient_images
+        .addImage("gbuffer", VK_FORMAT_R32G32B32A32_SFLOAT, usage)
+        .addImage("ao", VK_FORMAT_R16_SFLOAT, usage)
+        .addImage("result", VK_FORMAT_R16G16B16A16_SFLOAT, usage)
+        .addImage("history", VK_FORMAT_R16G16B16A16_SFLOAT, usage)
+        .addPass({.writes = {"gbuffer"}, .stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT})
+        .addPass({.reads = {"gbuffer", "history"}, .writes = {"ao"}, .stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT})
+        .addPass({.reads = {"ao"}, .writes = {"result"}, .stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT});
+
+    transient_images.build(width, height, images);
+
+    pbrlib::testing::equality(images.size(), size_t(4));
+
+    pbrlib::testing::thisTrue(transient_images.isAliased("gbuffer"), "gbuffer and result don't overlap");
+    pbrlib::testing::thisTrue(transient_images.isAliased("result"), "gbuffer and result don't overlap");
+    pbrlib::testing::thisFalse(transient_images.isAliased("ao"), "ao overlaps gbuffer and result");
+    pbrlib::testing::thisFalse(transient_images.isAliased("history"), "history is read before it's written");
+
+    pbrlib::testing::thisFalse(transient_images.needsClear("gbuffer"), "gbuffer is overwritten before it's read");
+    pbrlib::testing::thisFalse(transient_images.needsClear("result"), "result is overwritten before it's read");
+    pbrlib::testing::thisTrue(transient_images.needsClear("history"), "nothing writes history");
+
+    constexpr VkDeviceSize texel_count = width * height;
+    pbrlib::testing::thisTrue(transient_images.size() < texel_count * (16 + 2 + 8), "result must reuse memory of gbuffer");
+}
+
+TEST(FrameGraphTests, RenderTargetPoolReuse)
+{
+    if constexpr (!pbrlib::testing::vk::isSupport())
+        GTEST_SKIP();
+
+    pbrlib::backend::vk::Device device;
+    device.init();
+
+    pbrlib::backend::RenderTargetPool pool (device);
+
+    const pbrlib::backend::RenderTargetDescription description
+    {
+        .format = VK_FORMAT_R16G16B16A16_SFLOAT,
+        .width  = 256,
+        .height = 256,
+        .usage  = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT
+    };
+
+    auto image = pool.acquire(description, "render-target");
+    const VkImage image_handle = image.handle.handle();
+
+    /// Nothing was submitted after the release, the image is free at once.
+    pool.release(description, std::move(image), device.completedValue());
+    pbrlib::testing::equality(pool.size(), size_t(1));
+
+    auto other_description  = description;
+    other_description.width = 512;
+
+    const auto other_image = pool.acquire(other_description, "other-render-target");
+    pbrlib::testing::thisTrue(other_image.handle.handle() != image_handle, "description differs, the image mustn't be reused");
+    pbrlib::testing::equality(pool.size(), size_t(1));
+
+    const auto reused_image = pool.acquire(description, "render-target");
+    pbrlib::testing::thisTrue(reused_image.handle.handle() == image_handle, "compatible image must be reused");
+    pbrlib::testing::equality(pool.size(), size_t(0));
+}
+
+TEST(FrameGraphTests, DynamicResolutionController)
+{
+    const pbrlib::settings::DynamicResolution settings
+    {
+        .enabled                = true,
+        .frame_time_budget_ms   = 10.0f,
+        .min_scale              = 0.5f,
+        .max_scale              = 1.0f
+    };
+
+    constexpr uint32_t latency = 2;
+
+    pbrlib::backend::DynamicResolution controller (settings, latency);
+    pbrlib::testing::equality(controller.scale(), 1.0f);
+
+    const std::vector<pbrlib::PassTiming> over_budget   = {{"gbuffer", 12.0}, {"ssao", 8.0}};
+    const std::vector<pbrlib::PassTiming> in_budget     = {{"gbuffer", 6.0}, {"ssao", 4.0}};
+    const std::vector<pbrlib::PassTiming> under_budget  = {{"gbuffer", 1.0}, {"ssao", 1.0}};
+
+    const auto lowered_scale = controller.update(over_budget);
+    pbrlib::testing::thisTrue(lowered_scale < 1.0f, "the scale must go down over the budget");
+
+    /// The timings of the frames recorded before the change are ignored.
+    for (uint32_t i = 0; i < latency; ++i)
+        pbrlib::testing::equality(controller.update(over_budget), lowered_scale);
+
+    pbrlib::testing::equality(controller.update(in_budget), lowered_scale);
+
+    for (uint32_t i = 0; i < 64; ++i)
+        controller.update(over_budget);
+
+    pbrlib::testing::equality(controller.scale(), settings.min_scale);
+
+    for (uint32_t i = 0; i < 64; ++i)
+        controller.update(under_budget);
+
+    pbrlib::testing::equality(controller.scale(), settings.max_scale);
+}
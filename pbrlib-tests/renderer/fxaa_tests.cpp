@@ -26,3 +26,20 @@ TEST_F(FXAATests, JunkShopAttachments)
     setup("Blender 2.glb", settings);
     check("fxaa/junk-shop-fxaa-result.exr", attahment_name);
 }
+
+TEST_F(FXAATests, JunkShopAttachmentsFusedWithBlur)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    config().aa                     = pbrlib::settings::AA::eFXAA;
+    config().fuse_post_processing   = true;
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::FXAA>::result;
+    setup("Blender 2.glb", settings);
+    check("fxaa/junk-shop-fxaa-result.exr", attahment_name, 35.0);
+}
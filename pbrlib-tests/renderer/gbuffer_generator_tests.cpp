@@ -10,17 +10,18 @@ class GBufferGeneratorTests :
 public:
     GBufferGeneratorTests() :
         pbrlib::testing::RenderTest("gbuffer-generator-tests", 1000, 1000)
-    { }
+    {
+        config().alias_transient_images = false;
+    }
 };
 
 TEST_F(GBufferGeneratorTests, JunkShopAttachments)
 {
-    /// @todo add check material_index
+    /// @todo add check material_index and uv
 
     constexpr std::array attachments
     {
-        std::make_pair("gbuffer_generator/junk-shop-attachment-normal-tangent.exr", pbrlib::backend::AttachmentsTraits<pbrlib::backend::GBufferGenerator>::normal_tangent),
-        std::make_pair("gbuffer_generator/junk-shop-attachment-pos-uv.exr", pbrlib::backend::AttachmentsTraits<pbrlib::backend::GBufferGenerator>::pos_uv)
+        std::make_pair("gbuffer_generator/junk-shop-attachment-normal-tangent.exr", pbrlib::backend::AttachmentsTraits<pbrlib::backend::GBufferGenerator>::normal_tangent)
     };
 
     constexpr pbrlib::testing::Settings settings
@@ -34,3 +35,41 @@ TEST_F(GBufferGeneratorTests, JunkShopAttachments)
     for (const auto [filename, attachment_name]: attachments)
         check(filename, attachment_name);
 }
+
+TEST_F(GBufferGeneratorTests, JunkShopAttachmentsWithDepthPrePass)
+{
+    config().depth_pre_pass = true;
+
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    /// The pre-pass changes only which fragments are shaded, not the result.
+    setup("Blender 2.glb", settings);
+    check (
+        "gbuffer_generator/junk-shop-attachment-normal-tangent.exr",
+        pbrlib::backend::AttachmentsTraits<pbrlib::backend::GBufferGenerator>::normal_tangent
+    );
+}
+
+TEST_F(GBufferGeneratorTests, JunkShopAttachmentsWithVisibilityBuffer)
+{
+    config().geometry_pass = pbrlib::settings::GeometryPass::eVisibilityBuffer;
+
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    /// The resolve rebuilds the same G-buffer from the triangle ids.
+    setup("Blender 2.glb", settings);
+    check (
+        "gbuffer_generator/junk-shop-attachment-normal-tangent.exr",
+        pbrlib::backend::AttachmentsTraits<pbrlib::backend::GBufferGenerator>::normal_tangent
+    );
+}
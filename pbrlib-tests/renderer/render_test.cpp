@@ -47,7 +47,11 @@ namespace pbrlib::testing
         });
     }
 
-    void RenderTest::check(const std::filesystem::path& reference_image, std::string_view attachment_name)
+    void RenderTest::check (
+        const std::filesystem::path&    reference_image,
+        std::string_view                attachment_name,
+        double                          psnr_threshold
+    )
     {
         static const auto refs_root_dir = pbrlib::backend::utils::projectRoot() / "pbrlib-tests/references";
 
@@ -58,7 +62,7 @@ namespace pbrlib::testing
         auto ptr_result = _frame_graph_getter->image(attachment_name);
         ptr_result->changeLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
-        pbrlib::testing::thisTrue(_comparator->compare(*ptr_result, refs_root_dir / reference_image));
+        pbrlib::testing::thisTrue(_comparator->compare(*ptr_result, refs_root_dir / reference_image, psnr_threshold));
     }
 
     pbrlib::Config& RenderTest::config() noexcept
@@ -39,7 +39,11 @@ namespace pbrlib::testing
         explicit RenderTest(std::string_view name, uint32_t width, uint32_t height);
 
         void setup(const std::filesystem::path& content, const Settings& settings);
-        void check(const std::filesystem::path& reference_image, std::string_view attachment_name);
+        void check (
+            const std::filesystem::path&    reference_image,
+            std::string_view                attachment_name,
+            double                          psnr_threshold = default_psnr_threshold
+        );
 
         pbrlib::Config& config() noexcept;
         pbrlib::Engine& engine() noexcept;
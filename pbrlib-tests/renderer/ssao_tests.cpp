@@ -63,3 +63,141 @@ TEST_F(SSAOTests, JunkShopAttachmentsWithBlur)
         }
     }
 }
+
+TEST_F(SSAOTests, JunkShopAttachmentsWithSeparableBlur)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.blur_kernel = pbrlib::settings::BlurKernel::eSeparable;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-with-blur-[sample-count=8][spatial-sigma=1.5][luminance-sigma=1.5].exr", attahment_name, 35.0);
+}
+
+TEST_F(SSAOTests, JunkShopAttachmentsAtHalfResolution)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.resolution = pbrlib::settings::SSAOResolution::eHalf;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-with-blur-[sample-count=8][spatial-sigma=1.5][luminance-sigma=1.5].exr", attahment_name, 30.0);
+}
+
+TEST_F(SSAOTests, JunkShopAttachmentsAtQuarterResolution)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.resolution = pbrlib::settings::SSAOResolution::eQuarter;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-with-blur-[sample-count=8][spatial-sigma=1.5][luminance-sigma=1.5].exr", attahment_name, 25.0);
+}
+
+TEST_F(SSAOTests, JunkShopAttachmentsWithLowSampleCount)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.sample_count = 16;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-with-blur-[sample-count=8][spatial-sigma=1.5][luminance-sigma=1.5].exr", attahment_name, 30.0);
+}
+
+TEST_F(SSAOTests, JunkShopAttachmentsWithTemporalAccumulation)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.sample_count          = 16;
+    config().ssao.temporal_accumulation = true;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-with-blur-[sample-count=8][spatial-sigma=1.5][luminance-sigma=1.5].exr", attahment_name, 30.0);
+}
+
+TEST_F(SSAOTests, JunkShopGTAOAttachments)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::ssao;
+
+    config().ssao.algorithm = pbrlib::settings::AOAlgorithm::eGTAO;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-gtao-result.exr", attahment_name);
+}
+
+TEST_F(SSAOTests, JunkShopGTAOAttachmentsWithBlur)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.algorithm = pbrlib::settings::AOAlgorithm::eGTAO;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-gtao-with-blur.exr", attahment_name);
+}
+
+TEST_F(SSAOTests, JunkShopGTAOAttachmentsWithLowSampleCount)
+{
+    constexpr pbrlib::testing::Settings settings
+    {
+        .up     = pbrlib::math::vec3(0, -1, 0),
+        .pos    = pbrlib::math::vec3(-3, 5, 16.0),
+        .eye    = pbrlib::math::vec3(0)
+    };
+
+    constexpr auto attahment_name = pbrlib::backend::AttachmentsTraits<pbrlib::backend::SSAO>::blur;
+
+    config().ssao.algorithm     = pbrlib::settings::AOAlgorithm::eGTAO;
+    config().ssao.sample_count  = 16;
+
+    setup("Blender 2.glb", settings);
+    check("ssao/junk-shop-gtao-with-blur.exr", attahment_name, 30.0);
+}
@@ -11,6 +11,9 @@
 
 #include <array>
 #include <optional>
+#include <vector>
+
+#include <format>
 
 class VulkanDeviceTests :
     public ::testing::Test
@@ -188,3 +191,129 @@ TEST_F(VulkanDeviceTests, WriteDescriptorSetBuffer)
         });
     });
 }
+
+TEST_F(VulkanDeviceTests, SubAllocateBuffers)
+{
+    constexpr size_t buffer_count   = 10'000;
+    constexpr size_t buffer_size    = 256;
+
+    std::vector<pbrlib::backend::vk::Buffer> buffers;
+    buffers.reserve(buffer_count);
+
+    for (size_t i = 0; i < buffer_count; ++i)
+    {
+        buffers.push_back (
+            pbrlib::backend::vk::builders::Buffer(*device)
+                .size(buffer_size)
+                .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+                .addQueueFamilyIndex(device->queue().family_index)
+                .type(pbrlib::backend::vk::BufferType::eDeviceOnly)
+                .build()
+        );
+    }
+
+    VmaTotalStatistics statistics = { };
+    vmaCalculateStatistics(device->vmaAllocator(), &statistics);
+
+    pbrlib::testing::greaterEquality(statistics.total.statistics.allocationCount, static_cast<uint32_t>(buffer_count));
+
+    const auto max_allocation_count = device->limits().maxMemoryAllocationCount;
+    pbrlib::testing::thisTrue (
+        statistics.total.statistics.blockCount < max_allocation_count / 100,
+        std::format("memory block count: {}, limit: {}", statistics.total.statistics.blockCount, max_allocation_count)
+    );
+}
+
+TEST_F(VulkanDeviceTests, TimelineSubmit)
+{
+    auto first_cmd_buffer = device->oneTimeSubmitCommandBuffer();
+    first_cmd_buffer.write([] ([[maybe_unused]] VkCommandBuffer handle) { });
+
+    auto second_cmd_buffer = device->oneTimeSubmitCommandBuffer();
+    second_cmd_buffer.write([] ([[maybe_unused]] VkCommandBuffer handle) { });
+
+    const auto first_value  = device->submit(first_cmd_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+    const auto second_value = device->submit(second_cmd_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+
+    pbrlib::testing::thisTrue(second_value > first_value, "timeline values must increase");
+
+    device->retire(std::move(first_cmd_buffer), first_value);
+    device->retire(std::move(second_cmd_buffer), second_value);
+
+    device->wait(second_value);
+
+    pbrlib::testing::greaterEquality(device->completedValue(), second_value);
+}
+
+TEST_F(VulkanDeviceTests, TransferQueueSubmit)
+{
+    using pbrlib::backend::vk::QueueType;
+
+    auto cmd_buffer = device->oneTimeSubmitCommandBuffer("", QueueType::eTransfer);
+    cmd_buffer.write([] ([[maybe_unused]] VkCommandBuffer handle) { });
+
+    pbrlib::testing::thisTrue(cmd_buffer.queue_type == QueueType::eTransfer, "command buffer must keep its queue type");
+
+    const auto value = device->submit(cmd_buffer, VK_NULL_HANDLE, VK_NULL_HANDLE);
+    device->wait(value, QueueType::eTransfer);
+
+    pbrlib::testing::greaterEquality(device->completedValue(QueueType::eTransfer), value);
+}
+
+TEST_F(VulkanDeviceTests, ObjectCaches)
+{
+    pbrlib::testing::thisTrue(device->linearSampler() == device->linearSampler(), "identical samplers must be shared");
+    pbrlib::testing::thisTrue(device->linearSampler() != device->nearestSampler(), "different samplers mustn't be shared");
+
+    const auto build_set_layout = [this] (VkDescriptorType descriptor_type)
+    {
+        return pbrlib::backend::vk::builders::DescriptorSetLayout(*device)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(1, descriptor_type, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+    };
+
+    const auto set_layout = build_set_layout(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+
+    pbrlib::testing::thisTrue(set_layout == build_set_layout(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE), "identical set layouts must be shared");
+    pbrlib::testing::thisTrue(set_layout != build_set_layout(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER), "different set layouts mustn't be shared");
+
+    const auto build_pipeline_layout = [this, set_layout] (uint32_t push_constant_size)
+    {
+        return pbrlib::backend::vk::builders::PipelineLayout(*device)
+            .addSetLayout(set_layout)
+            .pushConstant({.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .size = push_constant_size})
+            .build();
+    };
+
+    const auto pipeline_layout = build_pipeline_layout(16);
+
+    pbrlib::testing::thisTrue(pipeline_layout == build_pipeline_layout(16), "identical pipeline layouts must be shared");
+    pbrlib::testing::thisTrue(pipeline_layout != build_pipeline_layout(32), "different pipeline layouts mustn't be shared");
+}
+
+TEST_F(VulkanDeviceTests, DeferredSetupCommands)
+{
+    auto buffer = pbrlib::backend::vk::builders::Buffer(*device)
+        .size(sizeof(uint32_t))
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .addQueueFamilyIndex(device->queue().family_index)
+        .type(pbrlib::backend::vk::BufferType::eDeviceOnly)
+        .build();
+
+    const auto batch = device->setupBatch();
+
+    buffer.write(42u, 0);
+
+    pbrlib::testing::thisTrue(device->isSetupBatchPending(batch), "write must be recorded into the setup command buffer");
+
+    const auto value = device->flushSetupCommands();
+
+    pbrlib::testing::thisTrue(value != 0, "flush must submit the recorded commands");
+    pbrlib::testing::thisTrue(!device->isSetupBatchPending(batch), "flush must start a new batch");
+    pbrlib::testing::equality(device->flushSetupCommands(), uint64_t(0));
+
+    device->wait(value);
+
+    pbrlib::testing::greaterEquality(device->completedValue(), value);
+}
@@ -0,0 +1,135 @@
+#include "../utils.hpp"
+
+#include <backend/scene/material_manager.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/components.hpp>
+
+#include <pbrlib/scene/scene.hpp>
+
+#include <array>
+#include <optional>
+
+/// 2x2 RGBA PNGs with stored (uncompressed) deflate blocks, so both have the same size.
+constexpr std::array<uint8_t, 86> red_png
+{
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x08, 0x06, 0x00, 0x00, 0x00, 0x72, 0xb6, 0x0d,
+    0x24, 0x00, 0x00, 0x00, 0x1d, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x01, 0x12, 0x00, 0xed, 0xff,
+    0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00,
+    0x00, 0xff, 0x47, 0xca, 0x07, 0xf9, 0x83, 0xac, 0xbd, 0xdb, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+    0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+constexpr std::array<uint8_t, 86> blue_png
+{
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x08, 0x06, 0x00, 0x00, 0x00, 0x72, 0xb6, 0x0d,
+    0x24, 0x00, 0x00, 0x00, 0x1d, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x01, 0x12, 0x00, 0xed, 0xff,
+    0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00,
+    0xff, 0xff, 0x3f, 0xd2, 0x07, 0xf9, 0xd9, 0x01, 0x94, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+    0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+class MaterialManagerTests :
+    public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        if constexpr (!pbrlib::testing::vk::isSupport())
+            GTEST_SKIP();
+
+        device.emplace();
+        device->init();
+
+        material_manager.emplace(*device);
+    }
+
+    void TearDown() override
+    {
+        material_manager    = std::nullopt;
+        device              = std::nullopt;
+    }
+
+    void addMaterial(std::string_view name, std::span<const uint8_t> albedo)
+    {
+        auto& item = scene.addItem(name);
+        item.addComponent<pbrlib::backend::components::Renderable>().ptr_item = &item;
+
+        const pbrlib::backend::CompressedImageData albedo_data
+        {
+            .ptr_data           = albedo.data(),
+            .size               = albedo.size(),
+            .channels_per_pixel = 4
+        };
+
+        material_manager->add(&item, name, albedo_data, { }, { }, { });
+    }
+
+    pbrlib::Scene scene {"scene"};
+
+    std::optional<pbrlib::backend::vk::Device>      device;
+    std::optional<pbrlib::backend::MaterialManager> material_manager;
+};
+
+TEST_F(MaterialManagerTests, SharesDuplicateImages)
+{
+    addMaterial("first", red_png);
+    addMaterial("second", red_png);
+
+    pbrlib::testing::equality(material_manager->materialCount(), size_t(2));
+
+    /// The default image and one shared albedo.
+    pbrlib::testing::equality(material_manager->imageCount(), size_t(2));
+}
+
+TEST_F(MaterialManagerTests, SeparatesImagesOfEqualSize)
+{
+    addMaterial("first", red_png);
+    addMaterial("second", blue_png);
+
+    pbrlib::testing::equality(material_manager->imageCount(), size_t(3));
+}
+
+TEST(MaterialManagerBudgetTests, KeepsRequestedLevelsWithinBudget)
+{
+    constexpr std::array<VkDeviceSize, 4> sizes {4096, 1024, 256, 64};
+
+    const std::array<pbrlib::backend::MaterialManager::MipChain, 2> mip_chains
+    {
+        pbrlib::backend::MaterialManager::MipChain {.level_sizes = sizes, .requested_level = 0, .tail_level = 2},
+        pbrlib::backend::MaterialManager::MipChain {.level_sizes = sizes, .requested_level = 1, .tail_level = 2}
+    };
+
+    const auto levels = pbrlib::backend::MaterialManager::fitIntoBudget(mip_chains, 1e6);
+
+    pbrlib::testing::equality(levels, std::vector<uint8_t> {0, 1});
+}
+
+TEST(MaterialManagerBudgetTests, DropsMostExpensiveMipsFirst)
+{
+    constexpr std::array<VkDeviceSize, 4> small_sizes   {4096, 1024, 256, 64};
+    constexpr std::array<VkDeviceSize, 4> large_sizes   {16384, 2048, 512, 128};
+    constexpr std::array<VkDeviceSize, 3> tiny_sizes    {2048, 512, 128};
+
+    const std::array<pbrlib::backend::MaterialManager::MipChain, 3> mip_chains
+    {
+        pbrlib::backend::MaterialManager::MipChain {.level_sizes = small_sizes, .tail_level = 2},
+        pbrlib::backend::MaterialManager::MipChain {.level_sizes = large_sizes, .tail_level = 2},
+        pbrlib::backend::MaterialManager::MipChain {.level_sizes = tiny_sizes, .tail_level = 1}
+    };
+
+    constexpr double total_size = 5440.0 + 19072.0 + 2688.0;
+
+    /// Only the base level of the largest texture has to go.
+    auto levels = pbrlib::backend::MaterialManager::fitIntoBudget(mip_chains, total_size - 1.0);
+    pbrlib::testing::equality(levels, std::vector<uint8_t> {0, 1, 0});
+
+    /// Then the base level of the small texture, the largest of the remaining levels.
+    levels = pbrlib::backend::MaterialManager::fitIntoBudget(mip_chains, total_size - 16384.0 - 1.0);
+    pbrlib::testing::equality(levels, std::vector<uint8_t> {1, 1, 0});
+
+    /// The tails are never dropped, even if they don't fit.
+    levels = pbrlib::backend::MaterialManager::fitIntoBudget(mip_chains, 0.0);
+    pbrlib::testing::equality(levels, std::vector<uint8_t> {2, 2, 1});
+}
@@ -0,0 +1,73 @@
+#include "../utils.hpp"
+
+#include <backend/scene/mesh_manager.hpp>
+#include <backend/renderer/vulkan/device.hpp>
+#include <backend/components.hpp>
+
+#include <pbrlib/scene/scene.hpp>
+
+#include <array>
+#include <optional>
+
+class MeshManagerTests :
+    public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        if constexpr (!pbrlib::testing::vk::isSupport())
+            GTEST_SKIP();
+
+        device.emplace();
+        device->init();
+
+        mesh_manager.emplace(*device);
+    }
+
+    void TearDown() override
+    {
+        mesh_manager    = std::nullopt;
+        device          = std::nullopt;
+    }
+
+    pbrlib::SceneItem& addItem(std::string_view name)
+    {
+        auto& item = scene.addItem(name);
+        item.addComponent<pbrlib::backend::components::Renderable>().ptr_item = &item;
+
+        return item;
+    }
+
+    static constexpr std::array<uint32_t, 3> indices {0, 1, 2};
+
+    inline static const std::array<pbrlib::backend::VertexAttribute, 3> triangle
+    {
+        pbrlib::backend::VertexAttribute {.pos = pbrlib::math::vec4(0.0f, 0.0f, 0.0f, 1.0f)},
+        pbrlib::backend::VertexAttribute {.pos = pbrlib::math::vec4(1.0f, 0.0f, 0.0f, 1.0f)},
+        pbrlib::backend::VertexAttribute {.pos = pbrlib::math::vec4(0.0f, 1.0f, 0.0f, 1.0f)}
+    };
+
+    pbrlib::Scene scene {"scene"};
+
+    std::optional<pbrlib::backend::vk::Device>  device;
+    std::optional<pbrlib::backend::MeshManager> mesh_manager;
+};
+
+TEST_F(MeshManagerTests, SharesDuplicateMeshes)
+{
+    mesh_manager->add("first", triangle, indices, &addItem("first"));
+    mesh_manager->add("second", triangle, indices, &addItem("second"));
+
+    pbrlib::testing::equality(mesh_manager->meshCount(), size_t(1));
+}
+
+TEST_F(MeshManagerTests, SeparatesMeshesOfEqualSize)
+{
+    auto moved_triangle = triangle;
+    moved_triangle[2].pos.z = 1.0f;
+
+    mesh_manager->add("first", triangle, indices, &addItem("first"));
+    mesh_manager->add("second", moved_triangle, indices, &addItem("second"));
+
+    pbrlib::testing::equality(mesh_manager->meshCount(), size_t(2));
+}
@@ -62,7 +62,7 @@ namespace pbrlib
                 .resizable(config.resible)
                 .build();
 
-            _ptr_canvas = std::make_unique<backend::Canvas>(*_ptr_device, &_window.value());
+            _ptr_canvas = std::make_unique<backend::Canvas>(*_ptr_device, &_window.value(), config.present);
         }
         else
             _ptr_canvas = std::make_unique<backend::Canvas>(*_ptr_device, width, height);
@@ -206,10 +206,13 @@ namespace pbrlib
 
             _ptr_scene->update(input_stay, _delta_time);
 
+            auto items = renderableItems();
+
+            _ptr_material_manager->requestMipLevels(_camera, items);
             _ptr_material_manager->update();
             _ptr_mesh_manager->update();
 
-            draw();
+            draw(items);
         } while (!is_close);
     }
 
@@ -237,7 +240,7 @@ namespace pbrlib
             input_stay.add(&event);
     }
 
-    void Engine::draw()
+    std::vector<const SceneItem*> Engine::renderableItems() const
     {
         PBRLIB_PROFILING_ZONE_SCOPED;
 
@@ -248,6 +251,13 @@ namespace pbrlib
         for (auto entity: view)
             items.push_back(view.get<backend::components::Renderable>(entity).ptr_item);
 
+        return items;
+    }
+
+    void Engine::draw(std::span<const SceneItem*> items)
+    {
+        PBRLIB_PROFILING_ZONE_SCOPED;
+
         if (_ptr_frame_graph) [[likely]]
             _ptr_frame_graph->draw(_camera, items);
     }
@@ -309,4 +319,12 @@ namespace pbrlib
         else
             backend::log::error("[engine] frame graph is not initialized, can't set present to display callback");
     }
+
+    std::span<const PassTiming> Engine::gpuTimings() const noexcept
+    {
+        if (_ptr_frame_graph) [[likely]]
+            return _ptr_frame_graph->gpuTimings();
+
+        return { };
+    }
 }